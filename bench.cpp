@@ -0,0 +1,188 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include "capture.h"
+
+using namespace std;
+
+// Kernel benchmark. Replays the argument sets recorded in one or more .cap files (see capture.h) and reports
+// the time per call of each kernel, over all recorded calls and per minute category. Each call runs on a fresh
+// copy of its arguments; the cost of that copy is measured separately and subtracted.
+//
+// Usage: bench [-t seconds] file.cap [file.cap ...]
+//   -t	minimum measuring time per kernel and category (default 0.5 s)
+
+static const char* kernelNames[CAP_KERNELS] = {
+	"MatSEqn", "sub_houseLeak", "sub_atticLeak", "sub_heat", "sub_moisture", "f_wallFlow3", "f_winDoorFlow", "f_CpTheta"
+};
+
+static const char* categoryNames[CAP_CATEGORIES] = {
+	"sample", "economizer", "AH cycling", "near-zero dP"
+};
+
+// Recorded calls of one kernel and the category each was recorded under
+template<class T> struct calls_struct {
+	vector<T> call;
+	vector<int> category;
+};
+
+volatile double benchSink;		// Keeps the copy-only loop from being optimised away
+
+static double f_seconds(chrono::steady_clock::time_point start) {
+	return chrono::duration_cast<chrono::duration<double> >(chrono::steady_clock::now() - start).count();
+}
+
+// Nanoseconds per call of the kernel over the calls in one category (category < 0 for all of them)
+template<class T> double f_nsPerCall(calls_struct<T>& calls, int category, double minSeconds, int& count) {
+	vector<T> subset;
+	for(size_t i = 0; i < calls.call.size(); i++) {
+		if(category < 0 || calls.category[i] == category)
+			subset.push_back(calls.call[i]);
+	}
+	count = int (subset.size());
+	if(count == 0)
+		return 0;
+
+	T work;
+	long long copies = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	double copySeconds;
+	do {
+		for(size_t i = 0; i < subset.size(); i++) {
+			work = subset[i];
+			benchSink = *((double*) &work);
+		}
+		copies = copies + count;
+	} while((copySeconds = f_seconds(start)) < minSeconds / 4);
+
+	long long runs = 0;
+	start = chrono::steady_clock::now();
+	double runSeconds;
+	do {
+		for(size_t i = 0; i < subset.size(); i++) {
+			work = subset[i];
+			work.call();
+			benchSink = *((double*) &work);
+		}
+		runs = runs + count;
+	} while((runSeconds = f_seconds(start)) < minSeconds);
+
+	double ns = (runSeconds / runs - copySeconds / copies) * 1e9;
+	return ns > 0 ? ns : 0;
+}
+
+template<class T> void f_report(int kernel, calls_struct<T>& calls, double minSeconds) {
+	int count;
+	double ns = f_nsPerCall(calls, -1, minSeconds, count);
+	if(count == 0)
+		return;
+
+	cout << kernelNames[kernel] << "\tall\t" << count << "\t" << ns << endl;
+	for(int c = 0; c < CAP_CATEGORIES; c++) {
+		ns = f_nsPerCall(calls, c, minSeconds, count);
+		if(count > 0)
+			cout << kernelNames[kernel] << "\t" << categoryNames[c] << "\t" << count << "\t" << ns << endl;
+	}
+}
+
+template<class T> void f_read(captureFile_struct& f, calls_struct<T>& calls, int category) {
+	T call;
+	call.io(f);
+	if(f.stream) {
+		calls.call.push_back(call);
+		calls.category.push_back(category);
+	}
+}
+
+int main(int argc, char* argv[]) {
+	double minSeconds = 0.5;
+	vector<string> files;
+
+	for(int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if(arg == "-t" && i + 1 < argc)
+			minSeconds = atof(argv[++i]);
+		else
+			files.push_back(arg);
+	}
+
+	if(files.empty()) {
+		cout << "Usage: bench [-t seconds] file.cap [file.cap ...]" << endl;
+		return 2;
+	}
+
+	calls_struct<matSEqnCall_struct> matSEqnCalls;
+	calls_struct<houseLeakCall_struct> houseLeakCalls;
+	calls_struct<atticLeakCall_struct> atticLeakCalls;
+	calls_struct<heatCall_struct> heatCalls;
+	calls_struct<moistureCall_struct> moistureCalls;
+	calls_struct<wallFlowCall_struct> wallFlowCalls;
+	calls_struct<winDoorFlowCall_struct> winDoorFlowCalls;
+	calls_struct<cpThetaCall_struct> cpThetaCalls;
+
+	for(size_t k = 0; k < files.size(); k++) {
+		captureFile_struct f;
+		if(f.open(files[k], 1) == 1) {
+			cout << "Cannot read: " << files[k] << endl;
+			return 1;
+		}
+
+		while(true) {
+			int kernel;
+			int category;
+			long int minute;
+			f.io(kernel);
+			f.io(category);
+			f.io(minute);
+			if(!f.stream)
+				break;
+
+			switch (kernel) {
+			case CAP_MATSEQN:
+				f_read(f, matSEqnCalls, category);
+				break;
+			case CAP_HOUSELEAK:
+				f_read(f, houseLeakCalls, category);
+				break;
+			case CAP_ATTICLEAK:
+				f_read(f, atticLeakCalls, category);
+				break;
+			case CAP_HEAT:
+				f_read(f, heatCalls, category);
+				break;
+			case CAP_MOISTURE:
+				f_read(f, moistureCalls, category);
+				break;
+			case CAP_WALLFLOW:
+				f_read(f, wallFlowCalls, category);
+				break;
+			case CAP_WINDOORFLOW:
+				f_read(f, winDoorFlowCalls, category);
+				break;
+			case CAP_CPTHETA:
+				f_read(f, cpThetaCalls, category);
+				break;
+			default:
+				cout << "Unknown kernel " << kernel << " in " << files[k] << endl;
+				return 1;
+			}
+		}
+		f.close();
+	}
+
+	cout << "Kernel\tCategory\tCalls\tns per call" << endl;
+	cout << fixed << setprecision(1);
+	f_report(CAP_MATSEQN, matSEqnCalls, minSeconds);
+	f_report(CAP_HOUSELEAK, houseLeakCalls, minSeconds);
+	f_report(CAP_ATTICLEAK, atticLeakCalls, minSeconds);
+	f_report(CAP_HEAT, heatCalls, minSeconds);
+	f_report(CAP_MOISTURE, moistureCalls, minSeconds);
+	f_report(CAP_WALLFLOW, wallFlowCalls, minSeconds);
+	f_report(CAP_WINDOORFLOW, winDoorFlowCalls, minSeconds);
+	f_report(CAP_CPTHETA, cpThetaCalls, minSeconds);
+
+	return 0;
+}
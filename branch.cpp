@@ -0,0 +1,36 @@
+#include "branch.h"
+
+using namespace std;
+
+static double f_energy(simulation_struct* sim) {
+	return sim->AH_kWh + sim->furnace_kWh + sim->compressor_kWh + sim->mechVent_kWh;
+}
+
+branchResult_struct f_runBranch(simulation_struct* branch, vector<weatherSample_struct>& weather) {
+	branchResult_struct result;
+	double startEnergy = f_energy(branch);
+	long int startRivec = branch->rivecMinutes;
+
+	result.minutes = 0;
+	for(size_t i = 0; i < weather.size(); i++) {
+		result.minutes++;
+		if(!branch->step(weather[i]))
+			break;
+	}
+
+	result.relExp = branch->relExp;
+	result.relDose = branch->relDose;
+	result.RHhouse = branch->RHhouse;
+	result.tempHouse = branch->tempHouse;
+	result.energy_kWh = f_energy(branch) - startEnergy;
+	result.rivecMinutes = branch->rivecMinutes - startRivec;
+	return result;
+}
+
+branchResult_struct f_whatIf(simulation_struct* sim, vector<weatherSample_struct>& weather, int rivecDecision) {
+	simulation_struct* branch = sim->f_branch();
+	branch->rivecOverride = rivecDecision;
+	branchResult_struct result = f_runBranch(branch, weather);
+	delete branch;
+	return result;
+}
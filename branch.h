@@ -0,0 +1,40 @@
+#pragma once
+#ifndef branch_h
+#define branch_h
+
+#include <vector>
+#include "simulation.h"
+#include "weather.h"
+
+using namespace std;
+
+// What-if branches of a running simulation, for lookahead and model-predictive controllers. A branch is a copy of
+// the simulation at the current minute (simulation_struct::f_branch) that is stepped on its own over the coming
+// weather and then deleted; the simulation it came from is not touched. Before the branch is stepped its controls
+// can be changed directly, e.g. rivecOverride to force the RIVEC fan on or off, HumContType to try another
+// humidity control. Copies share the shelter table; the rest of the state is about 25 kB.
+//
+//	vector<weatherSample_struct> ahead;
+//	f_peekWeather(weatherFile, 1440, ahead);				// The next 24 hours
+//	branchResult_struct on = f_whatIf(house, ahead, 1);
+//	branchResult_struct off = f_whatIf(house, ahead, 0);
+
+// Where a branch ended up and what it used on the way
+struct branchResult_struct {
+	long int minutes;			// Minutes stepped
+	double relExp;				// Relative exposure at the end
+	double relDose;				// Relative dose at the end
+	double RHhouse;				// House relative humidity at the end [%]
+	double tempHouse;			// House air temperature at the end [K]
+	double energy_kWh;			// Air handler, furnace, compressor and ventilation fan energy used [kWh]
+	long int rivecMinutes;		// Minutes the RIVEC fans ran
+};
+
+// Steps the branch over the weather (stopping early if the simulation ends). The branch is not deleted.
+branchResult_struct f_runBranch(simulation_struct* branch, vector<weatherSample_struct>& weather);
+
+// Branches sim with the RIVEC decision forced (0 = off, 1 = on, -1 = left to the controller), runs the branch over
+// the weather and deletes it
+branchResult_struct f_whatIf(simulation_struct* sim, vector<weatherSample_struct>& weather, int rivecDecision);
+
+#endif
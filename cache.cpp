@@ -0,0 +1,242 @@
+#include "cache.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace std;
+
+// The running program, whose contents stand for the engine in the keys
+static string f_programFile_name() {
+#ifdef _WIN32
+	char name[MAX_PATH];
+	DWORD size = GetModuleFileNameA(NULL, name, MAX_PATH);
+	return size > 0 && size < MAX_PATH ? string(name, size) : "";
+#else
+	return "/proc/self/exe";
+#endif
+}
+
+// Copies a file byte for byte. Returns 1 if either file cannot be opened or the copy is incomplete.
+static int f_copyFile(string from, string to) {
+	ifstream fromFile(from, ios::binary);
+	if(!fromFile)
+		return 1;
+	ofstream toFile(to, ios::binary);
+	if(!toFile)
+		return 1;
+
+	toFile << fromFile.rdbuf();
+	toFile.close();
+	return toFile.fail() ? 1 : 0;
+}
+
+// Copies a .cnv report, giving it the title of the simulation it is fetched for (the first line names it)
+static int f_copyReport(string from, string to, string& title) {
+	ifstream fromFile(from, ios::binary);
+	if(!fromFile)
+		return 1;
+	ofstream toFile(to, ios::binary);
+	if(!toFile)
+		return 1;
+
+	string line;
+	getline(fromFile, line);
+	size_t tab = line.find('\t');
+	size_t end = line.find_last_not_of('\r');
+	toFile << line.substr(0, tab + 1) << title << line.substr(end + 1) << "\n";
+	if(fromFile.peek() != EOF)
+		toFile << fromFile.rdbuf();
+	toFile.close();
+	return fromFile.bad() || toFile.fail() ? 1 : 0;
+}
+
+static int f_exists(string fileName) {
+	ifstream file(fileName, ios::binary);
+	return file ? 1 : 0;
+}
+
+void hash_struct::init() {
+	value = 14695981039346656037ULL;
+}
+
+void hash_struct::add(const char* data, size_t bytes) {
+	for(size_t i = 0; i < bytes; i++) {
+		value = value ^ (unsigned char) data[i];
+		value = value * 1099511628211ULL;
+	}
+}
+
+// Strings are added with their length so that "ab" + "c" and "a" + "bc" differ
+void hash_struct::add(string text) {
+	unsigned long long size = text.size();
+	add((const char*) &size, sizeof(size));
+	add(text.data(), text.size());
+}
+
+void hash_struct::add(double x) {
+	add((const char*) &x, sizeof(x));
+}
+
+// Adds the contents of a file, or a marker if there is no such file. Returns 1 if there is no such file.
+int hash_struct::addFile(string fileName) {
+	ifstream file(fileName, ios::binary);
+	if(!file) {
+		add(string("missing file"));
+		return 1;
+	}
+
+	vector<char> buffer(1 << 16);
+	while(file) {
+		file.read(&buffer[0], buffer.size());
+		add(&buffer[0], (size_t) file.gcount());
+	}
+	add(string("end of file"));
+	return 0;
+}
+
+string hash_struct::text() {
+	ostringstream hex;
+	hex << std::hex << setfill('0') << setw(16) << value;
+	return hex.str();
+}
+
+// Returns 1 if the program file cannot be read
+int resultCache_struct::init(string cachePath, batch_struct& batch) {
+	this->cachePath = cachePath;
+	outPath = batch.outPath;
+	inPath = batch.inPath;
+	weatherPath = batch.weatherPath;
+	weatherTransforms = batch.weatherTransforms;
+	scheduleSeed = batch.scheduleSeed;
+
+	hash_struct hash;
+	hash.init();
+	string programFile_name = f_programFile_name();
+	if(hash.addFile(programFile_name)) {
+		cout << "Cannot open: " << programFile_name << endl;
+		return 1;
+	}
+	hash.add((double) batch.totaldays);
+	hash.add((double) batch.startDay);
+	hash.add((double) batch.spinupDays);
+	hash.add((double) batch.convergenceFlag);
+	hash.add((double) batch.convergenceWorst);
+	hash.add((double) batch.minuteOutputFlag);
+	hash.add((double) batch.compressionLevel);
+	hash.addFile(batch.shelterFile_name);
+	hash.addFile(batch.fanSchedulefile_name1);			// Only read by buildings with dynamic schedules, but cheap
+	hash.addFile(batch.fanSchedulefile_name2);
+	hash.addFile(batch.fanSchedulefile_name3);
+	hash.add((const char*) &batch.scheduleSeed, sizeof(batch.scheduleSeed));
+
+	for(size_t i = 0; i < batch.statistics.size(); i++) {
+		hash.add((double) batch.statistics[i].kind);
+		hash.add((double) batch.statistics[i].variable);
+		for(size_t j = 0; j < batch.statistics[i].parameters.size(); j++)
+			hash.add(batch.statistics[i].parameters[j]);
+		hash.add(string("end of statistic"));
+	}
+	for(size_t i = 0; i < batch.outputs.size(); i++) {
+		hash.add(batch.outputs[i].extension);
+		hash.add((double) batch.outputs[i].period);
+		for(size_t j = 0; j < batch.outputs[i].variables.size(); j++) {
+			hash.add((double) batch.outputs[i].variables[j]);
+			hash.add((double) batch.outputs[i].aggregation[j]);
+			hash.add(batch.outputs[i].header[j]);
+		}
+		hash.add(string("end of output"));
+	}
+	batchKey = hash.text();
+
+	string gz = batch.compressionLevel > 0 ? ".gz" : "";
+	extensions.clear();
+	extensions.push_back(".rc2");
+	if(batch.minuteOutputFlag == 1) {
+		extensions.push_back(".rco" + gz);
+		extensions.push_back(".hum" + gz);
+		extensions.push_back(".fil" + gz);
+	}
+	if(batch.convergenceFlag == 1)
+		extensions.push_back(".cnv");
+	if(!batch.statistics.empty())
+		extensions.push_back(".rcs");
+	for(size_t i = 0; i < batch.outputs.size(); i++)
+		extensions.push_back("." + batch.outputs[i].extension + gz);
+
+	weatherKeys.clear();
+	return 0;
+}
+
+// Returns "" if the building file cannot be read, so that the simulation runs and reports it
+string resultCache_struct::f_key(string& input_file, string& weather_file, string& output_file) {
+	if(weatherKeys.find(weather_file) == weatherKeys.end()) {
+		hash_struct weatherHash;
+		weatherHash.init();
+		weatherHash.addFile(f_weatherFile_name(weatherPath, weather_file));
+		for(size_t i = 0; i < weatherTransforms.size(); i++) {
+			weatherTransform_struct& transform = weatherTransforms[i];
+			if(transform.name != f_transformName(weather_file))
+				continue;
+			for(int m = 0; m < 12; m++) {
+				weatherHash.add(transform.shift[m]);
+				weatherHash.add(transform.stretch[m]);
+			}
+			weatherHash.add(transform.humidity);
+			weatherHash.add(transform.wind);
+			weatherHash.add(transform.solar);
+		}
+		weatherKeys[weather_file] = weatherHash.text();
+	}
+
+	hash_struct hash;
+	hash.init();
+	hash.add(batchKey);
+	hash.add(weatherKeys[weather_file]);
+	if(scheduleSeed != 0) {
+		unsigned long long seed = f_scheduleSeed(scheduleSeed, output_file);
+		hash.add((const char*) &seed, sizeof(seed));
+	}
+	if(hash.addFile(inPath + input_file + ".csv"))
+		return "";
+	return hash.text();
+}
+
+// Copies the stored files for key to the output folder. Returns 1 on a hit, 0 if the simulation has to run.
+int resultCache_struct::fetch(string key, string& output_file) {
+	if(key.empty() || !f_exists(cachePath + key + ".ok"))
+		return 0;
+
+	for(size_t i = 0; i < extensions.size(); i++) {
+		int error = extensions[i] == ".cnv" ? f_copyReport(cachePath + key + ".cnv", outPath + output_file + ".cnv", output_file)
+			: f_copyFile(cachePath + key + extensions[i], outPath + output_file + extensions[i]);
+		if(error)
+			return 0;
+	}
+	return 1;
+}
+
+// Stores a finished simulation's files. The .ok marker is written last, so a store cut short is never a hit.
+// Returns 1 if the cache folder cannot be written.
+int resultCache_struct::store(string key, string& output_file) {
+	if(key.empty())
+		return 0;
+
+	for(size_t i = 0; i < extensions.size(); i++) {
+		if(f_copyFile(outPath + output_file + extensions[i], cachePath + key + extensions[i])) {
+			cout << "Cannot store in the result cache: " << cachePath + key + extensions[i] << endl;
+			return 1;
+		}
+	}
+
+	ofstream okFile(cachePath + key + ".ok");
+	if(!okFile) {
+		cout << "Cannot open: " << cachePath + key + ".ok" << endl;
+		return 1;
+	}
+	okFile << output_file << endl;
+	return 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#ifndef cache_h
+#define cache_h
+
+#include <map>
+#include <string>
+#include <vector>
+#include "simulation.h"
+
+using namespace std;
+
+// Result cache for batch runs. Each simulation gets a key hashed from everything that decides its results: the
+// building .csv, the weather file and its transform, the fan schedule and shelter files, the batch settings (days, output
+// files, statistics and output specs, compression) and the engine. A simulation whose key is in the cache folder has
+// its stored files copied to the output folder instead of being run; every other simulation is run and its files
+// stored under its key.
+//
+// The engine is the program file itself, hashed when the cache is opened, so any rebuild (including a change to
+// the thermostat, occupancy and other settings compiled into simulation.cpp) starts a fresh set of keys. The
+// output name is not part of the key: identical simulations under different names share one entry, and the name
+// in a fetched .cnv report is rewritten. It only counts through the seed of a generated fan schedule.
+
+// 64-bit FNV-1a hash
+struct hash_struct {
+	void init();
+	void add(const char* data, size_t bytes);
+	void add(string text);
+	void add(double x);
+	int addFile(string fileName);
+	string text();
+
+	unsigned long long value;
+};
+
+struct resultCache_struct {
+	int init(string cachePath, batch_struct& batch);
+	string f_key(string& input_file, string& weather_file, string& output_file);
+	int fetch(string key, string& output_file);
+	int store(string key, string& output_file);
+
+	string cachePath;
+	string outPath;
+	string inPath;
+	string weatherPath;
+	string batchKey;					// Hash of the engine and the settings and files shared by the whole batch
+	unsigned long long scheduleSeed;
+	vector<string> extensions;			// Files each simulation writes
+	map<string, string> weatherKeys;	// Weather files are large and shared, so each is hashed once
+	vector<weatherTransform_struct> weatherTransforms;
+};
+
+#endif
@@ -0,0 +1,654 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include "driver.h"
+#include "output.h"
+#include "simulation.h"
+#include "weather.h"
+
+using namespace std;
+
+// Calibration of a building's envelope and duct inputs against measurements. The inputs in calibration_struct
+// (simulation.h) are fitted with CMA-ES, a derivative-free search that tries a population of candidates at a time;
+// the candidates of a generation are simulated in memory on all cores. The measurements come from a text file
+// with a header line naming its columns:
+//
+//	minute	tempHouse	RH%house	AHruntime
+//	60		293.4		48.1		0.35
+//	120		293.9		47.6		NA
+//
+// Minute counts from the first minute of the year (1). A column is an output variable of the .rco or .hum file in
+// its units (tempHouse in K), or AHruntime, the fraction of the minutes the air handler ran. Each row is compared
+// with the mean of the model over the minutes since the previous row, so readings can be logged at any interval.
+// NA or -9999 marks a missing reading. Every candidate is simulated from the first minute of the year up to the
+// last row; the months before the first row settle the house temperature and moisture.
+//
+// The fit minimises the mean over the columns of the RMS residual divided by the column's standard deviation, so
+// that temperature, humidity and runtime weigh alike. The best candidate's inputs, the RMS residual and bias of
+// each column, and (with -residuals) the residual of every row are reported.
+//
+// Usage: calibrate [-fit inputs] [-threads n] [-evaluations n] [-seed n] [-shelter file] [-schedules prefix] [-schednum letter] [-residuals file] building.csv weather.ws3 measured.txt
+//   -fit			inputs to fit, comma separated (default C,n,UAh,UAc,supLF,retLF,mass). name:low:high searches
+//				from low to high instead of the calibrateInputs range, in its units (C:0.5:2 is half to twice the
+//				building's C); names alone keep the default range
+//   -threads		simulations run at once (default one per core)
+//   -evaluations	simulations to stop after (default 600)
+//   -schedules	dynamic fan schedule files up to the 1, 2 or 3 (default C:\RC++\schedules\sched), -schednum their suffix (s)
+
+const double MISSING = -9999;
+const int AH_RUNTIME = -2;				// Column variable for AHruntime
+const double SIGMA_START = 0.3;			// Initial CMA-ES step size, in the unit range of the inputs
+const double SIGMA_STOP = 1e-4;
+
+enum calibrateInput_enum {
+	CAL_C,
+	CAL_N,
+	CAL_UAH,
+	CAL_UAC,
+	CAL_SUPLF,
+	CAL_RETLF,
+	CAL_MASS,
+	CAL_INPUTS
+};
+
+// Range searched for each input. Relative ranges are multiples of the building's value. Log-scaled inputs are
+// searched on their logarithm, so that halving and doubling are the same step. These are the defaults; -fit can
+// give each input its own low and high.
+struct calibrateInput_struct {
+	const char* name;
+	int relative;
+	int logScale;
+	double low;
+	double high;
+};
+
+static const calibrateInput_struct calibrateInputs[CAL_INPUTS] = {
+	{ "C",		1, 1, 0.25, 4 },		// Envelope leakage coefficient
+	{ "n",		0, 0, 0.5, 1 },			// Envelope pressure exponent
+	{ "UAh",	1, 1, 0.25, 4 },		// Heating U-value
+	{ "UAc",	1, 1, 0.25, 4 },		// Cooling U-value
+	{ "supLF",	0, 0, 0.001, 0.5 },		// Supply duct leakage fraction
+	{ "retLF",	0, 0, 0.001, 0.5 },		// Return duct leakage fraction
+	{ "mass",	0, 1, 0.25, 4 }			// Internal mass factor
+};
+
+struct measured_struct {
+	vector<string> columns;
+	vector<int> variables;			// Output variable of each column, or AH_RUNTIME
+	vector<long> minutes;
+	vector<double> values;			// Row by row, one per column
+	vector<double> scale;			// Standard deviation of each column
+};
+
+// Everything a candidate needs to be simulated; shared read-only by the worker threads
+struct calibrateSetup_struct {
+	string building;
+	batch_struct batch;
+	shared_ptr<shelterTable_struct> shelter;
+	vector<weatherSample_struct> weather;
+	double latitude;
+	double altitude;
+	measured_struct measured;
+	vector<int> inputs;				// Inputs being fitted
+	calibrateInput_struct range[CAL_INPUTS];	// Range searched for each input (calibrateInputs unless -fit gives one)
+	double base[CAL_INPUTS];		// The building's values
+};
+
+// Returns 1 if the file cannot be opened and 2 if it has no usable rows or an unknown column
+static int f_readMeasured(string measuredFile_name, measured_struct& measured) {
+	ifstream measuredFile(measuredFile_name);
+	if(!measuredFile) {
+		cout << "Cannot open: " << measuredFile_name << endl;
+		return 1;
+	}
+
+	string line, column;
+	getline(measuredFile, line);
+	istringstream header(line);
+	header >> column;						// minute
+	while(header >> column) {
+		int variable = column == "AHruntime" ? AH_RUNTIME : f_outputVariable(column);
+		if(variable == -1) {
+			cout << "Unknown column in " << measuredFile_name << ": " << column << endl;
+			return 2;
+		}
+		measured.columns.push_back(column);
+		measured.variables.push_back(variable);
+	}
+
+	while(getline(measuredFile, line)) {
+		istringstream fields(line);
+		long minute;
+		if(!(fields >> minute))
+			continue;
+		if(!measured.minutes.empty() && minute <= measured.minutes.back()) {
+			cout << "Minutes out of order in " << measuredFile_name << ": " << line << endl;
+			return 2;
+		}
+		measured.minutes.push_back(minute);
+		for(size_t c = 0; c < measured.columns.size(); c++) {
+			string value = "NA";
+			fields >> value;
+			measured.values.push_back(value == "NA" ? MISSING : atof(value.c_str()));
+		}
+	}
+	if(measured.columns.empty() || measured.minutes.empty() || measured.minutes[0] < 1) {
+		cout << "No measurements in " << measuredFile_name << endl;
+		return 2;
+	}
+
+	size_t numColumns = measured.columns.size();
+	for(size_t c = 0; c < numColumns; c++) {
+		double sum = 0, sumSquares = 0;
+		long count = 0;
+		for(size_t r = 0; r < measured.minutes.size(); r++) {
+			double value = measured.values[r * numColumns + c];
+			if(value != MISSING) {
+				sum = sum + value;
+				sumSquares = sumSquares + value * value;
+				count++;
+			}
+		}
+		double variance = count > 1 ? (sumSquares - sum * sum / count) / (count - 1) : 0;
+		measured.scale.push_back(variance > 1e-12 ? sqrt(variance) : 1);
+	}
+	return 0;
+}
+
+// Input value for a position in the unit range
+static double f_inputValue(calibrateSetup_struct& setup, int input, double x) {
+	const calibrateInput_struct& range = setup.range[input];
+	double low = range.relative ? range.low * setup.base[input] : range.low;
+	double high = range.relative ? range.high * setup.base[input] : range.high;
+	x = x < 0 ? 0 : (x > 1 ? 1 : x);
+	return range.logScale ? low * pow(high / low, x) : low + (high - low) * x;
+}
+
+// Position of an input value in the unit range (clipped to it)
+static double f_inputPosition(calibrateSetup_struct& setup, int input, double value) {
+	const calibrateInput_struct& range = setup.range[input];
+	double low = range.relative ? range.low * setup.base[input] : range.low;
+	double high = range.relative ? range.high * setup.base[input] : range.high;
+	double x = range.logScale ? log(value / low) / log(high / low) : (value - low) / (high - low);
+	return x < 0 ? 0 : (x > 1 ? 1 : x);
+}
+
+static void sub_setInput(calibration_struct& calibration, int input, double value) {
+	switch (input) {
+	case CAL_C:
+		calibration.C = value;
+		break;
+	case CAL_N:
+		calibration.n = value;
+		break;
+	case CAL_UAH:
+		calibration.UAh = value;
+		break;
+	case CAL_UAC:
+		calibration.UAc = value;
+		break;
+	case CAL_SUPLF:
+		calibration.supLF = value;
+		break;
+	case CAL_RETLF:
+		calibration.retLF = value;
+		break;
+	case CAL_MASS:
+		calibration.massFactor = value;
+		break;
+	}
+}
+
+// Simulates the candidate at x (unit range, one per fitted input) up to the last measured minute and fills
+// modelled with the model's value for every measurement. Returns 1 if the simulation cannot be set up.
+static int f_simulate(calibrateSetup_struct& setup, vector<double>& x, vector<double>& modelled) {
+	measured_struct& measured = setup.measured;
+	size_t numColumns = measured.columns.size();
+	batch_struct batch = setup.batch;
+	string input_file = "building";
+	string weather_file = "weather";
+	string output_file = "calibrate";
+
+	simulation_struct* sim = new simulation_struct();
+	sim->buildingText = setup.building;
+	sim->shelter = setup.shelter;
+	sim->outputVariablesFlag = 1;
+	for(size_t i = 0; i < setup.inputs.size(); i++)
+		sub_setInput(sim->calibration, setup.inputs[i], f_inputValue(setup, setup.inputs[i], x[i]));
+	if(sim->init(batch, input_file, weather_file, output_file, setup.latitude, setup.altitude)) {
+		delete sim;
+		return 1;
+	}
+
+	vector<double> sums(numColumns, 0);
+	long count = 0;
+	size_t row = 0;
+	modelled.assign(measured.values.size(), MISSING);
+	for(long minute = 1; row < measured.minutes.size() && minute <= (long) setup.weather.size(); minute++) {
+		int more = sim->step(setup.weather[minute - 1]);
+		for(size_t c = 0; c < numColumns; c++) {
+			if(measured.variables[c] == AH_RUNTIME)
+				sums[c] = sums[c] + (sim->AHflag != 0 ? 1 : 0);
+			else
+				sums[c] = sums[c] + sim->output[measured.variables[c]];
+		}
+		count++;
+
+		if(minute == measured.minutes[row]) {
+			for(size_t c = 0; c < numColumns; c++) {
+				modelled[row * numColumns + c] = sums[c] / count;
+				sums[c] = 0;
+			}
+			count = 0;
+			row++;
+		}
+		if(!more)
+			break;
+	}
+	delete sim;
+	return 0;
+}
+
+// Mean over the columns of the RMS residual divided by the column's standard deviation
+static double f_cost(measured_struct& measured, vector<double>& modelled) {
+	size_t numColumns = measured.columns.size();
+	double cost = 0;
+	for(size_t c = 0; c < numColumns; c++) {
+		double sumSquares = 0;
+		long count = 0;
+		for(size_t r = 0; r < measured.minutes.size(); r++) {
+			double value = measured.values[r * numColumns + c];
+			double model = modelled[r * numColumns + c];
+			if(value != MISSING && model != MISSING) {
+				sumSquares = sumSquares + (model - value) * (model - value);
+				count++;
+			}
+		}
+		cost = cost + (count > 0 ? sqrt(sumSquares / count) / measured.scale[c] : 1e6);
+	}
+	return cost / numColumns;
+}
+
+// Eigen-decomposition of a symmetric matrix by Jacobi rotations: on return a holds the eigenvalues on its
+// diagonal and the columns of v are the eigenvectors
+static void sub_eigen(vector<vector<double> >& a, vector<vector<double> >& v) {
+	size_t n = a.size();
+	v.assign(n, vector<double>(n, 0));
+	for(size_t i = 0; i < n; i++)
+		v[i][i] = 1;
+
+	for(int sweep = 0; sweep < 50; sweep++) {
+		double off = 0;
+		for(size_t p = 0; p < n; p++) {
+			for(size_t q = p + 1; q < n; q++)
+				off = off + a[p][q] * a[p][q];
+		}
+		if(off < 1e-30)
+			return;
+
+		for(size_t p = 0; p < n; p++) {
+			for(size_t q = p + 1; q < n; q++) {
+				if(fabs(a[p][q]) < 1e-300)
+					continue;
+				double theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+				double t = (theta >= 0 ? 1 : -1) / (fabs(theta) + sqrt(theta * theta + 1));
+				double c = 1 / sqrt(t * t + 1);
+				double s = t * c;
+				for(size_t k = 0; k < n; k++) {
+					double akp = a[k][p];
+					double akq = a[k][q];
+					a[k][p] = c * akp - s * akq;
+					a[k][q] = s * akp + c * akq;
+				}
+				for(size_t k = 0; k < n; k++) {
+					double apk = a[p][k];
+					double aqk = a[q][k];
+					a[p][k] = c * apk - s * aqk;
+					a[q][k] = s * apk + c * aqk;
+				}
+				for(size_t k = 0; k < n; k++) {
+					double vkp = v[k][p];
+					double vkq = v[k][q];
+					v[k][p] = c * vkp - s * vkq;
+					v[k][q] = s * vkp + c * vkq;
+				}
+			}
+		}
+	}
+}
+
+// Simulates every candidate of a generation, numThreads at a time. Candidates outside the unit range are
+// simulated at the nearest point inside it and charged for the distance, which keeps the search in range.
+static void sub_evaluate(calibrateSetup_struct& setup, vector<vector<double> >& candidates, vector<double>& costs, int numThreads) {
+	costs.assign(candidates.size(), 0);
+	f_runParallel(numThreads, candidates.size(), [&](size_t i) -> int {
+		vector<double> modelled;
+		double penalty = 0;
+		for(size_t k = 0; k < candidates[i].size(); k++) {
+			double x = candidates[i][k];
+			double outside = x < 0 ? -x : (x > 1 ? x - 1 : 0);
+			penalty = penalty + outside * outside;
+		}
+		costs[i] = f_simulate(setup, candidates[i], modelled) ? 1e9 : f_cost(setup.measured, modelled) + penalty;
+		return 0;
+	});
+}
+
+int main(int argc, char* argv[])
+{
+	// The candidates are simulated in memory, so only the shelter and schedule files are read from the defaults' folders
+	driverSettings_struct settings;
+	sub_defaultSettings(settings);
+	settings.inPath = "";
+	settings.outPath = "";
+	settings.weatherPath = "";
+	settings.SCHEDNUM = "s";
+	string schedulePrefix = settings.schedulePath + "sched";		// Dynamic fan schedule files, followed by 1, 2 or 3 and SCHEDNUM
+	string fit = "C,n,UAh,UAc,supLF,retLF,mass";
+	string residualsFile_name;
+	int numThreads = settings.numThreads;
+	int maxEvaluations = 600;
+	unsigned int seed = 1;
+	vector<string> files;
+
+	for(int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if(arg == "-fit" && i + 1 < argc)
+			fit = argv[++i];
+		else if(arg == "-threads" && i + 1 < argc)
+			numThreads = atoi(argv[++i]);
+		else if(arg == "-evaluations" && i + 1 < argc)
+			maxEvaluations = atoi(argv[++i]);
+		else if(arg == "-seed" && i + 1 < argc)
+			seed = (unsigned int) atoi(argv[++i]);
+		else if(arg == "-shelter" && i + 1 < argc)
+			settings.shelterFile_name = argv[++i];
+		else if(arg == "-schedules" && i + 1 < argc)
+			schedulePrefix = argv[++i];
+		else if(arg == "-schednum" && i + 1 < argc)
+			settings.SCHEDNUM = argv[++i];
+		else if(arg == "-residuals" && i + 1 < argc)
+			residualsFile_name = argv[++i];
+		else
+			files.push_back(arg);
+	}
+	if(numThreads < 1)
+		numThreads = 1;
+
+	calibrateSetup_struct setup;
+	for(int i = 0; i < CAL_INPUTS; i++)
+		setup.range[i] = calibrateInputs[i];
+
+	// Each entry is name or name:low:high
+	string entry;
+	istringstream fitEntries(fit);
+	while(getline(fitEntries, entry, ',')) {
+		string name, low, high, rest;
+		istringstream fields(entry);
+		getline(fields, name, ':');
+		int bounded = (bool) getline(fields, low, ':');
+		if(bounded && (!getline(fields, high, ':') || getline(fields, rest) || low.empty() || high.empty())) {
+			files.clear();
+			break;
+		}
+
+		int input = -1;
+		for(int i = 0; i < CAL_INPUTS; i++) {
+			if(name == calibrateInputs[i].name)
+				input = i;
+		}
+		if(input < 0) {
+			files.clear();
+			break;
+		}
+
+		if(bounded) {
+			calibrateInput_struct& range = setup.range[input];
+			range.low = atof(low.c_str());
+			range.high = atof(high.c_str());
+			if(range.low >= range.high || (range.logScale && range.low <= 0)) {
+				cout << "Bad range for " << name << ": low must be below high" << (range.logScale ? " and above 0" : "") << endl;
+				return 2;
+			}
+		}
+		setup.inputs.push_back(input);
+	}
+
+	if(files.size() != 3 || setup.inputs.empty()) {
+		cout << "Usage: calibrate [-fit inputs] [-threads n] [-evaluations n] [-seed n] [-shelter file] [-schedules prefix] [-schednum letter] [-residuals file] building.csv weather.ws3 measured.txt" << endl;
+		return 2;
+	}
+
+	// [START] Inputs ===================================================================================================
+	ifstream buildingFile(files[0]);
+	if(!buildingFile) {
+		cout << "Cannot open: " << files[0] << endl;
+		return 1;
+	}
+	ostringstream building;
+	building << buildingFile.rdbuf();
+	buildingFile.close();
+	setup.building = building.str();
+
+	weatherFile_struct weatherFile;
+	if(sub_openWeather(weatherFile, files[1], setup.latitude, setup.altitude)) {
+		cout << "Cannot open: " << files[1] << endl;
+		return 1;
+	}
+	weatherSample_struct sample;
+	while(f_readWeather(weatherFile, sample))
+		setup.weather.push_back(sample);
+	weatherFile.close();
+
+	if(f_readMeasured(files[2], setup.measured))
+		return 1;
+	measured_struct& measured = setup.measured;
+	size_t numColumns = measured.columns.size();
+
+	settings.totaldays = (int) ((measured.minutes.back() + 1439) / 1440);
+	sub_driverBatch(settings, setup.batch);
+	setup.batch.fanSchedulefile_name1 = schedulePrefix + "1" + settings.SCHEDNUM;
+	setup.batch.fanSchedulefile_name2 = schedulePrefix + "2" + settings.SCHEDNUM;
+	setup.batch.fanSchedulefile_name3 = schedulePrefix + "3" + settings.SCHEDNUM;
+
+	// The building as given, for its input values and to read the shelter table once for every candidate
+	string input_file = files[0];
+	string weather_file = files[1];
+	string output_file = "calibrate";
+	simulation_struct* house = new simulation_struct();
+	house->buildingText = setup.building;
+	if(house->init(setup.batch, input_file, weather_file, output_file, setup.latitude, setup.altitude)) {
+		delete house;
+		return 1;
+	}
+	setup.shelter = house->shelter;
+	setup.base[CAL_C] = house->C;
+	setup.base[CAL_N] = house->n;
+	setup.base[CAL_UAH] = house->UAh;
+	setup.base[CAL_UAC] = house->UAc;
+	setup.base[CAL_SUPLF] = house->supLF0;
+	setup.base[CAL_RETLF] = house->retLF0;
+	setup.base[CAL_MASS] = 1;
+	delete house;
+	// [END] Inputs =====================================================================================================
+
+	// [START] CMA-ES ===================================================================================================
+	int N = (int) setup.inputs.size();
+	int lambda = 4 + (int) (3 * log((double) N));
+	if(lambda < numThreads)
+		lambda = numThreads;						// A bigger population costs nothing while cores are idle
+	int mu = lambda / 2;
+
+	vector<double> weights(mu);
+	double sumWeights = 0, sumSquaredWeights = 0;
+	for(int i = 0; i < mu; i++) {
+		weights[i] = log(mu + 0.5) - log(i + 1.0);
+		sumWeights = sumWeights + weights[i];
+	}
+	for(int i = 0; i < mu; i++) {
+		weights[i] = weights[i] / sumWeights;
+		sumSquaredWeights = sumSquaredWeights + weights[i] * weights[i];
+	}
+	double mueff = 1 / sumSquaredWeights;
+	double cc = (4 + mueff / N) / (N + 4 + 2 * mueff / N);
+	double cs = (mueff + 2) / (N + mueff + 5);
+	double c1 = 2 / ((N + 1.3) * (N + 1.3) + mueff);
+	double cmu = min(1 - c1, 2 * (mueff - 2 + 1 / mueff) / ((N + 2) * (N + 2) + mueff));
+	double damps = 1 + 2 * max(0.0, sqrt((mueff - 1) / (N + 1)) - 1) + cs;
+	double chiN = sqrt((double) N) * (1 - 1.0 / (4 * N) + 1.0 / (21 * N * N));
+
+	vector<double> mean(N), pc(N, 0), ps(N, 0);
+	vector<vector<double> > covariance(N, vector<double>(N, 0)), B, D;
+	for(int k = 0; k < N; k++) {
+		mean[k] = f_inputPosition(setup, setup.inputs[k], setup.base[setup.inputs[k]]);
+		covariance[k][k] = 1;
+	}
+	double sigma = SIGMA_START;
+
+	mt19937 random(seed);
+	normal_distribution<double> normal(0, 1);
+	vector<vector<double> > candidates(lambda, vector<double>(N)), steps(lambda, vector<double>(N));
+	vector<double> costs, best(mean), modelled;
+	double bestCost = 0;
+	int evaluations = 0;
+
+	// The building's own inputs, for comparison
+	vector<vector<double> > start(1, mean);
+	sub_evaluate(setup, start, costs, 1);
+	bestCost = costs[0];
+	evaluations++;
+	cout << "Building inputs: cost " << bestCost << endl;
+
+	for(int generation = 0; evaluations + lambda <= maxEvaluations && sigma > SIGMA_STOP; generation++) {
+		D = covariance;
+		sub_eigen(D, B);
+		vector<double> scale(N);
+		for(int k = 0; k < N; k++)
+			scale[k] = sqrt(max(D[k][k], 1e-20));
+
+		for(int i = 0; i < lambda; i++) {
+			vector<double> z(N);
+			for(int k = 0; k < N; k++)
+				z[k] = normal(random) * scale[k];
+			for(int k = 0; k < N; k++) {
+				steps[i][k] = 0;
+				for(int j = 0; j < N; j++)
+					steps[i][k] = steps[i][k] + B[k][j] * z[j];
+				candidates[i][k] = mean[k] + sigma * steps[i][k];
+			}
+		}
+		sub_evaluate(setup, candidates, costs, numThreads);
+		evaluations = evaluations + lambda;
+
+		vector<int> order(lambda);
+		for(int i = 0; i < lambda; i++)
+			order[i] = i;
+		sort(order.begin(), order.end(), [&](int a, int b) { return costs[a] < costs[b]; });
+		if(costs[order[0]] < bestCost) {
+			bestCost = costs[order[0]];
+			best = candidates[order[0]];
+		}
+
+		// Recombination and the evolution paths
+		vector<double> meanStep(N, 0);
+		for(int i = 0; i < mu; i++) {
+			for(int k = 0; k < N; k++)
+				meanStep[k] = meanStep[k] + weights[i] * steps[order[i]][k];
+		}
+		for(int k = 0; k < N; k++)
+			mean[k] = mean[k] + sigma * meanStep[k];
+
+		vector<double> whitened(N, 0), projected(N, 0);		// C^-1/2 * meanStep
+		for(int j = 0; j < N; j++) {
+			for(int k = 0; k < N; k++)
+				projected[j] = projected[j] + B[k][j] * meanStep[k];
+			projected[j] = projected[j] / scale[j];
+		}
+		for(int k = 0; k < N; k++) {
+			for(int j = 0; j < N; j++)
+				whitened[k] = whitened[k] + B[k][j] * projected[j];
+		}
+
+		double psNorm = 0;
+		for(int k = 0; k < N; k++) {
+			ps[k] = (1 - cs) * ps[k] + sqrt(cs * (2 - cs) * mueff) * whitened[k];
+			psNorm = psNorm + ps[k] * ps[k];
+		}
+		psNorm = sqrt(psNorm);
+		int hsig = psNorm / sqrt(1 - pow(1 - cs, 2.0 * (generation + 1))) / chiN < 1.4 + 2.0 / (N + 1);
+		for(int k = 0; k < N; k++)
+			pc[k] = (1 - cc) * pc[k] + (hsig ? sqrt(cc * (2 - cc) * mueff) * meanStep[k] : 0);
+
+		for(int k = 0; k < N; k++) {
+			for(int j = 0; j < N; j++) {
+				double rankMu = 0;
+				for(int i = 0; i < mu; i++)
+					rankMu = rankMu + weights[i] * steps[order[i]][k] * steps[order[i]][j];
+				covariance[k][j] = (1 - c1 - cmu) * covariance[k][j] + c1 * (pc[k] * pc[j] + (hsig ? 0 : cc * (2 - cc) * covariance[k][j]))
+					+ cmu * rankMu;
+			}
+		}
+		sigma = sigma * exp((cs / damps) * (psNorm / chiN - 1));
+
+		cout << "Generation " << generation + 1 << ": " << evaluations << " simulations, best cost " << bestCost << endl;
+	}
+	// [END] CMA-ES =====================================================================================================
+
+	// [START] Report ===================================================================================================
+	cout << endl << "Input\tBuilding\tFitted" << endl;
+	for(int k = 0; k < N; k++) {
+		int input = setup.inputs[k];
+		cout << calibrateInputs[input].name << "\t" << setup.base[input] << "\t" << f_inputValue(setup, input, best[k]) << endl;
+	}
+
+	f_simulate(setup, best, modelled);
+	cout << endl << "Column\tRows\tRMS residual\tBias" << endl;
+	for(size_t c = 0; c < numColumns; c++) {
+		double sum = 0, sumSquares = 0;
+		long count = 0;
+		for(size_t r = 0; r < measured.minutes.size(); r++) {
+			double value = measured.values[r * numColumns + c];
+			double model = modelled[r * numColumns + c];
+			if(value != MISSING && model != MISSING) {
+				sum = sum + (model - value);
+				sumSquares = sumSquares + (model - value) * (model - value);
+				count++;
+			}
+		}
+		cout << measured.columns[c] << "\t" << count << "\t" << (count > 0 ? sqrt(sumSquares / count) : 0) << "\t"
+			<< (count > 0 ? sum / count : 0) << endl;
+	}
+	cout << "Cost " << bestCost << " after " << evaluations << " simulations" << endl;
+
+	if(!residualsFile_name.empty()) {
+		ofstream residualsFile(residualsFile_name);
+		if(!residualsFile) {
+			cout << "Cannot open: " << residualsFile_name << endl;
+			return 1;
+		}
+		residualsFile << "minute";
+		for(size_t c = 0; c < numColumns; c++)
+			residualsFile << "\t" << measured.columns[c] << "\tmodel\tresidual";
+		residualsFile << endl;
+		for(size_t r = 0; r < measured.minutes.size(); r++) {
+			residualsFile << measured.minutes[r];
+			for(size_t c = 0; c < numColumns; c++) {
+				double value = measured.values[r * numColumns + c];
+				double model = modelled[r * numColumns + c];
+				if(value == MISSING || model == MISSING)
+					residualsFile << "\tNA\tNA\tNA";
+				else
+					residualsFile << "\t" << value << "\t" << model << "\t" << model - value;
+			}
+			residualsFile << endl;
+		}
+	}
+	// [END] Report =====================================================================================================
+	return 0;
+}
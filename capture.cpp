@@ -0,0 +1,419 @@
+#include "capture.h"
+
+#ifdef REGCAP_CAPTURE
+
+#include "report.h"
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+
+// Kernels that are local to functions.cpp
+int MatSEqn(double A[][16], double* b, int asize, int asize2, int bsize);
+void f_CpTheta(double CP[4][4], const double& windAngle, double* wallCp);
+void f_wallFlow3(const double& tempHouse, const double& tempOut, const double& airDensityIN, const double& airDensityOUT, const double& Bo,
+	const double& wallCp, const double& n, const double& Cwall, const double& h, const double& Pint, const double& dPtemp,
+	const double& dPwind, double& Mwall, double& Mwallin, double& Mwallout, double& dPwalltop, double& dPwallbottom, const double& Hfloor);
+void f_winDoorFlow(const double& tempHouse, const double& tempOut, const double& airDensityIN, const double& airDensityOUT, const double& h,
+	const double& Bo, const double& wallCp, const double& n, const double& Pint, const double& dPtemp, const double& dPwind,
+	winDoor_struct& winDoor);
+
+CAPTURE_THREAD capture_struct* captureActive;
+
+// ============================= FILE ==============================================================
+
+captureFile_struct::captureFile_struct() {
+	reading = 0;
+}
+
+// A copied simulation does not record; the copy of its capture file starts closed
+captureFile_struct::captureFile_struct(const captureFile_struct& other) {
+	reading = other.reading;
+}
+
+int captureFile_struct::open(string fileName, int forReading) {
+	reading = forReading;
+	stream.open(fileName, (reading ? ios::in : ios::out | ios::trunc) | ios::binary);
+	if(!stream)
+		return 1;
+
+	int version = CAPTURE_VERSION;
+	io(version);
+	if(!stream || version != CAPTURE_VERSION)
+		return 1;
+	return 0;
+}
+
+void captureFile_struct::close() {
+	stream.close();
+}
+
+void captureFile_struct::io(string& s) {
+	int length = int (s.size());
+	io(length);
+	if(reading) {
+		if(length < 0 || !stream)
+			length = 0;
+		s.resize(length);
+	}
+	if(length > 0)
+		io(&s[0], length);
+}
+
+// ============================= RECORDING ==============================================================
+
+int capture_struct::open(string fileName) {
+	if(file.open(fileName, 0) == 1) {
+		sub_report("Cannot open: " + fileName);
+		return 1;
+	}
+	isOpen = 1;
+	category = CAP_SAMPLE;
+	minute = 0;
+	lastAHflag = 0;
+	for(int i = 0; i < CAP_CATEGORIES; i++)
+		lastMinute[i] = -CAPTURE_SPACING;
+	return 0;
+}
+
+// Economizer, air handler switching and near-zero pressure minutes are each recorded at most once every
+// CAPTURE_SPACING minutes so that they spread through the year rather than bunching in January.
+void capture_struct::stepBegin(long int currentMinute, int econoFlag, int AHflag, double Pint) {
+	int switched = (AHflag != lastAHflag);
+	lastAHflag = AHflag;
+
+	if(!isOpen)
+		return;
+
+	category = -1;
+	if(econoFlag == 1 && currentMinute - lastMinute[CAP_ECONOMIZER] >= CAPTURE_SPACING)
+		category = CAP_ECONOMIZER;
+	else if(switched && currentMinute - lastMinute[CAP_CYCLING] >= CAPTURE_SPACING)
+		category = CAP_CYCLING;
+	else if(abs(Pint) < CAPTURE_NEARZERO && currentMinute - lastMinute[CAP_NEARZERO] >= CAPTURE_SPACING)
+		category = CAP_NEARZERO;
+	else if(currentMinute % CAPTURE_SAMPLE_INTERVAL == 0)
+		category = CAP_SAMPLE;
+
+	if(category < 0)
+		return;
+
+	lastMinute[category] = currentMinute;
+	minute = currentMinute;
+	captureActive = this;
+}
+
+void capture_struct::stepEnd() {
+	if(captureActive == this)
+		captureActive = 0;
+}
+
+void capture_struct::close() {
+	stepEnd();
+	if(isOpen)
+		file.close();
+	isOpen = 0;
+}
+
+void f_captureMatSEqn(double A[][16], double* b, int asize, int asize2, int bsize) {
+	matSEqnCall_struct call;
+	for(int i = 0; i < 16; i++) {
+		for(int j = 0; j < 16; j++)
+			call.A[i][j] = A[i][j];
+		call.b[i] = b[i];
+	}
+	call.asize = asize;
+	call.asize2 = asize2;
+	call.bsize = bsize;
+	f_captureWrite(CAP_MATSEQN, call);
+}
+
+void f_captureHouseLeak(const building_struct& building, const houseState_struct& state, const weatherSample_struct& weather) {
+	houseLeakCall_struct call;
+	call.building = building;
+	call.state = state;
+	call.weather = weather;
+	f_captureWrite(CAP_HOUSELEAK, call);
+}
+
+void f_captureAtticLeak(const building_struct& building, const houseState_struct& state, const weatherSample_struct& weather) {
+	atticLeakCall_struct call;
+	call.building = building;
+	call.state = state;
+	call.weather = weather;
+	f_captureWrite(CAP_ATTICLEAK, call);
+}
+
+void f_captureHeat(const building_struct& building, const houseState_struct& state, const weatherSample_struct& weather) {
+	heatCall_struct call;
+	call.building = building;
+	call.state = state;
+	call.weather = weather;
+	f_captureWrite(CAP_HEAT, call);
+}
+
+void f_captureMoisture(const building_struct& building, const houseState_struct& state, const weatherSample_struct& weather) {
+	moistureCall_struct call;
+	call.building = building;
+	call.state = state;
+	call.weather = weather;
+	f_captureWrite(CAP_MOISTURE, call);
+}
+
+void f_captureWallFlow3(const double& tempHouse, const double& tempOut, const double& airDensityIN, const double& airDensityOUT,
+	const double& Bo, const double& wallCp, const double& n, const double& Cwall, const double& h, const double& Pint, const double& dPtemp,
+	const double& dPwind, const double& Mwall, const double& Mwallin, const double& Mwallout, const double& dPwalltop,
+	const double& dPwallbottom, const double& Hfloor) {
+
+	wallFlowCall_struct call = { tempHouse, tempOut, airDensityIN, airDensityOUT, Bo, wallCp, n, Cwall, h, Pint, dPtemp, dPwind,
+		Mwall, Mwallin, Mwallout, dPwalltop, dPwallbottom, Hfloor };
+	f_captureWrite(CAP_WALLFLOW, call);
+}
+
+void f_captureWinDoorFlow(const double& tempHouse, const double& tempOut, const double& airDensityIN, const double& airDensityOUT,
+	const double& h, const double& Bo, const double& wallCp, const double& n, const double& Pint, const double& dPtemp,
+	const double& dPwind, const winDoor_struct& winDoor) {
+
+	winDoorFlowCall_struct call = { tempHouse, tempOut, airDensityIN, airDensityOUT, h, Bo, wallCp, n, Pint, dPtemp, dPwind, winDoor };
+	f_captureWrite(CAP_WINDOORFLOW, call);
+}
+
+void f_captureCpTheta(double CP[4][4], const double& windAngle, const double* wallCp) {
+	cpThetaCall_struct call;
+	for(int i = 0; i < 4; i++) {
+		for(int j = 0; j < 4; j++)
+			call.CP[i][j] = CP[i][j];
+		call.wallCp[i] = wallCp[i];
+	}
+	call.windAngle = windAngle;
+	f_captureWrite(CAP_CPTHETA, call);
+}
+
+// ============================= CALL RECORDS ==============================================================
+// Plain structs of doubles and ints are written whole; strings are written as length and characters.
+
+void matSEqnCall_struct::io(captureFile_struct& f) {
+	f.io(&A[0][0], 16 * 16);
+	f.io(b, 16);
+	f.io(asize);
+	f.io(asize2);
+	f.io(bsize);
+}
+
+void matSEqnCall_struct::call() {
+	MatSEqn(A, b, asize, asize2, bsize);
+}
+
+void houseLeakCall_struct::io(captureFile_struct& f) {
+	f.io(state.AHflag);
+	f.io(state.flag);
+	f.io(state.windSpeed);
+	f.io(weather.direction);
+	f.io(state.tempHouse);
+	f.io(state.tempAttic);
+	f.io(state.tempOut);
+	f.io(state.C);
+	f.io(building.n);
+	f.io(building.h);
+	f.io(building.R);
+	f.io(building.X);
+	f.io(building.numFlues);
+	f.io(building.flue, 6);
+	f.io(building.wallFraction, 4);
+	f.io(building.floorFraction, 4);
+	f.io(state.Sw, 4);
+	f.io(building.flueShelterFactor);
+	f.io(building.numWinDoor);
+	f.io(state.winDoor, 10);
+	f.io(building.numFans);
+	f.io(state.fan, 10);
+	f.io(building.numPipes);
+	f.io(state.Pipe, 10);
+	f.io(state.mIN);
+	f.io(state.mOUT);
+	f.io(state.Pint);
+	f.io(state.mFlue);
+	f.io(state.flow);
+	f.io(state.mFloor, 4);
+	f.io(building.atticC);
+	f.io(state.dPflue);
+	f.io(state.dPceil);
+	f.io(state.dPfloor);
+	f.io(building.Crawl);
+	f.io(building.Hfloor);
+	f.io(building.rowOrIsolated);
+	f.io(building.soffitFraction, 5);
+	f.io(state.Patticint);
+	f.io(state.wallCp, 4);
+	f.io(building.airDensityRef);
+	f.io(building.airTempRef);
+	f.io(building.duct);
+	f.io(building.Aeq);
+	f.io(state.airDensityIN);
+	f.io(state.airDensityOUT);
+	f.io(state.airDensityATTIC);
+	f.io(state.ceilingC);
+	f.io(building.houseVolume);
+	f.io(building.windPressureExp);
+	f.io(building.Q622);
+}
+
+void houseLeakCall_struct::call() {
+	sub_houseLeak(building, state, weather, solver);
+}
+
+void atticLeakCall_struct::io(captureFile_struct& f) {
+	f.io(state.flag);
+	f.io(state.windSpeed);
+	f.io(weather.direction);
+	f.io(state.tempHouse);
+	f.io(state.tempOut);
+	f.io(state.tempAttic);
+	f.io(building.atticC);
+	f.io(building.atticPressureExp);
+	f.io(building.h);
+	f.io(building.roofPeakHeight);
+	f.io(building.flueShelterFactor);
+	f.io(state.Sw, 4);
+	f.io(building.numAtticVents);
+	f.io(state.atticVent, 10);
+	f.io(state.soffit, 4);
+	f.io(state.mAtticIN);
+	f.io(state.mAtticOUT);
+	f.io(state.Patticint);
+	f.io(state.flow);
+	f.io(building.rowOrIsolated);
+	f.io(building.soffitFraction, 5);
+	f.io(building.roofPitch);
+	f.io(building.roofPeakOrient);
+	f.io(building.numAtticFans);
+	f.io(state.atticFan, 10);
+	f.io(building.airDensityRef);
+	f.io(building.airTempRef);
+	f.io(building.dtau);
+	f.io(state.airDensityIN);
+	f.io(state.airDensityOUT);
+	f.io(state.airDensityATTIC);
+}
+
+void atticLeakCall_struct::call() {
+	sub_atticLeak(building, state, weather, solver);
+}
+
+void heatCall_struct::io(captureFile_struct& f) {
+	f.io(state.tempOut);
+	f.io(building.airDensityRef);
+	f.io(building.airTempRef);
+	f.io(state.flow);
+	f.io(state.AL4);
+	f.io(state.windSpeed);
+	f.io(state.ssolrad);
+	f.io(state.nsolrad);
+	f.io(state.tempOld, 16);
+	f.io(building.atticVolume);
+	f.io(building.houseVolume);
+	f.io(state.sc);
+	f.io(state.b, 16);
+	f.io(state.ERRCODE);
+	f.io(state.TSKY);
+	f.io(building.floorArea);
+	f.io(building.roofPitch);
+	f.io(building.duct);
+	f.io(state.pRef);
+	f.io(weather.HROUT);
+	f.io(state.diffuse);
+	f.io(state.UA);
+	f.io(building.planArea);
+	f.io(state.solgain);
+	f.io(building.windowS);
+	f.io(building.windowN);
+	f.io(building.windowWE);
+	f.io(building.winShadingCoef);
+	f.io(building.roofPeakHeight);
+	f.io(building.h);
+	f.io(building.roofType);
+	f.io(state.M1);
+	f.io(state.M12);
+	f.io(state.M15);
+	f.io(state.M16);
+	f.io(building.roofRval);
+	f.io(state.rceil);
+	f.io(state.AHflag);
+	f.io(building.dtau);
+	f.io(building.ERV_SRE);
+	f.io(building.HRV_ASE);
+	f.io(state.SBETA);
+	f.io(state.CBETA);
+	f.io(building.L);
+	f.io(state.dec);
+	f.io(state.Csol);
+	f.io(weather.idirect);
+	f.io(state.equip);
+	f.io(state.internalGains);
+	f.io(state.bsize);
+	f.io(state.airDensityIN);
+	f.io(state.airDensityOUT);
+	f.io(state.airDensityATTIC);
+	f.io(state.airDensitySUP);
+	f.io(state.airDensityRET);
+	f.io(building.numStories);
+	f.io(building.storyHeight);
+	f.io(building.massFactor);
+}
+
+void heatCall_struct::call() {
+	sub_heat(building, state, weather, solver);
+}
+
+void moistureCall_struct::io(captureFile_struct& f) {
+	f.io(state.HR, 5);
+	f.io(state.hrold, 5);
+	f.io(state.M1);
+	f.io(state.M12);
+	f.io(state.M15);
+	f.io(state.M16);
+	f.io(building.Mw5);
+	f.io(building.dtau);
+	f.io(state.flow);
+	f.io(weather.HROUT);
+	f.io(state.equip);
+	f.io(building.latentLoad);
+	f.io(building.ERV_TRE);
+	f.io(building.MWha);
+	f.io(state.airDensityIN);
+	f.io(state.airDensityOUT);
+}
+
+void moistureCall_struct::call() {
+	sub_moisture(building, state, weather);
+}
+
+void wallFlowCall_struct::io(captureFile_struct& f) {
+	f.io(&tempHouse, 18);		// Eighteen consecutive doubles, tempHouse to Hfloor
+}
+
+void wallFlowCall_struct::call() {
+	f_wallFlow3(tempHouse, tempOut, airDensityIN, airDensityOUT, Bo, wallCp, n, Cwall, h, Pint, dPtemp, dPwind, Mwall, Mwallin, Mwallout,
+		dPwalltop, dPwallbottom, Hfloor);
+}
+
+void winDoorFlowCall_struct::io(captureFile_struct& f) {
+	f.io(&tempHouse, 11);		// Eleven consecutive doubles, tempHouse to dPwind
+	f.io(winDoor);
+}
+
+void winDoorFlowCall_struct::call() {
+	f_winDoorFlow(tempHouse, tempOut, airDensityIN, airDensityOUT, h, Bo, wallCp, n, Pint, dPtemp, dPwind, winDoor);
+}
+
+void cpThetaCall_struct::io(captureFile_struct& f) {
+	f.io(&CP[0][0], 16);
+	f.io(windAngle);
+	f.io(wallCp, 4);
+}
+
+void cpThetaCall_struct::call() {
+	f_CpTheta(CP, windAngle, wallCp);
+}
+
+#endif
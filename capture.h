@@ -0,0 +1,238 @@
+#pragma once
+#ifndef capture_h
+#define capture_h
+
+// Recording of physics kernel arguments from real runs, replayed by the kernel benchmark (bench.cpp).
+// Build rc++ with REGCAP_CAPTURE defined and run a batch as usual: each simulation writes <output>.cap with
+// the arguments of every kernel call made during a selection of minutes (economizer running, air handler
+// switching, near-zero house pressure and a regular sample through the year). Without REGCAP_CAPTURE the
+// CAPTURE_ macros expand to nothing.
+
+#ifdef REGCAP_CAPTURE
+
+#include <fstream>
+#include <string>
+#include "functions.h"
+
+#if defined(_MSC_VER)
+#define CAPTURE_THREAD __declspec(thread)
+#else
+#define CAPTURE_THREAD __thread
+#endif
+
+using namespace std;
+
+// Kernels recorded. The ids are stored in the .cap file so only append to this list.
+enum captureKernel_enum {
+	CAP_MATSEQN,
+	CAP_HOUSELEAK,
+	CAP_ATTICLEAK,
+	CAP_HEAT,
+	CAP_MOISTURE,
+	CAP_WALLFLOW,
+	CAP_WINDOORFLOW,
+	CAP_CPTHETA,
+	CAP_KERNELS
+};
+
+// Why a minute was recorded
+enum captureCategory_enum {
+	CAP_SAMPLE,				// Regular sample through the year
+	CAP_ECONOMIZER,			// Economizer open
+	CAP_CYCLING,			// Air handler switched mode since the previous minute
+	CAP_NEARZERO,			// House pressure within CAPTURE_NEARZERO of zero at the start of the minute
+	CAP_CATEGORIES
+};
+
+const int CAPTURE_VERSION = 2;
+const int CAPTURE_SAMPLE_INTERVAL = 10007;		// Minutes between regular samples
+const int CAPTURE_SPACING = 10080;				// Minimum minutes between two recordings of the same category
+const double CAPTURE_NEARZERO = 0.1;			// [Pa]
+
+// Binary reader/writer. io() writes when the file was opened for writing and reads otherwise, so each
+// call record describes its layout once for both directions.
+struct captureFile_struct {
+	captureFile_struct();
+	captureFile_struct(const captureFile_struct& other);
+	int open(string fileName, int forReading);
+	void close();
+
+	template<class T> void io(T& x) {
+		io(&x, 1);
+	}
+	template<class T> void io(T* x, int count) {
+		if(reading)
+			stream.read((char*) x, sizeof(T) * count);
+		else
+			stream.write((const char*) x, sizeof(T) * count);
+	}
+	void io(string& s);
+
+	fstream stream;
+	int reading;
+};
+
+// Argument sets, one per kernel, mirroring the kernel's parameter list. call() runs the kernel on them. The airflow,
+// heat and moisture kernels take the building, state and weather structs whole; the files hold only the members
+// each one reads, in the order of its earlier parameter lists, so the .cap layout is unchanged.
+struct matSEqnCall_struct {
+	double A[16][16];
+	double b[16];
+	int asize;
+	int asize2;
+	int bsize;
+
+	void io(captureFile_struct& f);
+	void call();
+};
+
+struct houseLeakCall_struct {
+	building_struct building;
+	houseState_struct state;
+	weatherSample_struct weather;
+	solver_struct solver;
+
+	void io(captureFile_struct& f);
+	void call();
+};
+
+struct atticLeakCall_struct {
+	building_struct building;
+	houseState_struct state;
+	weatherSample_struct weather;
+	solver_struct solver;
+
+	void io(captureFile_struct& f);
+	void call();
+};
+
+struct heatCall_struct {
+	building_struct building;
+	houseState_struct state;
+	weatherSample_struct weather;
+	solver_struct solver;
+
+	void io(captureFile_struct& f);
+	void call();
+};
+
+struct moistureCall_struct {
+	building_struct building;
+	houseState_struct state;
+	weatherSample_struct weather;
+
+	void io(captureFile_struct& f);
+	void call();
+};
+
+struct wallFlowCall_struct {
+	double tempHouse;
+	double tempOut;
+	double airDensityIN;
+	double airDensityOUT;
+	double Bo;
+	double wallCp;
+	double n;
+	double Cwall;
+	double h;
+	double Pint;
+	double dPtemp;
+	double dPwind;
+	double Mwall;
+	double Mwallin;
+	double Mwallout;
+	double dPwalltop;
+	double dPwallbottom;
+	double Hfloor;
+
+	void io(captureFile_struct& f);
+	void call();
+};
+
+struct winDoorFlowCall_struct {
+	double tempHouse;
+	double tempOut;
+	double airDensityIN;
+	double airDensityOUT;
+	double h;
+	double Bo;
+	double wallCp;
+	double n;
+	double Pint;
+	double dPtemp;
+	double dPwind;
+	winDoor_struct winDoor;
+
+	void io(captureFile_struct& f);
+	void call();
+};
+
+struct cpThetaCall_struct {
+	double CP[4][4];
+	double windAngle;
+	double wallCp[4];
+
+	void io(captureFile_struct& f);
+	void call();
+};
+
+// Per-simulation recording state. stepBegin() decides whether the coming minute is recorded and, if so,
+// points captureActive at this simulation until stepEnd().
+struct capture_struct {
+	int open(string fileName);
+	void stepBegin(long int minute, int econoFlag, int AHflag, double Pint);
+	void stepEnd();
+	void close();
+
+	captureFile_struct file;
+	int isOpen;
+	int category;							// Category of the minute being recorded
+	long int minute;
+	long int lastMinute[CAP_CATEGORIES];	// Last minute recorded in each category
+	int lastAHflag;
+};
+
+// Simulation recording on this thread, or null when the current minute is not being recorded
+extern CAPTURE_THREAD capture_struct* captureActive;
+
+// Writes one call record: kernel id, category and minute, then the arguments
+template<class T> void f_captureWrite(int kernel, T& call) {
+	captureFile_struct& f = captureActive->file;
+	f.io(kernel);
+	f.io(captureActive->category);
+	f.io(captureActive->minute);
+	call.io(f);
+}
+
+// Called on entry to each kernel with the kernel's own arguments
+void f_captureMatSEqn(double A[][16], double* b, int asize, int asize2, int bsize);
+void f_captureHouseLeak(const building_struct& building, const houseState_struct& state, const weatherSample_struct& weather);
+void f_captureAtticLeak(const building_struct& building, const houseState_struct& state, const weatherSample_struct& weather);
+void f_captureHeat(const building_struct& building, const houseState_struct& state, const weatherSample_struct& weather);
+void f_captureMoisture(const building_struct& building, const houseState_struct& state, const weatherSample_struct& weather);
+void f_captureWallFlow3(const double& tempHouse, const double& tempOut, const double& airDensityIN, const double& airDensityOUT,
+	const double& Bo, const double& wallCp, const double& n, const double& Cwall, const double& h, const double& Pint, const double& dPtemp,
+	const double& dPwind, const double& Mwall, const double& Mwallin, const double& Mwallout, const double& dPwalltop,
+	const double& dPwallbottom, const double& Hfloor);
+void f_captureWinDoorFlow(const double& tempHouse, const double& tempOut, const double& airDensityIN, const double& airDensityOUT,
+	const double& h, const double& Bo, const double& wallCp, const double& n, const double& Pint, const double& dPtemp,
+	const double& dPwind, const winDoor_struct& winDoor);
+void f_captureCpTheta(double CP[4][4], const double& windAngle, const double* wallCp);
+
+#define CAPTURE_CALL(capture)					if(captureActive) capture
+#define CAPTURE_OPEN(c, file)					(c).open(file)
+#define CAPTURE_STEP_BEGIN(c, minute, econoFlag, AHflag, Pint)	(c).stepBegin(minute, econoFlag, AHflag, Pint)
+#define CAPTURE_STEP_END(c)						(c).stepEnd()
+#define CAPTURE_CLOSE(c)						(c).close()
+
+#else
+
+#define CAPTURE_CALL(capture)					((void)0)
+#define CAPTURE_OPEN(c, file)					0
+#define CAPTURE_STEP_BEGIN(c, minute, econoFlag, AHflag, Pint)	((void)0)
+#define CAPTURE_STEP_END(c)						((void)0)
+#define CAPTURE_CLOSE(c)						((void)0)
+
+#endif
+
+#endif
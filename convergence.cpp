@@ -0,0 +1,189 @@
+#include "convergence.h"
+#include "report.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+static const char* solverNames[CONV_SOLVERS] = {
+	"Pint bisection", "Patticint bisection", "Ceiling alternation", "sub_heat", "Main loop"
+};
+
+// Decade bin for a residual: 0 for an exact zero, 1 for anything below 1e-15, up to CONV_RESIDUAL_BINS - 1
+static int f_residualBin(double residual) {
+	if(residual <= 0)
+		return 0;
+
+	int bin = int (floor(log10(residual))) + 17;
+	if(bin < 1)
+		bin = 1;
+	if(bin > CONV_RESIDUAL_BINS - 1)
+		bin = CONV_RESIDUAL_BINS - 1;
+	return bin;
+}
+
+// Heap order for the worst-minutes log: the cheapest minute sits at the front so it is the one replaced
+static bool f_cheaperMinute(const convergenceMinute_struct& a, const convergenceMinute_struct& b) {
+	if(a.iterations[CONV_HEAT] != b.iterations[CONV_HEAT])
+		return a.iterations[CONV_HEAT] > b.iterations[CONV_HEAT];
+	return a.iterations[CONV_CEILING] > b.iterations[CONV_CEILING];
+}
+
+void convergence_struct::init(int worstMinutes) {
+	for(int i = 0; i < CONV_SOLVERS; i++) {
+		for(int j = 0; j < CONV_ITERATION_BINS; j++)
+			iterationHistogram[i][j] = 0;
+		for(int j = 0; j < CONV_RESIDUAL_BINS; j++)
+			residualHistogram[i][j] = 0;
+		totalIterations[i] = 0;
+		maxIterations[i] = 0;
+		maxResidual[i] = 0;
+		unconverged[i] = 0;
+	}
+	minutes = 0;
+	worstSize = worstMinutes;
+	worst.clear();
+	worst.reserve(worstSize);
+}
+
+void convergence_struct::stepBegin() {
+	for(int i = 0; i < CONV_SOLVERS; i++) {
+		minuteIterations[i] = 0;
+		minuteResidual[i] = 0;
+		minuteConverged[i] = 1;
+	}
+}
+
+void convergence_struct::add(int solver, solver_struct& result, int converged) {
+	minuteIterations[solver] = minuteIterations[solver] + result.iterations;
+	minuteResidual[solver] = result.residual;
+	minuteConverged[solver] = converged;
+}
+
+void convergence_struct::stepEnd(long int minute, int day, int hour, double tempOut, double windSpeed, double direction, double tempHouse,
+	double tempAttic, int AHflag, int rivecOn, double Pint) {
+
+	for(int i = 0; i < CONV_SOLVERS; i++) {
+		int bin = minuteIterations[i];
+		if(bin > CONV_ITERATION_BINS - 1)
+			bin = CONV_ITERATION_BINS - 1;
+
+		iterationHistogram[i][bin]++;
+		residualHistogram[i][f_residualBin(minuteResidual[i])]++;
+		totalIterations[i] = totalIterations[i] + minuteIterations[i];
+		if(minuteIterations[i] > maxIterations[i])
+			maxIterations[i] = minuteIterations[i];
+		if(minuteResidual[i] > maxResidual[i])
+			maxResidual[i] = minuteResidual[i];
+		if(!minuteConverged[i])
+			unconverged[i]++;
+	}
+	minutes++;
+
+	if(worstSize <= 0)
+		return;
+
+	convergenceMinute_struct sample;
+	sample.minute = minute;
+	sample.day = day;
+	sample.hour = hour;
+	sample.tempOut = tempOut;
+	sample.windSpeed = windSpeed;
+	sample.direction = direction;
+	sample.tempHouse = tempHouse;
+	sample.tempAttic = tempAttic;
+	sample.AHflag = AHflag;
+	sample.rivecOn = rivecOn;
+	sample.Pint = Pint;
+	for(int i = 0; i < CONV_SOLVERS; i++) {
+		sample.iterations[i] = minuteIterations[i];
+		sample.residual[i] = minuteResidual[i];
+	}
+
+	if(int (worst.size()) < worstSize) {
+		worst.push_back(sample);
+		push_heap(worst.begin(), worst.end(), f_cheaperMinute);
+	} else if(f_cheaperMinute(sample, worst.front())) {
+		pop_heap(worst.begin(), worst.end(), f_cheaperMinute);
+		worst.back() = sample;
+		push_heap(worst.begin(), worst.end(), f_cheaperMinute);
+	}
+}
+
+// Writes the .cnv report: a summary per solver, the iteration and residual histograms and the worst minutes
+int convergence_struct::write(string fileName, string title) {
+	ofstream cnvFile(fileName);
+	if(!cnvFile) {
+		sub_report("Cannot open: " + fileName);
+		return 1;
+	}
+
+	cnvFile << "Convergence\t" << title << endl;
+	cnvFile << "Minutes\t" << minutes << endl;
+	cnvFile << endl;
+
+	cnvFile << "Solver\tIterations\tIterations per minute\tMax iterations in a minute\tMax residual\tUnconverged minutes" << endl;
+	for(int i = 0; i < CONV_SOLVERS; i++) {
+		cnvFile << solverNames[i] << "\t" << totalIterations[i] << "\t" << (minutes ? (double) totalIterations[i] / minutes : 0) << "\t";
+		cnvFile << maxIterations[i] << "\t" << maxResidual[i] << "\t" << unconverged[i] << endl;
+	}
+	cnvFile << endl;
+
+	cnvFile << "Iterations";
+	for(int i = 0; i < CONV_SOLVERS; i++)
+		cnvFile << "\t" << solverNames[i];
+	cnvFile << endl;
+	for(int j = 0; j < CONV_ITERATION_BINS; j++) {
+		cnvFile << j << (j == CONV_ITERATION_BINS - 1 ? "+" : "");
+		for(int i = 0; i < CONV_SOLVERS; i++)
+			cnvFile << "\t" << iterationHistogram[i][j];
+		cnvFile << endl;
+	}
+	cnvFile << endl;
+
+	cnvFile << "Residual below";
+	for(int i = 0; i < CONV_SOLVERS; i++)
+		cnvFile << "\t" << solverNames[i];
+	cnvFile << endl;
+	for(int j = 0; j < CONV_RESIDUAL_BINS; j++) {
+		if(j == 0)
+			cnvFile << "0";
+		else if(j == CONV_RESIDUAL_BINS - 1)
+			cnvFile << "inf";
+		else
+			cnvFile << "1e" << j - 16;
+		for(int i = 0; i < CONV_SOLVERS; i++)
+			cnvFile << "\t" << residualHistogram[i][j];
+		cnvFile << endl;
+	}
+
+	if(!worst.empty()) {
+		vector<convergenceMinute_struct> sorted(worst);
+		sort_heap(sorted.begin(), sorted.end(), f_cheaperMinute);
+
+		cnvFile << endl;
+		cnvFile << "Worst minutes" << endl;
+		cnvFile << "Minute\tDay\tHour\ttempOut\twindSpeed\tdirection\ttempHouse\ttempAttic\tAHflag\trivecOn\tPint";
+		for(int i = 0; i < CONV_SOLVERS; i++)
+			cnvFile << "\t" << solverNames[i] << " iterations\t" << solverNames[i] << " residual";
+		cnvFile << endl;
+
+		for(size_t k = 0; k < sorted.size(); k++) {
+			convergenceMinute_struct& m = sorted[k];
+			cnvFile << m.minute << "\t" << m.day << "\t" << m.hour << "\t" << m.tempOut << "\t" << m.windSpeed << "\t" << m.direction << "\t";
+			cnvFile << m.tempHouse << "\t" << m.tempAttic << "\t" << m.AHflag << "\t" << m.rivecOn << "\t" << m.Pint;
+			for(int i = 0; i < CONV_SOLVERS; i++)
+				cnvFile << "\t" << m.iterations[i] << "\t" << m.residual[i];
+			cnvFile << endl;
+		}
+	}
+
+	cnvFile.close();
+	if(cnvFile.fail()) {
+		sub_report("Cannot write: " + fileName);
+		return 1;
+	}
+	return 0;
+}
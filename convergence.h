@@ -0,0 +1,68 @@
+#pragma once
+#ifndef convergence_h
+#define convergence_h
+
+#include <string>
+#include <vector>
+#include "functions.h"
+
+using namespace std;
+
+// Iterative solvers in the heat and mass transport section of the minute loop
+enum convergenceSolver_enum {
+	CONV_PINT,				// House pressure bisection in sub_houseLeak
+	CONV_PATTIC,			// Attic pressure bisection in sub_atticLeak
+	CONV_CEILING,			// House/attic alternation on the ceiling mass flow
+	CONV_HEAT,				// Node temperature iteration in sub_heat
+	CONV_MAIN,				// Ventilation/temperature iteration in the main loop
+	CONV_SOLVERS
+};
+
+const int CONV_ITERATION_BINS = 64;		// Iterations per minute; the last bin collects everything above
+const int CONV_RESIDUAL_BINS = 22;		// Bin 0 is an exact zero, then one bin per decade from 1e-16 up
+
+// A minute listed in the worst-minutes log, with the conditions that produced it
+struct convergenceMinute_struct {
+	long int minute;
+	int day;
+	int hour;
+	double tempOut;
+	double windSpeed;
+	double direction;
+	double tempHouse;
+	double tempAttic;
+	int AHflag;
+	int rivecOn;
+	double Pint;
+	int iterations[CONV_SOLVERS];
+	double residual[CONV_SOLVERS];
+};
+
+// Per-simulation record of how hard the solvers worked each minute. Iterations are summed over every call
+// in the minute; the residual is the one left by the last call. A minute counts as unconverged when the
+// ceiling alternation or the main loop gave up at its cap rather than meeting its tolerance.
+struct convergence_struct {
+	void init(int worstMinutes);
+	void stepBegin();
+	void add(int solver, solver_struct& result, int converged);
+	void stepEnd(long int minute, int day, int hour, double tempOut, double windSpeed, double direction, double tempHouse,
+		double tempAttic, int AHflag, int rivecOn, double Pint);
+	int write(string fileName, string title);
+
+	int minuteIterations[CONV_SOLVERS];
+	double minuteResidual[CONV_SOLVERS];
+	int minuteConverged[CONV_SOLVERS];
+
+	long long iterationHistogram[CONV_SOLVERS][CONV_ITERATION_BINS];
+	long long residualHistogram[CONV_SOLVERS][CONV_RESIDUAL_BINS];
+	long long totalIterations[CONV_SOLVERS];
+	int maxIterations[CONV_SOLVERS];
+	double maxResidual[CONV_SOLVERS];
+	long long unconverged[CONV_SOLVERS];
+	long long minutes;
+
+	int worstSize;								// Number of minutes kept in the worst-minutes log (0 = no log)
+	vector<convergenceMinute_struct> worst;		// Min-heap on sub_heat iterations, then house/attic alternations
+};
+
+#endif
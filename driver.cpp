@@ -0,0 +1,258 @@
+#include "driver.h"
+#include "cache.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+
+using namespace std;
+
+string f_folder(string folder) {
+	if(!folder.empty() && folder[folder.size() - 1] != '\\' && folder[folder.size() - 1] != '/')
+		folder = folder + "/";
+	return folder;
+}
+
+void sub_trimLine(string& line) {
+	if(!line.empty() && line[line.size() - 1] == '\r')
+		line.erase(line.size() - 1);
+}
+
+void sub_defaultSettings(driverSettings_struct& settings) {
+	settings.inPath = "Z:\\humidity_bdless\\newRHfix\\50%FlowRateFix\\";			// Brennan's
+	settings.outPath = "Z:\\humidity_bdless\\out_RHfix\\50%FlowRateFix\\";
+	settings.weatherPath = "C:\\RC++\\weather\\IECC\\";					// IECC weather files (DOE, all of the US); the CEC folder has California's
+	settings.shelterFile_name = "C:\\RC++\\shelter\\bshelter.dat";
+	settings.schedulePath = "C:\\RC++\\schedules\\";
+	settings.SCHEDNUM = "a";
+	settings.transformsFile_name = "";
+	settings.weatherTransforms.clear();
+	settings.totaldays = 365;
+	settings.startDay = 1;
+	settings.spinupDays = 0;
+	settings.numThreads = (int) thread::hardware_concurrency();
+}
+
+int f_driverSetting(driverSettings_struct& settings, string& name, string& value, int& bad) {
+	if(name == "in") {
+		settings.inPath = f_folder(value);
+	} else if(name == "out") {
+		settings.outPath = f_folder(value);
+	} else if(name == "weather") {
+		settings.weatherPath = f_folder(value);
+	} else if(name == "shelter") {
+		settings.shelterFile_name = value;
+	} else if(name == "schedules") {
+		settings.schedulePath = f_folder(value);
+	} else if(name == "schednum") {
+		settings.SCHEDNUM = value;
+	} else if(name == "transforms") {
+		settings.transformsFile_name = value;
+	} else if(name == "days") {
+		settings.totaldays = atoi(value.c_str());
+	} else if(name == "start") {
+		settings.startDay = f_dayOfYear(value);
+		bad = settings.startDay == 0;
+	} else if(name == "spinup") {
+		settings.spinupDays = atoi(value.c_str());
+		bad = settings.spinupDays < 0;
+	} else if(name == "threads") {
+		settings.numThreads = atoi(value.c_str());
+	} else {
+		return 0;
+	}
+	return 1;
+}
+
+int f_driverArguments(int argc, char* argv[], string& file_name, int& numThreads) {
+	numThreads = 0;
+	file_name = "";
+	for(int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if(arg == "-threads" && i + 1 < argc)
+			numThreads = atoi(argv[++i]);
+		else if(file_name.empty())
+			file_name = arg;
+		else
+			return 1;
+	}
+	return file_name.empty();
+}
+
+int f_finishSettings(driverSettings_struct& settings, int numThreads) {
+	if(numThreads > 0)
+		settings.numThreads = numThreads;
+	if(settings.numThreads < 1)
+		settings.numThreads = 1;
+	if(settings.transformsFile_name.empty())
+		return 0;
+	return f_readTransforms(settings.transformsFile_name, settings.weatherTransforms);
+}
+
+string f_studyName(string file_name) {
+	size_t slash = file_name.find_last_of("\\/");
+	string name = file_name.substr(slash == string::npos ? 0 : slash + 1);
+	return name.substr(0, name.find('.'));
+}
+
+void sub_driverBatch(driverSettings_struct& settings, batch_struct& batch) {
+	batch.inPath = settings.inPath;
+	batch.outPath = settings.outPath;
+	batch.weatherPath = settings.weatherPath;
+	batch.shelterFile_name = settings.shelterFile_name;
+	batch.fanSchedulefile_name1 = settings.schedulePath + "sched1" + settings.SCHEDNUM;
+	batch.fanSchedulefile_name2 = settings.schedulePath + "sched2" + settings.SCHEDNUM;
+	batch.fanSchedulefile_name3 = settings.schedulePath + "sched3" + settings.SCHEDNUM;
+	batch.totaldays = settings.totaldays;
+	batch.startDay = settings.startDay;
+	batch.spinupDays = settings.spinupDays;
+	batch.convergenceFlag = 0;
+	batch.convergenceWorst = 0;
+	batch.minuteOutputFlag = 0;
+	batch.compressionLevel = 0;
+	batch.scheduleSeed = 0;
+	batch.weatherTransforms = settings.weatherTransforms;
+}
+
+int f_readLines(string fileName, vector<string>& lines) {
+	ifstream file(fileName);
+	if(!file) {
+		cout << "Cannot open: " << fileName << endl;
+		return 1;
+	}
+	string line;
+	while(getline(file, line))
+		lines.push_back(line);
+	return 0;
+}
+
+string f_filesHash(vector<string>& fileNames) {
+	hash_struct hash;
+	hash.init();
+	for(size_t i = 0; i < fileNames.size(); i++)
+		hash.addFile(fileNames[i]);
+	return hash.text();
+}
+
+string f_buildingText(vector<string>& lines, vector<int>& lineNumbers, vector<double>& values) {
+	ostringstream text;
+	text << setprecision(17);
+	for(size_t l = 0; l < lines.size(); l++) {
+		int changed = -1;
+		for(size_t i = 0; i < lineNumbers.size(); i++) {
+			if(lineNumbers[i] == (int) l + 1)
+				changed = (int) i;
+		}
+		if(changed >= 0)
+			text << " " << values[changed] << "\n";
+		else
+			text << lines[l] << "\n";
+	}
+	return text.str();
+}
+
+int f_loadWeather(string weatherFile_name, int startDay, vector<weatherSample_struct>& weather, double& latitude, double& altitude) {
+	weatherFile_struct weatherFile;
+	if(sub_openWeather(weatherFile, weatherFile_name, latitude, altitude) || f_seekWeather(weatherFile, startDay)) {
+		cout << "Cannot open: " << weatherFile_name << endl;
+		return 1;
+	}
+	weatherSample_struct sample;
+	while(f_readWeather(weatherFile, sample))
+		weather.push_back(sample);
+	weatherFile.close();
+	return 0;
+}
+
+int f_simulateRun(batch_struct& batch, string buildingText, string input_file, string weather_file, string output_file,
+	vector<weatherSample_struct>& weather, double latitude, double altitude, sharedShelter_struct& shelter) {
+	simulation_struct* house = new simulation_struct();
+	house->buildingText = buildingText;
+	{
+		lock_guard<mutex> guard(shelter.lock);
+		house->shelter = shelter.table;
+	}
+	if(house->init(batch, input_file, weather_file, output_file, latitude, altitude)) {
+		delete house;
+		return 1;
+	}
+	{
+		lock_guard<mutex> guard(shelter.lock);
+		shelter.table = house->shelter;
+	}
+
+	vector<weatherSample_struct> firstDay(weather.begin(), weather.begin() + (weather.size() < 1440 ? weather.size() : 1440));
+	house->spinUp(firstDay);
+	for(size_t m = 0; m < weather.size() && house->step(weather[m]); m++) {
+	}
+	int error = house->finish();
+	delete house;
+	return error ? 1 : 0;
+}
+
+void driverPool_struct::start(int numThreads, size_t count, function<int(size_t)> job, function<void(size_t)> progress) {
+	this->job = job;
+	this->progress = progress;
+	this->count = count;
+	results.assign(count, 0);
+	done.assign(count, 0);
+	next = 0;
+	numDone = 0;
+	stopped = 0;
+	error = 0;
+	for(int t = 0; t < numThreads; t++)
+		workers.push_back(thread([this]() { sub_work(); }));
+}
+
+void driverPool_struct::sub_work() {
+	while(true) {
+		size_t n;
+		{
+			lock_guard<mutex> guard(lock);
+			if(stopped || next >= count)
+				return;
+			n = next++;
+		}
+
+		int result = job(n);
+
+		lock_guard<mutex> guard(lock);
+		results[n] = result;
+		done[n] = 1;
+		numDone++;
+		if(result && !error) {
+			error = result;
+			stopped = 1;
+		}
+		if(progress)
+			progress(numDone);
+		finished.notify_all();
+	}
+}
+
+// Returns 1 for a job that will not be run, as the pool stopped before it
+int driverPool_struct::f_wait(size_t n) {
+	unique_lock<mutex> guard(lock);
+	while(!done[n] && !(stopped && n >= next))
+		finished.wait(guard);
+	return done[n] ? results[n] : 1;
+}
+
+void driverPool_struct::sub_stop() {
+	lock_guard<mutex> guard(lock);
+	stopped = 1;
+}
+
+int driverPool_struct::f_finish() {
+	for(size_t t = 0; t < workers.size(); t++)
+		workers[t].join();
+	workers.clear();
+	return error;
+}
+
+int f_runParallel(int numThreads, size_t count, function<int(size_t)> job, function<void(size_t)> progress) {
+	driverPool_struct pool;
+	pool.start(numThreads, count, job, progress);
+	return pool.f_finish();
+}
@@ -0,0 +1,121 @@
+#pragma once
+#ifndef driver_h
+#define driver_h
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "simulation.h"
+#include "weather.h"
+
+using namespace std;
+
+// Pieces shared by the programs that drive many simulations from a study file: calibrate, sensitivity, ensemble
+// and repday (rc++ uses the folder and line helpers). Each study file has "name value" lines; the settings below are
+// the lines they have in common. sub_defaultSettings holds the defaults of every driver; rc++, server and regress start
+// from it too.
+
+// Adds a trailing separator to a folder given on the command line or in a study file
+string f_folder(string folder);
+
+// Drops the carriage return left by getline when a DOS text file is read on Linux
+void sub_trimLine(string& line);
+
+// Folders, files, days and threads of a study's simulations
+struct driverSettings_struct {
+	string inPath;
+	string outPath;
+	string weatherPath;
+	string shelterFile_name;
+	string schedulePath;
+	string SCHEDNUM;
+	string transformsFile_name;
+	vector<weatherTransform_struct> weatherTransforms;
+	int totaldays;
+	int startDay;
+	int spinupDays;
+	int numThreads;
+};
+
+// The defaults of rc++, one thread per core
+void sub_defaultSettings(driverSettings_struct& settings);
+
+// Takes a study file line that is one of the settings: in, out, weather, shelter, schedules, schednum, transforms,
+// days, start (day of the year or month/day), spinup and threads. Returns 0 if the name is none of them, and sets bad
+// for a value that cannot be used.
+int f_driverSetting(driverSettings_struct& settings, string& name, string& value, int& bad);
+
+// Reads the command line of a study program, [-threads n] file. numThreads is 0 if not given. Returns 1 for any
+// other command line.
+int f_driverArguments(int argc, char* argv[], string& file_name, int& numThreads);
+
+// Applies the -threads count (if any) to the study's, keeping at least one thread, and reads the weather transforms.
+// Returns f_readTransforms' error.
+int f_finishSettings(driverSettings_struct& settings, int numThreads);
+
+// A study is named after its file, without folder or extension
+string f_studyName(string file_name);
+
+// The batch settings every simulation of the study shares: no per-minute files, convergence or compression, and
+// the schedule files of the settings
+void sub_driverBatch(driverSettings_struct& settings, batch_struct& batch);
+
+// Lines of a text file as they are (building .csv lines keep their line ends). Returns 1 if it cannot be opened.
+int f_readLines(string fileName, vector<string>& lines);
+
+// Content hash of some files (see hash_struct in cache.h), kept in a study's header so that its results are only
+// reused while its building files are unchanged
+string f_filesHash(vector<string>& fileNames);
+
+// Building text with the given values on the given lines (from 1) and the other lines as they are
+string f_buildingText(vector<string>& lines, vector<int>& lineNumbers, vector<double>& values);
+
+// Reads a weather file from the start of startDay to its end. Returns 1 if it cannot be opened or ends before then.
+int f_loadWeather(string weatherFile_name, int startDay, vector<weatherSample_struct>& weather, double& latitude, double& altitude);
+
+// Shelter table read by the first simulation of a study and used by the rest (see simulation_struct::shelter)
+struct sharedShelter_struct {
+	mutex lock;
+	shared_ptr<shelterTable_struct> table;
+};
+
+// Simulates one run through its weather, after settling it on the first day (see simulation_struct::spinUp), and
+// writes its files. buildingText stands in for the input file when it is not empty. Returns 1 if the run cannot be
+// set up or its files written.
+int f_simulateRun(batch_struct& batch, string buildingText, string input_file, string weather_file, string output_file,
+	vector<weatherSample_struct>& weather, double latitude, double altitude, sharedShelter_struct& shelter);
+
+// Worker threads running job(0), job(1) ... in order as they come free, until count jobs are done or one returns
+// nonzero. progress, if given, is called after each job with the number done. A study that uses results as they
+// come waits for each with f_wait(), and can sub_stop() the pool handing out more; f_finish() waits for the
+// threads to end and returns the first nonzero result.
+struct driverPool_struct {
+	void start(int numThreads, size_t count, function<int(size_t)> job, function<void(size_t)> progress);
+	int f_wait(size_t n);
+	void sub_stop();
+	int f_finish();
+
+	void sub_work();
+
+	function<int(size_t)> job;
+	function<void(size_t)> progress;
+	mutex lock;
+	condition_variable finished;
+	vector<thread> workers;
+	vector<int> results;
+	vector<char> done;
+	size_t count;
+	size_t next;					// Next job to hand out
+	size_t numDone;
+	int stopped;
+	int error;						// First nonzero result
+};
+
+// Runs every job on numThreads threads and returns the first nonzero result
+int f_runParallel(int numThreads, size_t count, function<int(size_t)> job, function<void(size_t)> progress = function<void(size_t)>());
+
+#endif
@@ -0,0 +1,352 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include "driver.h"
+#include "output.h"
+#include "schedule.h"
+#include "simulation.h"
+#include "weather.h"
+
+using namespace std;
+
+// Monte Carlo ensembles of one house in one climate. Each realization has its own generated fan schedules (see
+// schedule.h) and, optionally, its own values of some lines of the building .csv, drawn uniformly from their
+// ranges. Realizations are simulated on all cores until the confidence interval of the mean of every metric is
+// narrower than its target, so the number of runs follows the spread of the results. The ensemble file has
+// "name value" lines (# starts a comment):
+//
+//	building		Tester1.csv			In the input folder
+//	climate			01					Weather file, without .ws3 (or with .epw or .csv for hourly files), and an
+//										optional @transform (see weather.h)
+//	transforms		future.txt			Weather transforms the climate names
+//	metric			total_kWh 10		.rc2 column and the half-width wanted (a number, or a percentage of the mean)
+//	metric			RHexcAnnual60 5%
+//	input			24 UAh 200 300		Optional: line of the .csv (from 1), name, low, high
+//	realizations	10 1000				Fewest realizations before stopping, and the most
+//	confidence		0.95				0.8, 0.9, 0.95 or 0.99
+//	seed			1
+//	start			6/21				First day simulated (day of the year or month/day); days is the last
+//	spinup			14					Most repeats of the first day to settle the starting conditions (see simulation.h)
+//	in, out, weather, shelter, days, threads: as for rc++
+//
+// The interval is the normal one, mean +/- z s / sqrt(n), so the fewest realizations should not be much below 10.
+// Realizations are taken in order whichever thread finishes first, so the stopping point and the results only
+// depend on the seed. Each realization's .rc2 (<ensemble>_<n>) is kept in the output folder and reused by a later
+// run, which picks up an interrupted ensemble where it stopped or adds realizations for a tighter target. The
+// result is printed and written to <ensemble>.ens.
+//
+// Usage: ensemble [-threads n] ensemble.txt
+
+struct ensembleMetric_struct {
+	string column;
+	double target;
+	int relative;			// 1 = target is a percentage of the mean
+	int position;			// In the .rc2
+	long count;				// Running mean and variance (Welford)
+	double mean;
+	double m2;
+};
+
+struct ensembleInput_struct {
+	int line;
+	string name;
+	double low;
+	double high;
+};
+
+struct ensemble_struct {
+	string name;
+	string building;
+	string climate;
+	vector<ensembleMetric_struct> metrics;
+	vector<ensembleInput_struct> inputs;
+	int minRealizations;
+	int maxRealizations;
+	double confidence;
+	unsigned long long seed;
+	driverSettings_struct settings;
+};
+
+// Two-sided normal quantile for the confidence levels offered, 0 for any other
+static double f_z(double confidence) {
+	const double levels[4] = { 0.8, 0.9, 0.95, 0.99 };
+	const double z[4] = { 1.2816, 1.6449, 1.9600, 2.5758 };
+	for(int i = 0; i < 4; i++) {
+		if(fabs(confidence - levels[i]) < 1e-9)
+			return z[i];
+	}
+	return 0;
+}
+
+// Returns 1 if the file cannot be opened and 2 for a bad line or an ensemble without metrics
+static int f_readEnsemble(string ensembleFile_name, ensemble_struct& ensemble) {
+	ifstream ensembleFile(ensembleFile_name);
+	if(!ensembleFile) {
+		cout << "Cannot open: " << ensembleFile_name << endl;
+		return 1;
+	}
+
+	string line;
+	while(getline(ensembleFile, line)) {
+		sub_trimLine(line);
+		istringstream fields(line);
+		string name, value;
+		if(!(fields >> name) || name[0] == '#')
+			continue;
+
+		int bad = 0;
+		if(name == "metric") {
+			ensembleMetric_struct metric;
+			bad = !(fields >> metric.column >> value);
+			metric.relative = !value.empty() && value[value.size() - 1] == '%';
+			metric.target = atof(value.c_str());
+			metric.position = -1;
+			metric.count = 0;
+			metric.mean = 0;
+			metric.m2 = 0;
+			bad = bad || metric.target <= 0;
+			ensemble.metrics.push_back(metric);
+		} else if(name == "input") {
+			ensembleInput_struct input;
+			bad = !(fields >> input.line >> input.name >> input.low >> input.high) || input.line < 1 || input.high < input.low;
+			ensemble.inputs.push_back(input);
+		} else if(name == "realizations") {
+			bad = !(fields >> ensemble.minRealizations >> ensemble.maxRealizations) || ensemble.minRealizations < 2
+				|| ensemble.maxRealizations < ensemble.minRealizations;
+		} else if(name == "seed") {
+			bad = !(fields >> ensemble.seed) || ensemble.seed == 0;
+		} else if(!(fields >> value)) {
+			bad = 1;
+		} else if(name == "building") {
+			ensemble.building = value;
+		} else if(name == "climate") {
+			ensemble.climate = value;
+		} else if(name == "confidence") {
+			ensemble.confidence = atof(value.c_str());
+			bad = f_z(ensemble.confidence) == 0;
+		} else if(name == "schedules" || name == "schednum") {
+			bad = 1;								// Every realization generates its own fan schedules
+		} else if(!f_driverSetting(ensemble.settings, name, value, bad)) {
+			bad = 1;
+		}
+
+		if(bad) {
+			cout << "Bad line in " << ensembleFile_name << ": " << line << endl;
+			return 2;
+		}
+	}
+
+	if(ensemble.metrics.empty() || ensemble.building.empty() || ensemble.climate.empty()) {
+		cout << "An ensemble needs a building, a climate and at least one metric: " << ensembleFile_name << endl;
+		return 2;
+	}
+	return 0;
+}
+
+static string f_realizationName(ensemble_struct& ensemble, int realization) {
+	ostringstream name;
+	name << ensemble.name << "_" << setw(5) << setfill('0') << realization;
+	return name.str();
+}
+
+// Building text of a realization: its own draw on each input line, made from the seed alone (see schedule.h), and
+// the other lines as they are
+static string f_buildingText(ensemble_struct& ensemble, vector<string>& lines, int realization) {
+	vector<int> lineNumbers;
+	vector<double> values;
+	for(size_t i = 0; i < ensemble.inputs.size(); i++) {
+		unsigned long long draw = f_mix(ensemble.seed ^ f_mix(((unsigned long long) realization << 16) | (unsigned long long) i));
+		double u = (draw >> 11) * (1.0 / 9007199254740992.0);		// 53 bits in [0, 1)
+		ensembleInput_struct& input = ensemble.inputs[i];
+		lineNumbers.push_back(input.line);
+		values.push_back(input.low + (input.high - input.low) * u);
+	}
+	return f_buildingText(lines, lineNumbers, values);
+}
+
+// What the realizations were simulated for, kept in <ensemble>.rlz so that a later run does not reuse .rc2 files
+// of a different ensemble or of another version of the building file. The metrics, confidence and number of
+// realizations can change between runs.
+static string f_realizationHeader(ensemble_struct& ensemble) {
+	vector<string> buildingFile(1, ensemble.settings.inPath + ensemble.building);
+	ostringstream header;
+	header << "building\t" << ensemble.building << ":" << f_filesHash(buildingFile) << "\tclimate\t" << ensemble.climate << "\tdays\t" << ensemble.settings.startDay << "-" << ensemble.settings.totaldays
+		<< "\tspinup\t" << ensemble.settings.spinupDays << "\tseed\t" << ensemble.seed;
+	for(size_t i = 0; i < ensemble.inputs.size(); i++)
+		header << "\t" << ensemble.inputs[i].line << ":" << ensemble.inputs[i].name << ":" << ensemble.inputs[i].low << ":" << ensemble.inputs[i].high;
+	return header.str();
+}
+
+// Returns 1 if the file cannot be written and 2 if it belongs to a different ensemble
+static int f_checkRealizations(ensemble_struct& ensemble) {
+	string headerFile_name = ensemble.settings.outPath + ensemble.name + ".rlz";
+	string header = f_realizationHeader(ensemble);
+
+	ifstream oldFile(headerFile_name);
+	if(oldFile) {
+		string line;
+		getline(oldFile, line);
+		if(line != header) {
+			cout << "Realizations in " << ensemble.settings.outPath << " were simulated for a different ensemble; remove "
+				<< headerFile_name << " and the .rc2 files to start again" << endl;
+			return 2;
+		}
+		return 0;
+	}
+
+	ofstream headerFile(headerFile_name);
+	if(!headerFile) {
+		cout << "Cannot open: " << headerFile_name << endl;
+		return 1;
+	}
+	headerFile << header << endl;
+	headerFile.close();
+	return headerFile.fail() ? 1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+	ensemble_struct ensemble;
+	ensemble.minRealizations = 10;
+	ensemble.maxRealizations = 1000;
+	ensemble.confidence = 0.95;
+	ensemble.seed = 1;
+	sub_defaultSettings(ensemble.settings);
+
+	int numThreads;
+	string ensembleFile_name;
+	if(f_driverArguments(argc, argv, ensembleFile_name, numThreads)) {
+		cout << "Usage: ensemble [-threads n] ensemble.txt" << endl;
+		return 2;
+	}
+
+	int error = f_readEnsemble(ensembleFile_name, ensemble);
+	if(!error)
+		error = f_finishSettings(ensemble.settings, numThreads);
+	if(error)
+		return error;
+	ensemble.name = f_studyName(ensembleFile_name);
+
+	// [START] Inputs ===================================================================================================
+	vector<string> lines;
+	if(f_readLines(ensemble.settings.inPath + ensemble.building, lines))
+		return 1;
+
+	error = f_checkRealizations(ensemble);
+	if(error)
+		return error;
+
+	string weatherFile_name = f_weatherFile_name(ensemble.settings.weatherPath, ensemble.climate);
+	vector<weatherSample_struct> weather;
+	double latitude, altitude;
+	if(f_loadWeather(weatherFile_name, ensemble.settings.startDay, weather, latitude, altitude))
+		return 1;
+
+	batch_struct batch;
+	sub_driverBatch(ensemble.settings, batch);
+	batch.fanSchedulefile_name1 = "";
+	batch.fanSchedulefile_name2 = "";
+	batch.fanSchedulefile_name3 = "";
+	batch.scheduleSeed = ensemble.seed;			// Every realization generates its own fan schedules
+	// [END] Inputs =====================================================================================================
+
+	// [START] Realizations =============================================================================================
+	sharedShelter_struct shelter;
+	driverPool_struct pool;
+	pool.start(ensemble.settings.numThreads, ensemble.maxRealizations, [&](size_t n) -> int {
+		int realization = (int) n;
+		string output_file = f_realizationName(ensemble, realization);
+		vector<string> columns;
+		vector<double> values;
+		if(f_readSummary(ensemble.settings.outPath + output_file + ".rc2", columns, values))
+			return 0;
+		string buildingText = f_buildingText(ensemble, lines, realization);
+		return f_simulateRun(batch, buildingText, ensemble.building, ensemble.climate, output_file, weather, latitude, altitude, shelter);
+	}, function<void(size_t)>());
+
+	// Results are taken in realization order, so the stopping point does not depend on which thread is quicker
+	double z = f_z(ensemble.confidence);
+	int realizations = 0;
+	int converged = 0;
+	error = 0;
+	while(realizations < ensemble.maxRealizations && !converged && !error) {
+		error = pool.f_wait(realizations);
+
+		vector<string> columns;
+		vector<double> values;
+		string rc2File_name = ensemble.settings.outPath + f_realizationName(ensemble, realizations) + ".rc2";
+		if(!error && !f_readSummary(rc2File_name, columns, values)) {
+			cout << "Cannot open: " << rc2File_name << endl;
+			error = 1;
+		}
+		for(size_t k = 0; k < ensemble.metrics.size() && !error; k++) {
+			ensembleMetric_struct& metric = ensemble.metrics[k];
+			if(metric.position < 0) {
+				for(size_t c = 0; c < columns.size(); c++) {
+					if(columns[c] == metric.column)
+						metric.position = (int) c;
+				}
+			}
+			if(metric.position < 0) {
+				cout << "No column " << metric.column << " in " << rc2File_name << endl;
+				error = 2;
+				break;
+			}
+			double x = values[metric.position];
+			metric.count++;
+			double delta = x - metric.mean;
+			metric.mean = metric.mean + delta / metric.count;
+			metric.m2 = metric.m2 + delta * (x - metric.mean);
+		}
+		if(error)
+			break;
+		realizations++;
+
+		converged = realizations >= ensemble.minRealizations;
+		for(size_t k = 0; k < ensemble.metrics.size(); k++) {
+			ensembleMetric_struct& metric = ensemble.metrics[k];
+			double halfWidth = z * sqrt(metric.m2 / (metric.count - 1 > 0 ? metric.count - 1 : 1) / metric.count);
+			double target = metric.relative ? metric.target / 100 * fabs(metric.mean) : metric.target;
+			if(halfWidth > target)
+				converged = 0;
+		}
+		if(realizations % 10 == 0 || converged)
+			cout << "Realizations: " << realizations << endl;
+	}
+
+	pool.sub_stop();
+	pool.f_finish();							// A realization past the stopping point that failed does not count
+	if(error)
+		return error;
+	// [END] Realizations ===============================================================================================
+
+	// [START] Report ===================================================================================================
+	ostringstream report;
+	report << "metric\tmean\thalfWidth\tstdDev\ttarget\tmet" << endl;
+	for(size_t k = 0; k < ensemble.metrics.size(); k++) {
+		ensembleMetric_struct& metric = ensemble.metrics[k];
+		double stdDev = sqrt(metric.m2 / (metric.count - 1 > 0 ? metric.count - 1 : 1));
+		double halfWidth = z * stdDev / sqrt((double) metric.count);
+		double target = metric.relative ? metric.target / 100 * fabs(metric.mean) : metric.target;
+		report << metric.column << "\t" << metric.mean << "\t" << halfWidth << "\t" << stdDev << "\t" << target << "\t"
+			<< (halfWidth <= target ? "yes" : "no") << endl;
+	}
+	report << "realizations\t" << realizations << "\tconfidence\t" << ensemble.confidence << "\t"
+		<< (converged ? "converged" : "stopped at the most realizations") << endl;
+
+	cout << endl << report.str();
+	string reportFile_name = ensemble.settings.outPath + ensemble.name + ".ens";
+	ofstream reportFile(reportFile_name);
+	if(!reportFile) {
+		cout << "Cannot open: " << reportFile_name << endl;
+		return 1;
+	}
+	reportFile << report.str();
+	// [END] Report =====================================================================================================
+	return 0;
+}
@@ -0,0 +1,495 @@
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include "fmi2Functions.h"
+#include "output.h"
+#include "regcap.h"
+
+using namespace std;
+
+// FMI 2.0 co-simulation interface to the house model, built as regcapfmu.dll by regcapfmu.vcxproj (it needs the
+// fmi2Functions.h, fmi2FunctionTypes.h and fmi2TypesPlatform.h headers of the FMI 2.0 standard on the include
+// path). The FMU is a zip of fmu/modelDescription.xml, the dll in binaries/win32 and a resources folder with the
+// building .csv (building.csv unless the buildingFile parameter says otherwise) and the shelter file (bshelter.dat).
+//
+// The master supplies the weather and may take over the RIVEC fan and the air handler; every output variable of
+// the .rco and .hum files (see output.h) can be read. Time is in seconds from the start of the year, so the day
+// of the year follows from it. The model steps a minute at a time, so a communication step may be any length: the
+// inputs are held over it and it ends on the last whole minute at or before its end. State get/set uses
+// regcap_clone(), a copy of the simulation state, which makes rollback cheap; serialised states are not supported.
+//
+// Value references (fmudesc.cpp writes the outputs of fmu/modelDescription.xml from the output registry; keep the
+// rest of it the same):
+//	Real		0-7		Inputs: weatherTemp [C], weatherHR [kg/kg], weatherWindSpeed [m/s], weatherDirection [deg],
+//						weatherPressure [kPa], weatherCloud, weatherDirectSolar and weatherTotalSolar [W/m2]
+//				10-11	Parameters: latitude, altitude
+//				100+	Outputs: 100 + handle in the output registry (see output.h), by name (RH%house as RHhouse)
+//	Integer		0-1		Inputs: rivecCommand, AHcommand (-1 = the model's controls decide, 0 = off, 1 = on)
+//				10		Parameter: totaldays
+//	String		0-4		Parameters: buildingFile, shelterFile, fanSchedule1-3 (relative to the resources folder)
+
+const char* const FMU_GUID = "{7E2B4C91-3D58-4F6A-9B0E-C1A48D27F365}";
+
+enum fmuReal_enum {
+	FMU_WEATHERTEMP,
+	FMU_HROUT,
+	FMU_WINDSPEED,
+	FMU_DIRECTION,
+	FMU_PREF,
+	FMU_SC,
+	FMU_IDIRECT,
+	FMU_SOLTH,
+	FMU_LATITUDE = 10,
+	FMU_ALTITUDE,
+	FMU_OUTPUTS = 100
+};
+
+enum fmuInteger_enum {
+	FMU_RIVECCOMMAND,
+	FMU_AHCOMMAND,
+	FMU_TOTALDAYS = 10
+};
+
+const int FMU_STRINGS = 5;
+
+struct fmuInstance_struct {
+	string instanceName;
+	fmi2CallbackLogger logger;
+	fmi2ComponentEnvironment componentEnvironment;
+	int loggingOn;
+	string resources;				// Folder of the unzipped resources, ending in a separator
+	string files[FMU_STRINGS];		// buildingFile, shelterFile, fanSchedule1-3
+	double latitude;
+	double altitude;
+	int totaldays;
+
+	regcap_simulation* sim;			// Made on leaving initialisation mode
+	regcap_weather weather;			// Inputs, held over a communication step
+	int rivecCommand;
+	int AHcommand;
+	double startTime;
+	long minutes;					// Minutes simulated since startTime
+	double lastTime;				// End of the last successful step
+};
+
+// A saved state: the simulation and everything else that DoStep depends on
+struct fmuState_struct {
+	regcap_simulation* sim;
+	regcap_weather weather;
+	int rivecCommand;
+	int AHcommand;
+	long minutes;
+	double lastTime;
+};
+
+static void sub_log(fmuInstance_struct* fmu, fmi2Status status, string message) {
+	if(fmu->loggingOn || status >= fmi2Error)
+		fmu->logger(fmu->componentEnvironment, fmu->instanceName.c_str(), status, status >= fmi2Error ? "logStatusError" : "logAll", "%s", message.c_str());
+}
+
+// The folder of a file:// URI, with %xx escapes decoded
+static string f_resourceFolder(string uri) {
+	if(uri.compare(0, 7, "file://") == 0)
+		uri = uri.substr(7);
+	if(uri.size() > 2 && uri[0] == '/' && uri[2] == ':')			// file:///C:/...
+		uri = uri.substr(1);
+
+	string folder;
+	for(size_t i = 0; i < uri.size(); i++) {
+		if(uri[i] == '%' && i + 2 < uri.size()) {
+			folder += (char) strtol(uri.substr(i + 1, 2).c_str(), 0, 16);
+			i = i + 2;
+		} else {
+			folder += uri[i];
+		}
+	}
+	if(!folder.empty() && folder[folder.size() - 1] != '/' && folder[folder.size() - 1] != '\\')
+		folder = folder + "/";
+	return folder;
+}
+
+// A file parameter as a path: relative names are in the resources folder
+static string f_resourcePath(fmuInstance_struct* fmu, string fileName) {
+	if(fileName.empty() || fileName[0] == '/' || fileName[0] == '\\' || (fileName.size() > 1 && fileName[1] == ':'))
+		return fileName;
+	return fmu->resources + fileName;
+}
+
+static void sub_freeSimulation(fmuInstance_struct* fmu) {
+	regcap_finalize(fmu->sim);
+	fmu->sim = 0;
+}
+
+// Parameters and inputs back to their start values
+static void sub_defaults(fmuInstance_struct* fmu) {
+	fmu->files[0] = "building.csv";
+	fmu->files[1] = "bshelter.dat";
+	fmu->files[2] = "";
+	fmu->files[3] = "";
+	fmu->files[4] = "";
+	fmu->latitude = 38.5;
+	fmu->altitude = 0;
+	fmu->totaldays = 365;
+
+	fmu->sim = 0;
+	fmu->weather.day = 1;
+	fmu->weather.idirect = 0;
+	fmu->weather.solth = 0;
+	fmu->weather.weatherTemp = 20;
+	fmu->weather.HROUT = 0.008;
+	fmu->weather.windSpeed = 1;
+	fmu->weather.direction = 0;
+	fmu->weather.pRef = 101.325;
+	fmu->weather.sc = 0;
+	fmu->rivecCommand = -1;
+	fmu->AHcommand = -1;
+	fmu->startTime = 0;
+	fmu->minutes = 0;
+	fmu->lastTime = 0;
+}
+
+const char* fmi2GetTypesPlatform(void) {
+	return fmi2TypesPlatform;
+}
+
+const char* fmi2GetVersion(void) {
+	return fmi2Version;
+}
+
+fmi2Status fmi2SetDebugLogging(fmi2Component c, fmi2Boolean loggingOn, size_t nCategories, const fmi2String categories[]) {
+	((fmuInstance_struct*) c)->loggingOn = loggingOn;
+	return fmi2OK;
+}
+
+fmi2Component fmi2Instantiate(fmi2String instanceName, fmi2Type fmuType, fmi2String fmuGUID, fmi2String fmuResourceLocation, const fmi2CallbackFunctions* functions, fmi2Boolean visible, fmi2Boolean loggingOn) {
+	if(!functions || !functions->logger)
+		return 0;
+
+	if(fmuType != fmi2CoSimulation || !fmuGUID || string(fmuGUID) != FMU_GUID) {
+		functions->logger(functions->componentEnvironment, instanceName, fmi2Error, "logStatusError", "Only co-simulation with GUID %s is supported", FMU_GUID);
+		return 0;
+	}
+
+	fmuInstance_struct* fmu = new fmuInstance_struct();
+	fmu->instanceName = instanceName ? instanceName : "";
+	fmu->logger = functions->logger;
+	fmu->componentEnvironment = functions->componentEnvironment;
+	fmu->loggingOn = loggingOn;
+	fmu->resources = fmuResourceLocation ? f_resourceFolder(fmuResourceLocation) : "";
+	sub_defaults(fmu);
+	return fmu;
+}
+
+void fmi2FreeInstance(fmi2Component c) {
+	fmuInstance_struct* fmu = (fmuInstance_struct*) c;
+	if(!fmu)
+		return;
+	sub_freeSimulation(fmu);
+	delete fmu;
+}
+
+fmi2Status fmi2SetupExperiment(fmi2Component c, fmi2Boolean toleranceDefined, fmi2Real tolerance, fmi2Real startTime, fmi2Boolean stopTimeDefined, fmi2Real stopTime) {
+	fmuInstance_struct* fmu = (fmuInstance_struct*) c;
+	fmu->startTime = startTime;
+	fmu->lastTime = startTime;
+	return fmi2OK;
+}
+
+fmi2Status fmi2EnterInitializationMode(fmi2Component c) {
+	return fmi2OK;
+}
+
+// The simulation is made here, once the parameters are known
+fmi2Status fmi2ExitInitializationMode(fmi2Component c) {
+	fmuInstance_struct* fmu = (fmuInstance_struct*) c;
+	string buildingFile_name = f_resourcePath(fmu, fmu->files[0]);
+	ifstream buildingFile(buildingFile_name);
+	if(!buildingFile) {
+		sub_log(fmu, fmi2Error, "Cannot open: " + buildingFile_name);
+		return fmi2Error;
+	}
+	ostringstream building;
+	building << buildingFile.rdbuf();
+
+	string shelter = f_resourcePath(fmu, fmu->files[1]);
+	string schedules[3];
+	for(int i = 0; i < 3; i++)
+		schedules[i] = f_resourcePath(fmu, fmu->files[2 + i]);
+	string buildingText = building.str();
+
+	regcap_config config = {0};
+	config.building = buildingText.c_str();
+	config.shelterFile = shelter.c_str();
+	config.fanSchedule1 = schedules[0].c_str();
+	config.fanSchedule2 = schedules[1].c_str();
+	config.fanSchedule3 = schedules[2].c_str();
+	config.latitude = fmu->latitude;
+	config.altitude = fmu->altitude;
+	config.totaldays = fmu->totaldays;
+
+	sub_freeSimulation(fmu);
+	fmu->sim = regcap_create(&config);
+	if(!fmu->sim) {
+		sub_log(fmu, fmi2Error, "Cannot set up the building from " + buildingFile_name + " and " + shelter + ": " + regcap_lastError());
+		return fmi2Error;
+	}
+	return fmi2OK;
+}
+
+fmi2Status fmi2Terminate(fmi2Component c) {
+	return fmi2OK;
+}
+
+fmi2Status fmi2Reset(fmi2Component c) {
+	fmuInstance_struct* fmu = (fmuInstance_struct*) c;
+	sub_freeSimulation(fmu);
+	sub_defaults(fmu);
+	return fmi2OK;
+}
+
+fmi2Status fmi2GetReal(fmi2Component c, const fmi2ValueReference vr[], size_t nvr, fmi2Real value[]) {
+	fmuInstance_struct* fmu = (fmuInstance_struct*) c;
+	const double* output = fmu->sim ? regcap_outputs(fmu->sim) : 0;
+
+	for(size_t i = 0; i < nvr; i++) {
+		switch (vr[i]) {
+		case FMU_WEATHERTEMP:	value[i] = fmu->weather.weatherTemp;	break;
+		case FMU_HROUT:			value[i] = fmu->weather.HROUT;			break;
+		case FMU_WINDSPEED:		value[i] = fmu->weather.windSpeed;		break;
+		case FMU_DIRECTION:		value[i] = fmu->weather.direction;		break;
+		case FMU_PREF:			value[i] = fmu->weather.pRef;			break;
+		case FMU_SC:			value[i] = fmu->weather.sc;				break;
+		case FMU_IDIRECT:		value[i] = fmu->weather.idirect;		break;
+		case FMU_SOLTH:			value[i] = fmu->weather.solth;			break;
+		case FMU_LATITUDE:		value[i] = fmu->latitude;				break;
+		case FMU_ALTITUDE:		value[i] = fmu->altitude;				break;
+		default:
+			if(vr[i] < FMU_OUTPUTS || vr[i] >= (fmi2ValueReference) (FMU_OUTPUTS + f_outputCount())) {
+				sub_log(fmu, fmi2Error, "No real variable with this value reference");
+				return fmi2Error;
+			}
+			value[i] = output ? output[vr[i] - FMU_OUTPUTS] : 0;
+		}
+	}
+	return fmi2OK;
+}
+
+fmi2Status fmi2SetReal(fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2Real value[]) {
+	fmuInstance_struct* fmu = (fmuInstance_struct*) c;
+	for(size_t i = 0; i < nvr; i++) {
+		switch (vr[i]) {
+		case FMU_WEATHERTEMP:	fmu->weather.weatherTemp = value[i];		break;
+		case FMU_HROUT:			fmu->weather.HROUT = value[i];				break;
+		case FMU_WINDSPEED:		fmu->weather.windSpeed = value[i];			break;
+		case FMU_DIRECTION:		fmu->weather.direction = value[i];			break;
+		case FMU_PREF:			fmu->weather.pRef = value[i];				break;
+		case FMU_SC:			fmu->weather.sc = value[i];					break;
+		case FMU_IDIRECT:		fmu->weather.idirect = (int) value[i];		break;
+		case FMU_SOLTH:			fmu->weather.solth = (int) value[i];		break;
+		case FMU_LATITUDE:		fmu->latitude = value[i];					break;
+		case FMU_ALTITUDE:		fmu->altitude = value[i];					break;
+		default:
+			sub_log(fmu, fmi2Error, "No settable real variable with this value reference");
+			return fmi2Error;
+		}
+	}
+	return fmi2OK;
+}
+
+fmi2Status fmi2GetInteger(fmi2Component c, const fmi2ValueReference vr[], size_t nvr, fmi2Integer value[]) {
+	fmuInstance_struct* fmu = (fmuInstance_struct*) c;
+	for(size_t i = 0; i < nvr; i++) {
+		switch (vr[i]) {
+		case FMU_RIVECCOMMAND:	value[i] = fmu->rivecCommand;	break;
+		case FMU_AHCOMMAND:		value[i] = fmu->AHcommand;		break;
+		case FMU_TOTALDAYS:		value[i] = fmu->totaldays;		break;
+		default:
+			sub_log(fmu, fmi2Error, "No integer variable with this value reference");
+			return fmi2Error;
+		}
+	}
+	return fmi2OK;
+}
+
+fmi2Status fmi2SetInteger(fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2Integer value[]) {
+	fmuInstance_struct* fmu = (fmuInstance_struct*) c;
+	for(size_t i = 0; i < nvr; i++) {
+		switch (vr[i]) {
+		case FMU_RIVECCOMMAND:
+			fmu->rivecCommand = value[i] < 0 ? -1 : (value[i] > 0 ? 1 : 0);
+			break;
+		case FMU_AHCOMMAND:
+			fmu->AHcommand = value[i] < 0 ? -1 : (value[i] > 0 ? 1 : 0);
+			break;
+		case FMU_TOTALDAYS:
+			fmu->totaldays = value[i];
+			break;
+		default:
+			sub_log(fmu, fmi2Error, "No integer variable with this value reference");
+			return fmi2Error;
+		}
+	}
+	return fmi2OK;
+}
+
+fmi2Status fmi2GetBoolean(fmi2Component c, const fmi2ValueReference vr[], size_t nvr, fmi2Boolean value[]) {
+	return nvr == 0 ? fmi2OK : fmi2Error;
+}
+
+fmi2Status fmi2SetBoolean(fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2Boolean value[]) {
+	return nvr == 0 ? fmi2OK : fmi2Error;
+}
+
+fmi2Status fmi2GetString(fmi2Component c, const fmi2ValueReference vr[], size_t nvr, fmi2String value[]) {
+	fmuInstance_struct* fmu = (fmuInstance_struct*) c;
+	for(size_t i = 0; i < nvr; i++) {
+		if(vr[i] >= (fmi2ValueReference) FMU_STRINGS)
+			return fmi2Error;
+		value[i] = fmu->files[vr[i]].c_str();
+	}
+	return fmi2OK;
+}
+
+fmi2Status fmi2SetString(fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2String value[]) {
+	fmuInstance_struct* fmu = (fmuInstance_struct*) c;
+	for(size_t i = 0; i < nvr; i++) {
+		if(vr[i] >= (fmi2ValueReference) FMU_STRINGS)
+			return fmi2Error;
+		fmu->files[vr[i]] = value[i] ? value[i] : "";
+	}
+	return fmi2OK;
+}
+
+fmi2Status fmi2GetFMUstate(fmi2Component c, fmi2FMUstate* FMUstate) {
+	fmuInstance_struct* fmu = (fmuInstance_struct*) c;
+	if(!fmu->sim)
+		return fmi2Error;
+
+	fmuState_struct* state = (fmuState_struct*) *FMUstate;
+	if(state)
+		regcap_finalize(state->sim);			// The master is overwriting a state it got before
+	else
+		state = new fmuState_struct();
+
+	state->sim = regcap_clone(fmu->sim);
+	state->weather = fmu->weather;
+	state->rivecCommand = fmu->rivecCommand;
+	state->AHcommand = fmu->AHcommand;
+	state->minutes = fmu->minutes;
+	state->lastTime = fmu->lastTime;
+	*FMUstate = state;
+	return fmi2OK;
+}
+
+// The state is copied, not taken, so the master can go back to it again
+fmi2Status fmi2SetFMUstate(fmi2Component c, fmi2FMUstate FMUstate) {
+	fmuInstance_struct* fmu = (fmuInstance_struct*) c;
+	fmuState_struct* state = (fmuState_struct*) FMUstate;
+	if(!state)
+		return fmi2Error;
+
+	sub_freeSimulation(fmu);
+	fmu->sim = regcap_clone(state->sim);
+	fmu->weather = state->weather;
+	fmu->rivecCommand = state->rivecCommand;
+	fmu->AHcommand = state->AHcommand;
+	fmu->minutes = state->minutes;
+	fmu->lastTime = state->lastTime;
+	return fmi2OK;
+}
+
+fmi2Status fmi2FreeFMUstate(fmi2Component c, fmi2FMUstate* FMUstate) {
+	fmuState_struct* state = (fmuState_struct*) *FMUstate;
+	if(state) {
+		regcap_finalize(state->sim);
+		delete state;
+	}
+	*FMUstate = 0;
+	return fmi2OK;
+}
+
+fmi2Status fmi2SerializedFMUstateSize(fmi2Component c, fmi2FMUstate FMUstate, size_t* size) {
+	sub_log((fmuInstance_struct*) c, fmi2Error, "Serialised states are not supported");
+	return fmi2Error;
+}
+
+fmi2Status fmi2SerializeFMUstate(fmi2Component c, fmi2FMUstate FMUstate, fmi2Byte serializedState[], size_t size) {
+	sub_log((fmuInstance_struct*) c, fmi2Error, "Serialised states are not supported");
+	return fmi2Error;
+}
+
+fmi2Status fmi2DeSerializeFMUstate(fmi2Component c, const fmi2Byte serializedState[], size_t size, fmi2FMUstate* FMUstate) {
+	sub_log((fmuInstance_struct*) c, fmi2Error, "Serialised states are not supported");
+	return fmi2Error;
+}
+
+fmi2Status fmi2GetDirectionalDerivative(fmi2Component c, const fmi2ValueReference vUnknown_ref[], size_t nUnknown, const fmi2ValueReference vKnown_ref[], size_t nKnown, const fmi2Real dvKnown[], fmi2Real dvUnknown[]) {
+	sub_log((fmuInstance_struct*) c, fmi2Error, "Directional derivatives are not supported");
+	return fmi2Error;
+}
+
+fmi2Status fmi2SetRealInputDerivatives(fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2Integer order[], const fmi2Real value[]) {
+	sub_log((fmuInstance_struct*) c, fmi2Error, "Input derivatives are not supported");
+	return fmi2Error;
+}
+
+fmi2Status fmi2GetRealOutputDerivatives(fmi2Component c, const fmi2ValueReference vr[], size_t nvr, const fmi2Integer order[], fmi2Real value[]) {
+	sub_log((fmuInstance_struct*) c, fmi2Error, "Output derivatives are not supported");
+	return fmi2Error;
+}
+
+// Steps every minute that starts before the end of the communication step. Returns fmi2Discard if the simulation
+// reaches totaldays first; the outputs are then those of its last minute.
+fmi2Status fmi2DoStep(fmi2Component c, fmi2Real currentCommunicationPoint, fmi2Real communicationStepSize, fmi2Boolean noSetFMUStatePriorToCurrentPoint) {
+	fmuInstance_struct* fmu = (fmuInstance_struct*) c;
+	if(!fmu->sim)
+		return fmi2Error;
+
+	double endTime = currentCommunicationPoint + communicationStepSize;
+	long endMinute = (long) ((endTime - fmu->startTime) / 60 + 1e-6);		// Rounding must not lose a whole minute
+
+	regcap_setRivec(fmu->sim, fmu->rivecCommand);
+	regcap_setAH(fmu->sim, fmu->AHcommand);
+
+	while(fmu->minutes < endMinute) {
+		fmu->weather.day = 1 + (int) ((fmu->startTime + fmu->minutes * 60.0) / 86400);
+		if(regcap_step(fmu->sim, &fmu->weather, 1) == 0) {
+			sub_log(fmu, fmi2Warning, "The simulation has reached totaldays");
+			return fmi2Discard;
+		}
+		fmu->minutes++;
+	}
+	fmu->lastTime = endTime;
+	return fmi2OK;
+}
+
+fmi2Status fmi2CancelStep(fmi2Component c) {
+	return fmi2Error;			// Steps are never asynchronous
+}
+
+fmi2Status fmi2GetStatus(fmi2Component c, const fmi2StatusKind s, fmi2Status* value) {
+	return fmi2Discard;
+}
+
+fmi2Status fmi2GetRealStatus(fmi2Component c, const fmi2StatusKind s, fmi2Real* value) {
+	if(s != fmi2LastSuccessfulTime)
+		return fmi2Discard;
+	*value = ((fmuInstance_struct*) c)->lastTime;
+	return fmi2OK;
+}
+
+fmi2Status fmi2GetIntegerStatus(fmi2Component c, const fmi2StatusKind s, fmi2Integer* value) {
+	return fmi2Discard;
+}
+
+fmi2Status fmi2GetBooleanStatus(fmi2Component c, const fmi2StatusKind s, fmi2Boolean* value) {
+	if(s != fmi2Terminated)
+		return fmi2Discard;
+	*value = fmi2False;
+	return fmi2OK;
+}
+
+fmi2Status fmi2GetStringStatus(fmi2Component c, const fmi2StatusKind s, fmi2String* value) {
+	return fmi2Discard;
+}
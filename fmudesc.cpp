@@ -0,0 +1,114 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "output.h"
+
+using namespace std;
+
+// Writes the output variables of an FMU model description (fmu/modelDescription.xml) from the output registry
+// (see output.h), so that the FMU lists every registered variable with the value reference fmu.cpp gives it
+// (100 + handle). The inputs and parameters are kept as they are in the file; the output ScalarVariables and the
+// ModelStructure are written anew. Run it after registering an output variable:
+//
+// Usage: fmudesc fmu/modelDescription.xml
+//
+// Exit codes: 0 = written, 1 = the file cannot be read or written, 2 = bad command line or no ModelVariables
+
+const int FMU_OUTPUTS = 100;		// Value reference of output handle 0 (see fmu.cpp)
+
+int main(int argc, char* argv[])
+{
+	if(argc != 2) {
+		cout << "Usage: fmudesc modelDescription.xml" << endl;
+		return 2;
+	}
+	string descriptionFile_name = argv[1];
+
+	ifstream oldFile(descriptionFile_name);
+	if(!oldFile) {
+		cout << "Cannot open: " << descriptionFile_name << endl;
+		return 1;
+	}
+
+	// The file up to the end of the ModelVariables, without its outputs, and what follows the ModelStructure
+	vector<string> head, tail;
+	string line, variable;
+	int numVariables = 0;
+	int part = 0;				// 0 = before </ModelVariables>, 1 = ModelStructure, 2 = after it
+	while(getline(oldFile, line)) {
+		if(!line.empty() && line[line.size() - 1] == '\r')
+			line.erase(line.size() - 1);
+
+		if(part == 0 && line.find("</ModelVariables>") != string::npos) {
+			part = 1;
+		} else if(part == 0 && line.find("<ScalarVariable") != string::npos) {
+			variable = line;
+		} else if(part == 0 && !variable.empty()) {
+			variable = variable + "\n" + line;
+			if(line.find("</ScalarVariable>") != string::npos) {
+				if(variable.find("causality=\"output\"") == string::npos) {
+					head.push_back(variable);
+					numVariables++;
+				}
+				variable = "";
+			}
+		} else if(part == 0) {
+			head.push_back(line);
+		} else if(part == 1 && line.find("</ModelStructure>") != string::npos) {
+			part = 2;
+		} else if(part == 2) {
+			tail.push_back(line);
+		}
+	}
+	oldFile.close();
+	if(part != 2) {
+		cout << "No ModelVariables and ModelStructure in: " << descriptionFile_name << endl;
+		return 2;
+	}
+
+	ostringstream description;
+	for(size_t i = 0; i < head.size(); i++)
+		description << head[i] << "\n";
+
+	int numOutputs = f_outputCount();
+	for(int i = 0; i < numOutputs; i++) {
+		string name = f_outputName(i);
+		if(name == "RH%house")
+			name = "RHhouse";
+		description << "    <ScalarVariable name=\"" << name << "\" valueReference=\"" << FMU_OUTPUTS + i << "\" causality=\"output\" variability=\"continuous\">\n";
+		description << "      <Real/>\n";
+		description << "    </ScalarVariable>\n";
+	}
+	description << "  </ModelVariables>\n";
+	description << "  <ModelStructure>\n";
+	description << "    <Outputs>\n";
+	for(int i = 0; i < numOutputs; i++)
+		description << "      <Unknown index=\"" << numVariables + i + 1 << "\"/>\n";		// Indexes count the ScalarVariables from 1
+	description << "    </Outputs>\n";
+	description << "  </ModelStructure>\n";
+	for(size_t i = 0; i < tail.size(); i++)
+		description << tail[i] << "\n";
+
+	// Written in binary with CRLF line ends, as the file is kept
+	string text = description.str();
+	ofstream newFile(descriptionFile_name, ios::binary);
+	if(!newFile) {
+		cout << "Cannot open: " << descriptionFile_name << endl;
+		return 1;
+	}
+	for(size_t i = 0; i < text.size(); i++) {
+		if(text[i] == '\n')
+			newFile << '\r';
+		newFile << text[i];
+	}
+	newFile.close();
+	if(newFile.fail()) {
+		cout << "Cannot write: " << descriptionFile_name << endl;
+		return 1;
+	}
+
+	cout << numOutputs << " output variables written to " << descriptionFile_name << endl;
+	return 0;
+}
@@ -1,5 +1,9 @@
 #include "functions.h"
+#include "capture.h"
+#include "profiler.h"
+#include "report.h"
 #include <iomanip> // RAD: so far used only for setprecission() in cmd output
+#include <cmath>
 
 using namespace std;
 
@@ -12,48 +16,57 @@ int sgn(double sgnvar);
 
 
 // ============================= FUNCTIONS ==============================================================
-void f_CpTheta(double CP[4][4], double& windAngle, double* wallCp);
+void f_CpTheta(double CP[4][4], const double& windAngle, double* wallCp);
 
-void f_flueFlow(double& tempHouse, double& flueShelterFactor, double& dPwind, double& dPtemp, double& h, double& Pint, int& numFlues, flue_struct* flue, double& mFlue,
-	double& airDensityOUT, double& airDensityIN, double& dPflue, double& tempOut, double& Aeq, double& airTempRef, double& houseVolume, double& windPressureExp, double& Q622);
+void f_flueFlow(const double& tempHouse, const double& flueShelterFactor, const double& dPwind, const double& dPtemp, const double& h,
+	const double& Pint, const int& numFlues, const flue_struct* flue, double& mFlue, const double& airDensityOUT,
+	const double& airDensityIN, double& dPflue, const double& tempOut, const double& Aeq, const double& airTempRef,
+	const double& houseVolume, const double& windPressureExp, const double& Q622);
 
-void f_floorFlow3(double& Cfloor, double& Cpfloor, double& dPwind, double& Pint, double& C,
-	double& n, double& mFloor, double& airDensityOUT, double& airDensityIN, double& dPfloor, double& Hfloor, double& dPtemp);
+void f_floorFlow3(const double& Cfloor, const double& Cpfloor, const double& dPwind, const double& Pint, const double& C, const double& n,
+	double& mFloor, const double& airDensityOUT, const double& airDensityIN, double& dPfloor, const double& Hfloor, const double& dPtemp);
 
-void f_ceilingFlow(int& AHflag, double& R, double& X, double& Patticint, double& h, double& dPtemp,
-	double& dPwind, double& Pint, double& C, double& n, double& mCeiling, double& atticC, double& airDensityATTIC,
-	double& airDensityIN, double& dPceil, double& tempAttic, double& tempHouse, double& tempOut, double& airDensityOUT,
-	double& mSupAHoff, double& mRetAHoff, double& supC, double& supn, double& retC, double& retn, double& ceilingC);
+void f_ceilingFlow(const int& AHflag, const double& R, const double& X, const double& Patticint, const double& h, const double& dPtemp,
+	const double& dPwind, const double& Pint, const double& C, const double& n, double& mCeiling, const double& atticC,
+	const double& airDensityATTIC, const double& airDensityIN, double& dPceil, const double& tempAttic, const double& tempHouse,
+	const double& tempOut, const double& airDensityOUT, double& mSupAHoff, double& mRetAHoff, const double& supC, const double& supn,
+	const double& retC, const double& retn, const double& ceilingC);
 
-void f_neutralLevel2(double& dPtemp, double& dPwind, double* Sw, double& Pint, double* wallCp, double* Bo, double& h);
+void f_neutralLevel2(const double& dPtemp, const double& dPwind, const double* Sw, const double& Pint, const double* wallCp, double* Bo,
+	const double& h);
 
-void f_wallFlow3(double& tempHouse, double& tempOut, double& airDensityIN, double& airDensityOUT, double& Bo, double& wallCp,
-	double& n, double& Cwall, double& h, double& Pint, double& dPtemp, double& dPwind, double& Mwall,
-	double& Mwallin, double& Mwallout, double& dPwalltop, double& dPwallbottom, double& Hfloor);
+void f_wallFlow3(const double& tempHouse, const double& tempOut, const double& airDensityIN, const double& airDensityOUT, const double& Bo,
+	const double& wallCp, const double& n, const double& Cwall, const double& h, const double& Pint, const double& dPtemp,
+	const double& dPwind, double& Mwall, double& Mwallin, double& Mwallout, double& dPwalltop, double& dPwallbottom, const double& Hfloor);
 
-void f_fanFlow(fan_struct& fan, double& airDensityOUT, double& airDensityIN);
+void f_fanFlow(fan_struct& fan, const double& airDensityOUT, const double& airDensityIN);
 
-void f_pipeFlow(double& airDensityOUT, double& airDensityIN, double& CP, double& dPwind, double& dPtemp,
-	double& Pint, pipe_struct& Pipe, double& tempHouse, double& tempOut, double& airTempRef);
+void f_pipeFlow(const double& airDensityOUT, const double& airDensityIN, const double& CP, const double& dPwind, const double& dPtemp,
+	const double& Pint, pipe_struct& Pipe, const double& tempHouse, const double& tempOut, const double& airTempRef);
 
-void f_winDoorFlow(double& tempHouse, double& tempOut, double& airDensityIN, double& airDensityOUT, double& h, double& Bo,
-	double& wallCp, double& n, double& Pint, double& dPtemp, double& dPwind, winDoor_struct& winDoor);
+void f_winDoorFlow(const double& tempHouse, const double& tempOut, const double& airDensityIN, const double& airDensityOUT, const double& h,
+	const double& Bo, const double& wallCp, const double& n, const double& Pint, const double& dPtemp, const double& dPwind,
+	winDoor_struct& winDoor);
 
-void f_roofCpTheta(double* Cproof, double& windAngle, double* Cppitch, double& roofPitch);
+void f_roofCpTheta(const double* Cproof, const double& windAngle, double* Cppitch, const double& roofPitch);
 
-void f_neutralLevel3(double& dPtemp, double& dPwind, double& Patticint, double& Cpr, double& Broofo, double& roofPeakHeight);
+void f_neutralLevel3(const double& dPtemp, const double& dPwind, const double& Patticint, const double& Cpr, double& Broofo,
+	const double& roofPeakHeight);
 
-void f_roofFlow(double& tempAttic, double& tempOut, double& airDensityATTIC, double& airDensityOUT, double& Broofo, double& Cpr,
-	double& atticPressureExp, double& Croof, double& roofPeakHeight, double& Patticint, double& dPtemp, double& dPwind,
-	double& Mroof, double& Mroofin, double& Mroofout, double& dProoftop, double& dProofbottom, double& H);
+void f_roofFlow(const double& tempAttic, const double& tempOut, const double& airDensityATTIC, const double& airDensityOUT,
+	const double& Broofo, const double& Cpr, const double& atticPressureExp, const double& Croof, const double& roofPeakHeight,
+	const double& Patticint, const double& dPtemp, const double& dPwind, double& Mroof, double& Mroofin, double& Mroofout,
+	double& dProoftop, double& dProofbottom, const double& H);
 
-void f_atticVentFlow(double& airDensityOUT, double& airDensityATTIC, double& CP, double& dPwind, double& dPtemp, double& Patticint,
-	atticVent_struct& atticVent, double& tempAttic, double& tempOut, double& airTempRef);
+void f_atticVentFlow(const double& airDensityOUT, const double& airDensityATTIC, const double& CP, const double& dPwind,
+	const double& dPtemp, const double& Patticint, atticVent_struct& atticVent, const double& tempAttic, const double& tempOut,
+	const double& airTempRef);
 
-void f_soffitFlow(double& airDensityOUT, double& airDensityATTIC, double& CP, double& dPwind, double& dPtemp, double& Patticint,
-	soffit_struct& soffit, double& soffitFraction, double& atticC, double& atticPressureExp, double& tempAttic, double& tempOut, double& airTempRef);
+void f_soffitFlow(const double& airDensityOUT, const double& airDensityATTIC, const double& CP, const double& dPwind, const double& dPtemp,
+	const double& Patticint, soffit_struct& soffit, const double& soffitFraction, const double& atticC, const double& atticPressureExp,
+	const double& tempAttic, const double& tempOut, const double& airTempRef);
 
-void f_atticFanFlow(fan_struct& atticFan, double& airDensityOUT, double& airDensityATTIC);
+void f_atticFanFlow(fan_struct& atticFan, const double& airDensityOUT, const double& airDensityATTIC);
 
 // ----- MatSEqn forward declarations -----
 /*
@@ -75,106 +88,20 @@ const double deps = .00000000001;
 int MatSEqn(double A[][ArraySize], double* b, int asize, int asize2, int bsize);
 int matlu(double A[][ArraySize], int* rpvt, int* cpvt, int asize, int asize2, int& continuevar);
 int matbs(double A[][ArraySize], double* b, double* x, int* rpvt, int* cpvt, int asize);
+int MatSEqnLanes(double A[][ArraySize][MAX_LANES], double b[][MAX_LANES], const int active[], int errcode[], int lanes);
 
 //**********************************
 // Functions definitions...
 
-void sub_heat ( 
-	double& tempOut, 
-	double& airDensityRef, 
-	double& airTempRef, 
-	double& mCeiling, 
-	double& AL4, 
-	double& windSpeed, 
-	double& ssolrad, 
-	double& nsolrad, 
-	double* tempOld, 
-	double& atticVolume, 
-	double& houseVolume, 
-	double& sc, 
-	double* b, 
-	int& ERRCODE, 
-	double& TSKY, 
-	double& floorArea, 
-	double& roofPitch, 
-	double& ductLocation, 
-	double& mSupReg, 
-	double& mRetReg, 
-	double& mRetLeak, 
-	double& mSupLeak, 
-	double& mAH, 
-	double& supRval, 
-	double& retRval, 
-	double& supDiameter, 
-	double& retDiameter, 
-	double& supArea, 
-	double& retArea, 
-	double& supThickness, 
-	double& retThickness, 
-	double& supVolume, 
-	double& retVolume, 
-	double& supCp, 
-	double& retCp, 
-	double& supVel, 
-	double& retVel, 
-	double& suprho, 
-	double& retrho, 
-	double& pRef, 
-	double& HROUT, 
-	double& diffuse, 
-	double& UA, 
-	double& matticenvin, 
-	double& matticenvout, 
-	double& mHouseIN, 
-	double& mHouseOUT, 
-	double& planArea, 
-	double& mSupAHoff, 
-	double& mRetAHoff, 
-	double& solgain, 
-	double& windowS, 
-	double& windowN, 
-	double& windowWE, 
-	double& winShadingCoef, 
-	double& mFanCycler, 
-	double& roofPeakHeight, 
-	double& h, 
-	//double& Whouse,
-	double& retLength,
-	double& supLength,
-	int& roofType,
-	double& M1,
-	double& M12,
-	double& M15,
-	double& M16,
-	double& roofRval,
-	double& rceil,
-	int& AHflag, 
-	double& dtau,
-	double& mERV_AH,
-	double& ERV_SRE,
-	double& mHRV,
-	double& HRV_ASE,
-	double& mHRV_AH,
-	double& SBETA,
-	double& CBETA,
-	double& L,
-	double& dec,
-	double& Csol,
-	int& idirect,
-	double& capacityc,
-	double& capacityh,
-	double& evapcap,
-	double& internalGains,
-	int bsize,
-	double& airDensityIN,
-	double& airDensityOUT,
-	double& airDensityATTIC,
-	double& airDensitySUP,
-	double& airDensityRET,
-	int& numStories,
-	double& storyHeight
-) {
-	
+// The locals of one sub_heat call. begin() works out what holds for the whole minute (areas, masses, material
+// properties and the attic air speed); each pass of the temperature iteration then assemble()s the node balances
+// into A and state.b, they are solved in place and f_converged() compares the attic air temperature with the
+// last pass. sub_heatLanes() runs the same passes for several houses with one solve for all of them.
+struct heat_struct {
+	void begin(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather);
+	void assemble(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather);
+	int f_converged(houseState_struct& state, solver_struct& solver);
+
 	int rhoSheating;
 	int rhoWood;
 	int rhoShingles;
@@ -183,7 +110,7 @@ void sub_heat (
 	int asize;
 	int asize2;
 	
-	double incsolar[4] = {0,0,0,0};
+	double incsolar[4];
 	double A[16][ArraySize];
 	double toldcur[16];
 	//double RHOATTIC, RHOhouse, airDensitySUP, airDensityRET;
@@ -239,7 +166,12 @@ void sub_heat (
 	double Gamma;
 	double ct;
 	double tsolair;
+};
 
+void heat_struct::begin(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather) {
+	for(int i=0; i < 4; i++) {
+		incsolar[i] = 0;
+	}
 
 	// Node Identification (NOTE: The C++ array indices are one less than the node number e.g. node 1 = 0, node 2 = 1 etc.)
 	// Node 1 is the Attic Air
@@ -293,44 +225,44 @@ void sub_heat (
 	c13 = 6.5459673;
 
 	// THE FOLLOWING IS FROM ASHRAE 1989
-	if(tempOut > 273.15) {
-		pws = exp(c8 / tempOut + c9 + c10 * tempOut + c11 * tempOut * tempOut + c12 * pow(tempOut, 3) + c13 * log(tempOut));
+	if(state.tempOut > 273.15) {
+		pws = exp(c8 / state.tempOut + c9 + c10 * state.tempOut + c11 * state.tempOut * state.tempOut + c12 * pow(state.tempOut, 3) + c13 * log(state.tempOut));
 	} else {
-		pws = exp(c1 / tempOut + c2 + c3 * tempOut + c4 * tempOut * tempOut + c5 * pow(tempOut, 3) + c6 * pow(tempOut, 4) + c7 * log(tempOut));
+		pws = exp(c1 / state.tempOut + c2 + c3 * state.tempOut + c4 * state.tempOut * state.tempOut + c5 * pow(state.tempOut, 3) + c6 * pow(state.tempOut, 4) + c7 * log(state.tempOut));
 	}
 
-	PW = HROUT * pRef / (.621945 + HROUT);						// water vapor partial pressure pg 1.9 ASHRAE fundamentals 2009
+	PW = weather.HROUT * state.pRef / (.621945 + weather.HROUT);						// water vapor partial pressure pg 1.9 ASHRAE fundamentals 2009
 	PW = PW / 1000 / 3.38;										// CONVERT TO INCHES OF HG
-	TSKY = tempOut * pow((.55 + .33 * sqrt(PW)), .25);			// TSKY DEPENDS ON PW
+	state.TSKY = state.tempOut * pow((.55 + .33 * sqrt(PW)), .25);			// TSKY DEPENDS ON PW
 
 	// Surface Area of Nodes
-	A2 = planArea / 2 / cos(roofPitch * pi / 180);				// PITCHED SLOPE AREA
+	A2 = building.planArea / 2 / cos(building.roofPitch * pi / 180);				// PITCHED SLOPE AREA
 	A3 = A2;													// ALL SHEATHING SURFACES HAVE THE SAME AREA
 	A4 = A2;
 	A5 = A2;
 	
 	// the following are commented out for ConSOl becasue cement tile is flat and does not have increased surface area
-	if(roofType == 2 || roofType == 3) {
+	if(building.roofType == 2 || building.roofType == 3) {
 	    // tile roof has more surface area for convection heat transfer
 	    A3 = 1.5 * A2;
 		A5 = A3;
 	}
 
-	A6 = planArea * 1.5;							// Attic wood surface area
-	A7 = planArea;									// Ceiling
+	A6 = building.planArea * 1.5;							// Attic wood surface area
+	A7 = building.planArea;									// Ceiling
 	A8 = A7;										// Attic floor
-	A9 = planArea / 2 * tan(roofPitch * pi / 180);	// Total endwall area
+	A9 = building.planArea / 2 * tan(building.roofPitch * pi / 180);	// Total endwall area
 	A10 = A9;
-	A11 = retArea;
-	A12 = pi * retLength * retDiameter;
-	A14 = supArea;
-	A15 = pi * supLength * supDiameter;
+	A11 = building.duct.retArea;
+	A12 = pi * building.duct.retLength * building.duct.retDiameter;
+	A14 = building.duct.supArea;
+	A15 = pi * building.duct.supLength * building.duct.supDiameter;
 	
 	// surface area of inside of house minus the end walls, roof and ceiling
 	// Currently assuming two stories with heights of 2.5m and 3.0m
 	//A16 = 3 * pow(floorArea, .5) * 2 + 2.5 * pow(floorArea, .5) * 2 + 2 * floorArea;
 	//A16 = numStories * storyHeight * pow(planArea, .5) * 2 + (2 * (numStories -1)) * planArea;
-	A16 = 11 * pow(floorArea,0.5) + 2 * floorArea;	// Empirically derived relationship
+	A16 = 11 * pow(building.floorArea,0.5) + 2 * building.floorArea;	// Empirically derived relationship
 	A13 = 6 * A16;									//  Surface area of everything in the house
 	
 	// Material densities
@@ -342,11 +274,11 @@ void sub_heat (
 	// masses
 	mShingles = rhoShingles * .005 * A2;
 
-	if(roofType == 2 || roofType == 3) {
+	if(building.roofType == 2 || building.roofType == 3) {
 		mShingles = 50 * A2;
 	}
 
-	M1 = atticVolume * airDensityATTIC;				// mass of attic air
+	state.M1 = building.atticVolume * state.airDensityATTIC;				// mass of attic air
 	M2 = .5 * A2 * rhoSheating * woodThickness;		// 1/2 OF TOTAL
 
 	// OTHER 1/2 OUTSIDE SHEATHING
@@ -354,19 +286,20 @@ void sub_heat (
 	M3 = M2 + mShingles;
 	M4 = .5 * A4 * rhoSheating * woodThickness;
 	M5 = M4 + mShingles;
-	M6 = 10 * planArea;											// Wild speculation
-	M7 = .5 * 4 * planArea;										// MASS OF JOISTS DRYWALL AND INSULATION
+	M6 = 10 * building.planArea;											// Wild speculation
+	M7 = .5 * 4 * building.planArea;										// MASS OF JOISTS DRYWALL AND INSULATION
 	M8 = M7;
 	M9 = .5 * rhoWood * woodThickness * A9;
 	M10 = M9;
-	M11 = retLength * pi * (retDiameter + retThickness) * retThickness * retrho;	// retArea * retrho * retThickness
-	M12 = retVolume * airDensityRET;
+	M11 = building.duct.retLength * pi * (building.duct.retDiameter + building.duct.retThickness) * building.duct.retThickness * building.duct.retrho;	// retArea * retrho * retThickness
+	state.M12 = building.duct.retVolume * state.airDensityRET;
 
 	//  maybe not - 02/2004 need to increase house mass with furnishings and their area: say 5000kg furnishings
-	M13 = (storyHeight * pow(floorArea, .5) * 4 * 2000 * .01 + planArea * .05 * 2000);		// mass of walls (5 cm effctive thickness) + mass of slab (aso 5 cm thick)
-	M14 = supLength * pi * (supDiameter + supThickness) * supThickness * suprho;			// supArea * suprho * supThickness
-	M15 = supVolume * airDensitySUP;
-	M16 = houseVolume * airDensityIN;
+	M13 = (building.storyHeight * pow(building.floorArea, .5) * 4 * 2000 * .01 + building.planArea * .05 * 2000);		// mass of walls (5 cm effctive thickness) + mass of slab (aso 5 cm thick)
+	M13 = M13 * building.massFactor;										// 1 unless calibrated
+	M14 = building.duct.supLength * pi * (building.duct.supDiameter + building.duct.supThickness) * building.duct.supThickness * building.duct.suprho;			// supArea * suprho * supThickness
+	state.M15 = building.duct.supVolume * state.airDensitySUP;
+	state.M16 = building.houseVolume * state.airDensityIN;
 
 	// Specific heat capacities
 	CpAir = 1005.7;												// specific heat of air [j/kg K]
@@ -374,7 +307,7 @@ void sub_heat (
 	cp2 = 1210;													// CP plywood
 	cp3 = 1260;													// CP asphalt shingles
 	cp4 = cp2;
-	if(roofType == 2 || roofType == 3) {
+	if(building.roofType == 2 || building.roofType == 3) {
 		cp3 = 880;												// CP for tiles roof
 		cp5 = cp3;
 	}
@@ -384,49 +317,49 @@ void sub_heat (
 	cp8 = cp7;
 	cp9 = cp2;
 	cp10 = cp9;
-	cp11 = retCp;												// input
+	cp11 = building.duct.retCp;												// input
 	cp12 = cp1;
 	cp13 = 1300;												// combination of wood and drywall
-	cp14 = supCp;
+	cp14 = building.duct.supCp;
 	cp15 = cp1;
 	cp16 = cp1;
 
 	// Thermal conductivities (k) [W/mK]and R-values [m2K/W] and the like
 	kWood = 0.15;												// check with Iain about this
 	//kAir = 0.02624;											// Thermal conductivity of air, now as function of air temperature
-	kAir = 1.5207e-11 * pow(tempOld[15],3) - 4.8574e-8 * pow(tempOld[15],2) + 1.0184e-4 * tempOld[15] - 0.00039333;
+	kAir = 1.5207e-11 * pow(state.tempOld[15],3) - 4.8574e-8 * pow(state.tempOld[15],2) + 1.0184e-4 * state.tempOld[15] - 0.00039333;
 	muAir = 0.000018462;										// Dynamic viscosity of air (mu) [kg/ms] Make temperature dependent  (this value at 300K)
 
 
-	if(roofType == 1) {											// asphalt shingles
+	if(building.roofType == 1) {											// asphalt shingles
 		Rshingles = .078;										// ASHRAE Fundamentals 2011 pg 26.7
-	} else if(roofType == 2) {									// red clay tile
+	} else if(building.roofType == 2) {									// red clay tile
 		Rshingles = .5;
-	} else if(roofType == 3) {									// low coating clay tile
+	} else if(building.roofType == 3) {									// low coating clay tile
 		Rshingles = .5;
-	} else if(roofType == 4) {									// asphalt shingle & white coating
+	} else if(building.roofType == 4) {									// asphalt shingle & white coating
 		Rshingles = .078;
 	}
 
 	// changed to account for cathedralized attics
-	if(roofRval == 0) {
+	if(building.roofRval == 0) {
 		Rval2 = (woodThickness / kWood) + Rshingles;
 	} else {
-		Rval2 = roofRval + Rshingles;
+		Rval2 = building.roofRval + Rshingles;
 	}
 
 	Rval3 = Rval2;
 	Rval4 = Rval2;
 	Rval5 = Rval2;
-	Rval7 = rceil;												// EFFECTIVE THERMAL RESISTANCE OF CEILING
+	Rval7 = state.rceil;												// EFFECTIVE THERMAL RESISTANCE OF CEILING
 	Rval8 = Rval7;
 
 	Rval9 = 2.3;												// rvalue of insulated gable end walls
 	//Rval9 = .5;												// rvalue of uninsulated gable end walls
 
 	Rval10 = Rval9;
-	Rval11 = retRval;
-	Rval14 = supRval;
+	Rval11 = building.duct.retRval;
+	Rval14 = building.duct.supRval;
 
 	/* most of the surfaces in the attic undergo both natural and forced convection
 	the overall convection is determined by the forced and natural convection coefficients
@@ -434,658 +367,695 @@ void sub_heat (
 	and it seemed to work for him*/
 
 	// Characteristic velocity
-	u = (matticenvin - matticenvout) / airDensityATTIC / AL4 / 4.0;
+	u = (state.flow.matticenvin - state.flow.matticenvout) / state.airDensityATTIC / state.AL4 / 4.0;
 	if(u == 0)
-		u = abs(mCeiling) / 2 / airDensityATTIC / AL4 * 2 / 4.0;
+		u = abs(state.flow.mCeiling) / 2 / state.airDensityATTIC / state.AL4 * 2 / 4.0;
 	if(u == 0)
 		u = .1;
 
-	// ITERATION OF TEMPERATURES WITHIN HEAT SUBROUTINE
-	// THIS ITERATES BETWEEN ALL TEMPERATURES BEFORE RETURNING TO MAIN PROGRAM
 	heatIterations = 0;
+}
 
-	while(1) {
+void heat_struct::assemble(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather) {
+	// FF: sets to 0 all elements inside array b and A
+	for(int i=0; i < 16; i++) {
+		for(int j=0; j < 16; j++) {
+			A[i][j] = 0;
+		}
+		state.b[i] = 0;
+	}
 
-		// FF: sets to 0 all elements inside array b and A
+	heatIterations = heatIterations + 1;
+
+	if(heatIterations == 1) {
 		for(int i=0; i < 16; i++) {
-			for(int j=0; j < 16; j++) {
-				A[i][j] = 0;
-			}
-			b[i] = 0;
+			toldcur[i] = state.tempOld[i];
 		}
+	}
 
-		heatIterations = heatIterations + 1;
+	// inner north sheathing
+	Hnat2 = 3.2 * pow(abs(state.tempOld[1] - state.tempOld[0]), (1 / 3.0));
+	tfilm2 = (state.tempOld[1] + state.tempOld[0]) / 2;
+	Hforced2 = (18.192 - .0378 * tfilm2) * pow(u, .8);
+	H2 = pow((pow(Hnat2, 3) + pow(Hforced2, 3)), .333333);
+
+	// outer north sheathing
+	Hnat3 = 3.2 * pow(abs(state.tempOld[2] - state.tempOut), (1 / 3.0));
+	tfilm3 = (state.tempOld[2] + state.tempOut) / 2;
+	Hforced3 = (18.192 - .0378 * tfilm3) * pow(state.windSpeed, .8);
+	H3 = pow((pow(Hnat3, 3) + pow(Hforced3, 3)), .333333);   		// ATTIC INTERNAL CONV COEF
+
+	// inner south sheathing
+	Hnat4 = 3.2 * pow(abs(state.tempOld[3] - state.tempOld[0]), (1 / 3.0)); 	// Natural convection from Ford
+	tfilm4 = (state.tempOld[3] + state.tempOld[0]) / 2;                			// film temperature
+	Hforced4 = (18.192 - .037 * tfilm4) * pow(u, .8);    			// force convection from Ford
+	H4 = pow((pow(Hnat4, 3) + pow(Hforced4, 3)), .333333);       	// ATTIC INTERNAL CONV COEF
+
+	// outer north sheathing
+	Hnat5 = 3.2 * pow(abs(state.tempOld[4] - state.tempOut), (1 / 3.0));
+	tfilm5 = (state.tempOld[4] + state.tempOut) / 2;
+	Hforced5 = (18.192 - .0378 * tfilm5) * pow(state.windSpeed, .8);
+	H5 = pow((pow(Hnat5, 3) + pow(Hforced5, 3)), .333333);   		// ATTIC INTERNAL CONV COEF
+
+	// Wood (joists,truss,etc.)
+	Hnat6 = 3.2 * pow(abs(state.tempOld[5] - state.tempOld[0]), (1 / 3.0));
+	tfilm6 = (state.tempOld[5] + state.tempOld[0]) / 2;
+	Hforced6 = (18.192 - .0378 * (tfilm6)) * pow(u, .8);
+	H6 = pow((pow(Hnat6, 3) + pow(Hforced6, 3)), .333333);
+
+	// Underside of Ceiling
+	// modified to use fixed numbers from ASHRAE Fundamentals ch.3
+	//  on 05/18/2000
+	H7 = 6;
+	if(state.AHflag != 0) {
+		H7 = 9;
+	}
 
-		if(heatIterations == 1) {
-			for(int i=0; i < 16; i++) {
-				toldcur[i] = tempOld[i];
-			}
-		}
+	// House Mass
+	// uses ceiling heat transfer coefficient as rest for house heat transfer coefficient	
+	H13 = H7;
 
-		// inner north sheathing
-		Hnat2 = 3.2 * pow(abs(tempOld[1] - tempOld[0]), (1 / 3.0));
-		tfilm2 = (tempOld[1] + tempOld[0]) / 2;
-		Hforced2 = (18.192 - .0378 * tfilm2) * pow(u, .8);
-		H2 = pow((pow(Hnat2, 3) + pow(Hforced2, 3)), .333333);
-
-		// outer north sheathing
-		Hnat3 = 3.2 * pow(abs(tempOld[2] - tempOut), (1 / 3.0));
-		tfilm3 = (tempOld[2] + tempOut) / 2;
-		Hforced3 = (18.192 - .0378 * tfilm3) * pow(windSpeed, .8);
-		H3 = pow((pow(Hnat3, 3) + pow(Hforced3, 3)), .333333);   		// ATTIC INTERNAL CONV COEF
-
-		// inner south sheathing
-		Hnat4 = 3.2 * pow(abs(tempOld[3] - tempOld[0]), (1 / 3.0)); 	// Natural convection from Ford
-		tfilm4 = (tempOld[3] + tempOld[0]) / 2;                			// film temperature
-		Hforced4 = (18.192 - .037 * tfilm4) * pow(u, .8);    			// force convection from Ford
-		H4 = pow((pow(Hnat4, 3) + pow(Hforced4, 3)), .333333);       	// ATTIC INTERNAL CONV COEF
-
-		// outer north sheathing
-		Hnat5 = 3.2 * pow(abs(tempOld[4] - tempOut), (1 / 3.0));
-		tfilm5 = (tempOld[4] + tempOut) / 2;
-		Hforced5 = (18.192 - .0378 * tfilm5) * pow(windSpeed, .8);
-		H5 = pow((pow(Hnat5, 3) + pow(Hforced5, 3)), .333333);   		// ATTIC INTERNAL CONV COEF
-
-		// Wood (joists,truss,etc.)
-		Hnat6 = 3.2 * pow(abs(tempOld[5] - tempOld[0]), (1 / 3.0));
-		tfilm6 = (tempOld[5] + tempOld[0]) / 2;
-		Hforced6 = (18.192 - .0378 * (tfilm6)) * pow(u, .8);
-		H6 = pow((pow(Hnat6, 3) + pow(Hforced6, 3)), .333333);
-
-		// Underside of Ceiling
-		// modified to use fixed numbers from ASHRAE Fundamentals ch.3
-		//  on 05/18/2000
-		H7 = 6;
-		if(AHflag != 0) {
-			H7 = 9;
-		}
-
-		// House Mass
-		// uses ceiling heat transfer coefficient as rest for house heat transfer coefficient	
-		H13 = H7;
+	// Attic Floor
+	Hnat8 = 3.2 * pow(abs(state.tempOld[7] - state.tempOld[0]), (1 / 3.0));
+	tfilm8 = (state.tempOld[7] + state.tempOld[0]) / 2;
+	Hforced8 = (18.192 - .0378 * (tfilm8)) * pow(u, .8);
+	H8 = pow((pow(Hnat8, 3) + pow(Hforced8, 3)), .333333);
 
-		// Attic Floor
-		Hnat8 = 3.2 * pow(abs(tempOld[7] - tempOld[0]), (1 / 3.0));
-		tfilm8 = (tempOld[7] + tempOld[0]) / 2;
-		Hforced8 = (18.192 - .0378 * (tfilm8)) * pow(u, .8);
-		H8 = pow((pow(Hnat8, 3) + pow(Hforced8, 3)), .333333);
+	// Inner side of gable endwalls (lumped together)
+	Hnat9 = 3.2 * pow(abs(state.tempOld[8] - state.tempOld[0]), (1 / 3.0));
+	tfilm9 = (state.tempOld[8] + state.tempOld[0]) / 2;
+	Hforced9 = (18.192 - .037 * (tfilm9)) * pow(u, .8);
+	H9 = pow((pow(Hnat9, 3) + pow(Hforced9, 3)), .333333);
+
+	// Outer side of gable ends
+	tfilm10 = (state.tempOld[9] + state.tempOut) / 2;
+	H10 = (18.192 - .0378 * (tfilm10)) * pow(state.windSpeed, .8);
+
+	// Outer Surface of Return Ducts
+	Hnat11 = 3.2 * pow(abs(state.tempOld[10] - state.tempOld[0]), (1 / 3.0));
+	tfilm11 = (state.tempOld[10] + state.tempOld[0]) / 2;
+	Hforced11 = (18.192 - .0378 * (tfilm11)) * pow(u, .8);
+	H11 = pow((pow(Hnat11, 3) + pow(Hforced11, 3)), .333333);
+
+	// Inner Surface of Return Ducts
+	// from Holman   Nu(D) = 0.023*Re(D)^0.8*Pr(D)^0.4
+	// Note Use of HI notation
+	HI11 = .023 * kAir / building.duct.retDiameter * pow((building.duct.retDiameter * state.airDensityRET * abs(state.flow.retVel) / muAir), .8) * pow((CpAir * muAir / kAir), .4);
+
+	if(HI11 <= 0)
+		HI11 = H11;
+
+	// Outer Surface of Supply Ducts
+	Hnat14 = 3.2 * pow(abs(state.tempOld[13] - state.tempOld[0]), (1 / 3.0));
+	tfilm14 = (state.tempOld[13] + state.tempOld[0]) / 2;
+	Hforced14 = (18.192 - .0378 * (tfilm14)) * pow(u, .8);
+	H14 = pow((pow(Hnat14, 3) + pow(Hforced14, 3)), .333333);
 
-		// Inner side of gable endwalls (lumped together)
-		Hnat9 = 3.2 * pow(abs(tempOld[8] - tempOld[0]), (1 / 3.0));
-		tfilm9 = (tempOld[8] + tempOld[0]) / 2;
-		Hforced9 = (18.192 - .037 * (tfilm9)) * pow(u, .8);
-		H9 = pow((pow(Hnat9, 3) + pow(Hforced9, 3)), .333333);
+	// Inner Surface of Supply Ducts
+	// from Holman   Nu(D) = 0.023*Re(D)^0.8*Pr(D)^0.4
+	// Note Use of HI notation
+	HI14 = .023 * kAir / building.duct.supDiameter * pow((building.duct.supDiameter * state.airDensitySUP * state.flow.supVel / muAir), .8) * pow((CpAir * muAir / kAir), .4);
+	// I think that the above may be an empirical relationship
 
-		// Outer side of gable ends
-		tfilm10 = (tempOld[9] + tempOut) / 2;
-		H10 = (18.192 - .0378 * (tfilm10)) * pow(windSpeed, .8);
+	if(HI14 <= 0)
+		HI14 = H14;
+	// Radiation shape factors
+
+
+	if(building.duct.ductLocation == 1) { //  Ducts in the house
+		// convection heat transfer coefficients
 
 		// Outer Surface of Return Ducts
-		Hnat11 = 3.2 * pow(abs(tempOld[10] - tempOld[0]), (1 / 3.0));
-		tfilm11 = (tempOld[10] + tempOld[0]) / 2;
-		Hforced11 = (18.192 - .0378 * (tfilm11)) * pow(u, .8);
-		H11 = pow((pow(Hnat11, 3) + pow(Hforced11, 3)), .333333);
+		H11 = 6;
+		if(state.AHflag != 0)
+			H11 = 9;
 
 		// Inner Surface of Return Ducts
 		// from Holman   Nu(D) = 0.023*Re(D)^0.8*Pr(D)^0.4
 		// Note Use of HI notation
-		HI11 = .023 * kAir / retDiameter * pow((retDiameter * airDensityRET * abs(retVel) / muAir), .8) * pow((CpAir * muAir / kAir), .4);
-
+		HI11 = .023 * kAir / building.duct.retDiameter * pow((building.duct.retDiameter * state.airDensityRET * abs(state.flow.retVel) / muAir), .8) * pow((CpAir * muAir / kAir), .4);
+		// I think that the above may be an imperical relationship
 		if(HI11 <= 0)
 			HI11 = H11;
 
 		// Outer Surface of Supply Ducts
-		Hnat14 = 3.2 * pow(abs(tempOld[13] - tempOld[0]), (1 / 3.0));
-		tfilm14 = (tempOld[13] + tempOld[0]) / 2;
-		Hforced14 = (18.192 - .0378 * (tfilm14)) * pow(u, .8);
-		H14 = pow((pow(Hnat14, 3) + pow(Hforced14, 3)), .333333);
+		H14 = 6;
+
+		if(state.AHflag != 0)
+			H14 = 9;
 
 		// Inner Surface of Supply Ducts
 		// from Holman   Nu(D) = 0.023*Re(D)^0.8*Pr(D)^0.4
 		// Note Use of HI notation
-		HI14 = .023 * kAir / supDiameter * pow((supDiameter * airDensitySUP * supVel / muAir), .8) * pow((CpAir * muAir / kAir), .4);
+		HI14 = .023 * kAir / building.duct.supDiameter * pow((building.duct.supDiameter * state.airDensitySUP * state.flow.supVel / muAir), .8) * pow((CpAir * muAir / kAir), .4);
 		// I think that the above may be an empirical relationship
 
 		if(HI14 <= 0)
 			HI14 = H14;
 		// Radiation shape factors
 
+		// radiation heat transfer coefficients
+
+		/* Only 5 nodes (2,4,8,11,14) are involved in radiation transfer in the attic
+		The endwalls have a very small contribution to radiation exchange and are neglected.
+		The wood may or may not contribute to radiation exchange, but their geometry is
+		too complex to make any assumptions so it is excluded.
+		Assumes that the duct is suspended above the floor, completely out of the insulation
+		this will change in the future */
+
+		F8t2 = 1 / 2.0;
+		F8t4 = F8t2;
+		F2t8 = F8t2 * A8 / A2;
+		F4t8 = F2t8;
+		F2t4 = (1 - F2t8);
+		F4t2 = (1 - F4t8);
+		F4t11 = 0;
+		F4t14 = 0;
+		F2t11 = 0;
+		F2t14 = 0;
+		F14t2 = 0;
+		F14t4 = 0;
+		F11t4 = 0;
+		F11t2 = 0;
+		// Radiation Heat Transfer Coefficiencts
+		EPS1 = .9;         										// Emissivity of building materials
+		epsshingles = .9;  										// this should be a user input
+
+		// make a loop to do this
+		// North Sheathing
+		R2t4 = (1 - EPS1) / EPS1 + 1 / F2t4 + (1 - EPS1) / EPS1 * (A2 / A4);
+		R2t8 = (1 - EPS1) / EPS1 + 1 / F2t8 + (1 - EPS1) / EPS1 * (A2 / A8);
+		HR2t4 = SIGMA * (state.tempOld[1] + state.tempOld[3]) * (pow(state.tempOld[1], 2) + pow(state.tempOld[3], 2)) / R2t4;
+		HR2t8 = SIGMA * (state.tempOld[1] + state.tempOld[7]) * (pow(state.tempOld[1], 2) + pow(state.tempOld[7], 2)) / R2t8;
 
-		if(ductLocation == 1) { //  Ducts in the house
-			// convection heat transfer coefficients
-
-			// Outer Surface of Return Ducts
-			H11 = 6;
-			if(AHflag != 0)
-				H11 = 9;
-
-			// Inner Surface of Return Ducts
-			// from Holman   Nu(D) = 0.023*Re(D)^0.8*Pr(D)^0.4
-			// Note Use of HI notation
-			HI11 = .023 * kAir / retDiameter * pow((retDiameter * airDensityRET * abs(retVel) / muAir), .8) * pow((CpAir * muAir / kAir), .4);
-			// I think that the above may be an imperical relationship
-			if(HI11 <= 0)
-				HI11 = H11;
-
-			// Outer Surface of Supply Ducts
-			H14 = 6;
-
-			if(AHflag != 0)
-				H14 = 9;
-
-			// Inner Surface of Supply Ducts
-			// from Holman   Nu(D) = 0.023*Re(D)^0.8*Pr(D)^0.4
-			// Note Use of HI notation
-			HI14 = .023 * kAir / supDiameter * pow((supDiameter * airDensitySUP * supVel / muAir), .8) * pow((CpAir * muAir / kAir), .4);
-			// I think that the above may be an empirical relationship
-
-			if(HI14 <= 0)
-				HI14 = H14;
-			// Radiation shape factors
-
-			// radiation heat transfer coefficients
-
-			/* Only 5 nodes (2,4,8,11,14) are involved in radiation transfer in the attic
-			The endwalls have a very small contribution to radiation exchange and are neglected.
-			The wood may or may not contribute to radiation exchange, but their geometry is
-			too complex to make any assumptions so it is excluded.
-			Assumes that the duct is suspended above the floor, completely out of the insulation
-			this will change in the future */
-
-			F8t2 = 1 / 2.0;
-			F8t4 = F8t2;
-			F2t8 = F8t2 * A8 / A2;
-			F4t8 = F2t8;
-			F2t4 = (1 - F2t8);
-			F4t2 = (1 - F4t8);
-			F4t11 = 0;
-			F4t14 = 0;
-			F2t11 = 0;
-			F2t14 = 0;
-			F14t2 = 0;
-			F14t4 = 0;
-			F11t4 = 0;
-			F11t2 = 0;
-			// Radiation Heat Transfer Coefficiencts
-			EPS1 = .9;         										// Emissivity of building materials
-			epsshingles = .9;  										// this should be a user input
-
-			// make a loop to do this
-			// North Sheathing
-			R2t4 = (1 - EPS1) / EPS1 + 1 / F2t4 + (1 - EPS1) / EPS1 * (A2 / A4);
-			R2t8 = (1 - EPS1) / EPS1 + 1 / F2t8 + (1 - EPS1) / EPS1 * (A2 / A8);
-			HR2t4 = SIGMA * (tempOld[1] + tempOld[3]) * (pow(tempOld[1], 2) + pow(tempOld[3], 2)) / R2t4;
-			HR2t8 = SIGMA * (tempOld[1] + tempOld[7]) * (pow(tempOld[1], 2) + pow(tempOld[7], 2)) / R2t8;
-
-			// South Sheathing
-			R4t2 = (1 - EPS1) / EPS1 + 1 / F4t2 + (1 - EPS1) / EPS1 * (A4 / A2);
-			R4t8 = (1 - EPS1) / EPS1 + 1 / F4t8 + (1 - EPS1) / EPS1 * (A4 / A8);
-			HR4t2 = SIGMA * (tempOld[3] + tempOld[1]) * (pow(tempOld[3], 2) + pow(tempOld[1], 2)) / R4t2;
-			HR4t8 = SIGMA * (tempOld[3] + tempOld[7]) * (pow(tempOld[3], 2) + pow(tempOld[7], 2)) / R4t8;
-
-			// Attic Floor
-			R8t4 = (1 - EPS1) / EPS1 + 1 / F8t4 + (1 - EPS1) / EPS1 * (A8 / A4);
-			R8t2 = (1 - EPS1) / EPS1 + 1 / F8t2 + (1 - EPS1) / EPS1 * (A8 / A2);
-			HR8t4 = SIGMA * (tempOld[7] + tempOld[3]) * (pow(tempOld[7], 2) + pow(tempOld[3], 2)) / R8t4;
-			HR8t2 = SIGMA * (tempOld[7] + tempOld[1]) * (pow(tempOld[7], 2) + pow(tempOld[1], 2)) / R8t2;
+		// South Sheathing
+		R4t2 = (1 - EPS1) / EPS1 + 1 / F4t2 + (1 - EPS1) / EPS1 * (A4 / A2);
+		R4t8 = (1 - EPS1) / EPS1 + 1 / F4t8 + (1 - EPS1) / EPS1 * (A4 / A8);
+		HR4t2 = SIGMA * (state.tempOld[3] + state.tempOld[1]) * (pow(state.tempOld[3], 2) + pow(state.tempOld[1], 2)) / R4t2;
+		HR4t8 = SIGMA * (state.tempOld[3] + state.tempOld[7]) * (pow(state.tempOld[3], 2) + pow(state.tempOld[7], 2)) / R4t8;
 
-		} else {
-			// ducts in the attic
+		// Attic Floor
+		R8t4 = (1 - EPS1) / EPS1 + 1 / F8t4 + (1 - EPS1) / EPS1 * (A8 / A4);
+		R8t2 = (1 - EPS1) / EPS1 + 1 / F8t2 + (1 - EPS1) / EPS1 * (A8 / A2);
+		HR8t4 = SIGMA * (state.tempOld[7] + state.tempOld[3]) * (pow(state.tempOld[7], 2) + pow(state.tempOld[3], 2)) / R8t4;
+		HR8t2 = SIGMA * (state.tempOld[7] + state.tempOld[1]) * (pow(state.tempOld[7], 2) + pow(state.tempOld[1], 2)) / R8t2;
 
-			// 33.3% of each duct sees each sheathing surface (top third of duct)
-			F14t2 = 1 / 2.0;
-			F11t2 = F14t2;
-			F14t4 = F14t2;
-			F11t4 = F14t2;
+	} else {
+		// ducts in the attic
 
+		// 33.3% of each duct sees each sheathing surface (top third of duct)
+		F14t2 = 1 / 2.0;
+		F11t2 = F14t2;
+		F14t4 = F14t2;
+		F11t4 = F14t2;
 
-			// Remaining 50% of each duct surface sees the floor
-			// changed, the ducts don't see the floor
-			// F11t8 = 0
-			// F14t8 = F11t8
 
-			// The ducts don't see each other
-			// F11t14 = 0
-			// F14t11 = 0
+		// Remaining 50% of each duct surface sees the floor
+		// changed, the ducts don't see the floor
+		// F11t8 = 0
+		// F14t8 = F11t8
 
-			F8t14 = 0;											// F14t8 * (A14 / 3) / A8
-			F8t11 = 0;											// F11t8 * (A11 / 3) / A8
+		// The ducts don't see each other
+		// F11t14 = 0
+		// F14t11 = 0
 
-			F2t14 = F14t2 * (A14 / 3) / A2;
-			F2t11 = F11t2 * (A11 / 3) / A2;
+		F8t14 = 0;											// F14t8 * (A14 / 3) / A8
+		F8t11 = 0;											// F11t8 * (A11 / 3) / A8
 
-			F4t14 = F14t4 * (A14 / 3) / A4;
-			F4t11 = F11t4 * (A11 / 3) / A4;
+		F2t14 = F14t2 * (A14 / 3) / A2;
+		F2t11 = F11t2 * (A11 / 3) / A2;
 
-			F8t2 = 1 / 2.0;										// (1 - F8t14 - F8t11) / 2
-			F8t4 = F8t2;
+		F4t14 = F14t4 * (A14 / 3) / A4;
+		F4t11 = F11t4 * (A11 / 3) / A4;
 
-			F2t8 = F8t2 * A8 / A2;
-			F4t8 = F2t8;
-			F2t4 = (1 - F2t8 - F2t11 - F2t14);
-			F4t2 = (1 - F4t8 - F4t11 - F4t14);
+		F8t2 = 1 / 2.0;										// (1 - F8t14 - F8t11) / 2
+		F8t4 = F8t2;
 
+		F2t8 = F8t2 * A8 / A2;
+		F4t8 = F2t8;
+		F2t4 = (1 - F2t8 - F2t11 - F2t14);
+		F4t2 = (1 - F4t8 - F4t11 - F4t14);
 
-			// Radiation Heat Transfer Coefficients
-			EPS1 = .9;         									// Emissivity of building materials
-			epsshingles = .91;  								// this could be a user input
-			if(roofType == 2 || roofType == 3) {
-				epsshingles = .9;
-			}
 
-			// make a loop to do this
-			// North Sheathing
-			R2t4 = (1 - EPS1) / EPS1 + 1 / F2t4 + (1 - EPS1) / EPS1 * (A2 / A4);
-			R2t8 = (1 - EPS1) / EPS1 + 1 / F2t8 + (1 - EPS1) / EPS1 * (A2 / A8);
-			R2t11 = (1 - EPS1) / EPS1 + 1 / F2t11 + (1 - EPS1) / EPS1 * (A2 / (A11 / 3));
-			R2t14 = (1 - EPS1) / EPS1 + 1 / F2t14 + (1 - EPS1) / EPS1 * (A2 / (A14 / 3));
-
-			HR2t4 = SIGMA * (tempOld[1] + tempOld[3]) * (pow(tempOld[1], 2) + pow(tempOld[3], 2)) / R2t4;
-			HR2t8 = SIGMA * (tempOld[1] + tempOld[7]) * (pow(tempOld[1], 2) + pow(tempOld[7], 2)) / R2t8;
-			HR2t11 = SIGMA * (tempOld[1] + tempOld[10]) * (pow(tempOld[1], 2) + pow(tempOld[10], 2)) / R2t11;
-			HR2t14 = SIGMA * (tempOld[1] + tempOld[13]) * (pow(tempOld[1], 2) + pow(tempOld[13], 2)) / R2t14;
-
-			// South Sheathing
-			R4t2 = (1 - EPS1) / EPS1 + 1 / F4t2 + (1 - EPS1) / EPS1 * (A4 / A2);
-			R4t8 = (1 - EPS1) / EPS1 + 1 / F4t8 + (1 - EPS1) / EPS1 * (A4 / A8);
-			R4t11 = (1 - EPS1) / EPS1 + 1 / F4t11 + (1 - EPS1) / EPS1 * (A4 / (A11 / 3));
-			R4t14 = (1 - EPS1) / EPS1 + 1 / F4t14 + (1 - EPS1) / EPS1 * (A4 / (A14 / 3));
-
-			HR4t2 = SIGMA * (tempOld[3] + tempOld[1]) * (pow(tempOld[3], 2) + pow(tempOld[1], 2)) / R4t2;
-			HR4t8 = SIGMA * (tempOld[3] + tempOld[7]) * (pow(tempOld[3], 2) + pow(tempOld[7], 2)) / R4t8;
-			HR4t11 = SIGMA * (tempOld[3] + tempOld[10]) * (pow(tempOld[3], 2) + pow(tempOld[10], 2)) / R4t11;
-			HR4t14 = SIGMA * (tempOld[3] + tempOld[13]) * (pow(tempOld[3], 2) + pow(tempOld[13], 2)) / R4t14;
-
-			// Attic Floor
-			R8t4 = (1 - EPS1) / EPS1 + 1 / F8t4 + (1 - EPS1) / EPS1 * (A8 / A4);
-			R8t2 = (1 - EPS1) / EPS1 + 1 / F8t2 + (1 - EPS1) / EPS1 * (A8 / A2);
-			
-			HR8t4 = SIGMA * (tempOld[7] + tempOld[3]) * (pow(tempOld[7], 2) + pow(tempOld[3], 2)) / R8t4;
-			HR8t2 = SIGMA * (tempOld[7] + tempOld[1]) * (pow(tempOld[7], 2) + pow(tempOld[1], 2)) / R8t2;
-			
-			// Return Ducts (note, No radiative exchange w/ supply ducts)
-			R11t4 = (1 - EPS1) / EPS1 + 1 / F11t4 + (1 - EPS1) / EPS1 * (A11 / A4);
-			R11t2 = (1 - EPS1) / EPS1 + 1 / F11t2 + (1 - EPS1) / EPS1 * (A11 / A2);
+		// Radiation Heat Transfer Coefficients
+		EPS1 = .9;         									// Emissivity of building materials
+		epsshingles = .91;  								// this could be a user input
+		if(building.roofType == 2 || building.roofType == 3) {
+			epsshingles = .9;
+		}
 
-			HR11t4 = SIGMA * (tempOld[10] + tempOld[3]) * (pow(tempOld[10], 2) + pow(tempOld[3], 2)) / R11t4;
-			HR11t2 = SIGMA * (tempOld[10] + tempOld[1]) * (pow(tempOld[10], 2) + pow(tempOld[1], 2)) / R11t2;
+		// make a loop to do this
+		// North Sheathing
+		R2t4 = (1 - EPS1) / EPS1 + 1 / F2t4 + (1 - EPS1) / EPS1 * (A2 / A4);
+		R2t8 = (1 - EPS1) / EPS1 + 1 / F2t8 + (1 - EPS1) / EPS1 * (A2 / A8);
+		R2t11 = (1 - EPS1) / EPS1 + 1 / F2t11 + (1 - EPS1) / EPS1 * (A2 / (A11 / 3));
+		R2t14 = (1 - EPS1) / EPS1 + 1 / F2t14 + (1 - EPS1) / EPS1 * (A2 / (A14 / 3));
 
-			// Supply Ducts (note, No radiative exchange w/ return ducts)
-			R14t4 = (1 - EPS1) / EPS1 + 1 / F14t4 + (1 - EPS1) / EPS1 * (A14 / A4);
-			R14t2 = (1 - EPS1) / EPS1 + 1 / F14t2 + (1 - EPS1) / EPS1 * (A14 / A2);
+		HR2t4 = SIGMA * (state.tempOld[1] + state.tempOld[3]) * (pow(state.tempOld[1], 2) + pow(state.tempOld[3], 2)) / R2t4;
+		HR2t8 = SIGMA * (state.tempOld[1] + state.tempOld[7]) * (pow(state.tempOld[1], 2) + pow(state.tempOld[7], 2)) / R2t8;
+		HR2t11 = SIGMA * (state.tempOld[1] + state.tempOld[10]) * (pow(state.tempOld[1], 2) + pow(state.tempOld[10], 2)) / R2t11;
+		HR2t14 = SIGMA * (state.tempOld[1] + state.tempOld[13]) * (pow(state.tempOld[1], 2) + pow(state.tempOld[13], 2)) / R2t14;
 
-			HR14t4 = SIGMA * (tempOld[13] + tempOld[3]) * (pow(tempOld[13], 2) + pow(tempOld[3], 2)) / R14t4;
-			HR14t2 = SIGMA * (tempOld[13] + tempOld[1]) * (pow(tempOld[13], 2) + pow(tempOld[1], 2)) / R14t2;		
-		}
+		// South Sheathing
+		R4t2 = (1 - EPS1) / EPS1 + 1 / F4t2 + (1 - EPS1) / EPS1 * (A4 / A2);
+		R4t8 = (1 - EPS1) / EPS1 + 1 / F4t8 + (1 - EPS1) / EPS1 * (A4 / A8);
+		R4t11 = (1 - EPS1) / EPS1 + 1 / F4t11 + (1 - EPS1) / EPS1 * (A4 / (A11 / 3));
+		R4t14 = (1 - EPS1) / EPS1 + 1 / F4t14 + (1 - EPS1) / EPS1 * (A4 / (A14 / 3));
 
-		// left overs
-		// underside of ceiling
-		R7 = (1 - EPS1) / EPS1 + 1 + (1 - EPS1) / EPS1 * (A7 / A13);
+		HR4t2 = SIGMA * (state.tempOld[3] + state.tempOld[1]) * (pow(state.tempOld[3], 2) + pow(state.tempOld[1], 2)) / R4t2;
+		HR4t8 = SIGMA * (state.tempOld[3] + state.tempOld[7]) * (pow(state.tempOld[3], 2) + pow(state.tempOld[7], 2)) / R4t8;
+		HR4t11 = SIGMA * (state.tempOld[3] + state.tempOld[10]) * (pow(state.tempOld[3], 2) + pow(state.tempOld[10], 2)) / R4t11;
+		HR4t14 = SIGMA * (state.tempOld[3] + state.tempOld[13]) * (pow(state.tempOld[3], 2) + pow(state.tempOld[13], 2)) / R4t14;
 
-		// FOR RAD COEF LAST HOUSE TEMP USED AS INITIAL ESTIMATE OF CEIL TEMP
-		hr7 = SIGMA * (tempOld[6] + tempOld[12] * (pow(tempOld[6], 2) + pow(tempOld[12], 2)) / R7);
-		Beta = roofPitch;                                				// ROOF PITCH
-		FRS = (1 - sc) * (180 - Beta) / 180;      					// ROOF-SKY SHAPE FACTOR
+		// Attic Floor
+		R8t4 = (1 - EPS1) / EPS1 + 1 / F8t4 + (1 - EPS1) / EPS1 * (A8 / A4);
+		R8t2 = (1 - EPS1) / EPS1 + 1 / F8t2 + (1 - EPS1) / EPS1 * (A8 / A2);
+		
+		HR8t4 = SIGMA * (state.tempOld[7] + state.tempOld[3]) * (pow(state.tempOld[7], 2) + pow(state.tempOld[3], 2)) / R8t4;
+		HR8t2 = SIGMA * (state.tempOld[7] + state.tempOld[1]) * (pow(state.tempOld[7], 2) + pow(state.tempOld[1], 2)) / R8t2;
+		
+		// Return Ducts (note, No radiative exchange w/ supply ducts)
+		R11t4 = (1 - EPS1) / EPS1 + 1 / F11t4 + (1 - EPS1) / EPS1 * (A11 / A4);
+		R11t2 = (1 - EPS1) / EPS1 + 1 / F11t2 + (1 - EPS1) / EPS1 * (A11 / A2);
 
-		if(sc < 1) {
-			RS5 = (1 - epsshingles) / epsshingles + 1 / FRS;
-			HRS5 = SIGMA * (tempOld[4] + TSKY) * (pow(tempOld[4], 2) + pow(TSKY, 2)) / RS5;
-		} else {
-			HRS5 = 0;
-		}
-
-		FG5 = 1 - FRS;                            					// ROOF-GROUND SHAPE FACTOR
-		TGROUND = tempOut;                           					// ASSUMING GROUND AT AIR TEMP
-		RG5 = (1 - epsshingles) / epsshingles + 1 / FG5;
-		HRG5 = SIGMA * (tempOld[4] + TGROUND) * (pow(tempOld[4], 2) + pow(TGROUND, 2)) / RG5;
-
-		// asphalt shingles
-		if(roofType == 1) {
-			alpha5 = .92;
-			alpha3 = .92;
-		} else if(roofType == 2) {
-			// red clay tile - edited for ConSol to be light brown concrete
-			alpha5 = .58; 											// .67
-			alpha3 = .58; 											// .67
-		} else if(roofType == 3) {
-			// low coating clay tile
-			alpha5 = .5;
-			alpha3 = .5;
-		} else if(roofType == 4) {
-			// asphalt shingles  & white coating
-			alpha5 = .15;
-			alpha3 = .15;
-		}
+		HR11t4 = SIGMA * (state.tempOld[10] + state.tempOld[3]) * (pow(state.tempOld[10], 2) + pow(state.tempOld[3], 2)) / R11t4;
+		HR11t2 = SIGMA * (state.tempOld[10] + state.tempOld[1]) * (pow(state.tempOld[10], 2) + pow(state.tempOld[1], 2)) / R11t2;
 
-		// South Sheathing
-		if(sc < 1) {
-			RS3 = (1 - epsshingles) / epsshingles + 1 / FRS;
-			HRS3 = SIGMA * (tempOld[2] + TSKY) * (pow(tempOld[2], 2) + pow(TSKY, 2)) / RS3;
-		} else {
-			HRS3 = 0;
-		}
+		// Supply Ducts (note, No radiative exchange w/ return ducts)
+		R14t4 = (1 - EPS1) / EPS1 + 1 / F14t4 + (1 - EPS1) / EPS1 * (A14 / A4);
+		R14t2 = (1 - EPS1) / EPS1 + 1 / F14t2 + (1 - EPS1) / EPS1 * (A14 / A2);
 
-		FG3 = 1 - FRS;                            					// ROOF-GROUND SHAPE FACTOR
-		RG3 = (1 - epsshingles) / epsshingles + 1 / FG3;
-		HRG3 = SIGMA * (tempOld[2] + TGROUND) * (pow(tempOld[2], 2) + pow(TGROUND, 2)) / RG3;
-		
-		// NODE 1 IS ATTIC AIR
-		if(mCeiling >= 0) {
-			// flow from attic to house
-			A[0][0] = M1 * cp1 / dtau + H14 * A14 / 2 + H11 * A11 / 2 + H8 * A8 + H6 * A6 + mCeiling * cp1 + mSupAHoff * cp15 + mRetAHoff * cp12 + H4 * A4 + H2 * A2 + A9 * H9 - matticenvout * cp1 - mRetLeak * cp1;
-			b[0] = M1 * cp1 * tempOld[0] / dtau + matticenvin * cp1 * tempOut + mSupLeak * cp1 * toldcur[14];
-		} else {
-			// flow from house to attic
-			A[0][0] = M1 * cp1 / dtau + H14 * A14 / 2 + H11 * A11 / 2 + H8 * A8 + H6 * A6 + H4 * A4 + H2 * A2 + A9 * H9 - matticenvout * cp1 - mRetLeak * cp1;
-			b[0] = M1 * cp1 * tempOld[0] / dtau - mCeiling * cp1 * toldcur[15] - mSupAHoff * cp15 * toldcur[14] - mRetAHoff * cp12 * toldcur[11] + matticenvin * cp1 * tempOut + mSupLeak * cp15 * toldcur[14];
-		}
-
-		A[0][1] = -H2 * A2;
-		A[0][3] = -H4 * A4;
-		A[0][5] = -H6 * A6;
-		A[0][7] = -H8 * A8;
-		A[0][8] = -H9 * A9;
-		A[0][10] = -H11 * A11 / 2;
-		A[0][13] = -H14 * A14 / 2;
-
-		if(ductLocation == 1) {
-			// ducts in house
-			if(mCeiling >= 0) {
-				// flow from attic to house
-				A[0][0] = M1 * cp1 / dtau + H8 * A8 + H6 * A6 + mCeiling * cp1 + mSupAHoff * cp15 + mRetAHoff * cp12 + H4 * A4 + H2 * A2 + A9 * H9 - matticenvout * cp1 - mRetLeak * cp1;
-				b[0] = M1 * cp1 * tempOld[0] / dtau + matticenvin * cp1 * tempOut + mSupLeak * cp1 * toldcur[14];
-			} else {
-				// flow from house to attic
-				A[0][0] = M1 * cp1 / dtau + H8 * A8 + H6 * A6 + H4 * A4 + H2 * A2 + A9 * H9 - matticenvout * cp1 - mRetLeak * cp1;
-				b[0] = M1 * cp1 * tempOld[0] / dtau - mCeiling * cp1 * toldcur[15] - mSupAHoff * cp15 * toldcur[14] - mRetAHoff * cp12 * toldcur[11] + matticenvin * cp1 * tempOut + mSupLeak * cp15 * toldcur[14];
-			}
-			// no duct surface conduction losses
-			A[0][10] = 0;
-			A[0][13] = 0;
-		}
-
-
-		// NODE 2 IS INSIDE NORTH SHEATHING
-		A[1][0] = -H2 * A2;
-		A[1][1] = M2 * cp2 / dtau + H2 * A2 + A2 / Rval2 + HR2t4 * A2 + HR2t8 * A2 + HR2t11 * A2 + HR2t14 * A2;
-		b[1] = M2 * cp2 * tempOld[1] / dtau;
-		A[1][2] = -A2 / Rval2;
-		A[1][3] = -HR2t4 * A2;
-		A[1][7] = -HR2t8 * A2;
-		A[1][10] = -HR2t11 * A2;
-		A[1][13] = -HR2t14 * A2;
-
-		if(ductLocation == 1) {
-			// ducts in house
-			A[1][1] = M2 * cp2 / dtau + H2 * A2 + A2 / Rval2 + HR2t4 * A2 + HR2t8 * A2;			// + HR2t11 * A2 + HR2t14 * A2
-			b[1] = M2 * cp2 * tempOld[1] / dtau;
-			A[1][10] = 0;													// -HR2t11 * A2
-			A[1][13] = 0;													// -HR2t14 * A2
-		}
-
-		// NODE 3 IS OUTSIDE NORTH SHEATHING
-		A[2][1] = -A2 / Rval3;
-		A[2][2] = M3 * cp3 / dtau + H3 * A3 + A2 / Rval3 + HRS3 * A2 + HRG3 * A2;
-		b[2] = M3 * cp3 * tempOld[2] / dtau + H3 * A3 * tempOut + A2 * nsolrad * alpha3 + HRS3 * A2 * TSKY + HRG3 * A2 * TGROUND;
-
-		// NODE 4 IS INSIDE SOUTH SHEATHING
-		A[3][0] = -H4 * A4;
-		A[3][1] = -HR4t2 * A4;
-		A[3][3] = M4 * cp4 / dtau + H4 * A4 + A4 / Rval4 + HR4t2 * A4 + HR4t8 * A4 + HR4t11 * A4 + HR4t14 * A4;
-		b[3] = M4 * cp4 * tempOld[3] / dtau;
-		A[3][4] = -A4 / Rval4;
-		A[3][7] = -HR4t8 * A4;
-		A[3][10] = -HR4t11 * A4;
-		A[3][13] = -HR4t14 * A4;
-
-		if(ductLocation == 1) {
-			A[3][3] = M4 * cp4 / dtau + H4 * A4 + A4 / Rval4 + HR4t2 * A4 + HR4t8 * A4;			// + HR4T11 * A4 + HR4T14 * A4
-			b[3] = M4 * cp4 * tempOld[3] / dtau;
-			A[3][10] = 0;													// -HR4T11 * A4
-			A[3][13] = 0;													// -HR4T14 * A4
-		}
-
-		// NODE 5 IS OUTSIDE SOUTH SHEATHING
-		A[4][3] = -A4 / Rval5;
-		A[4][4] = M5 * cp5 / dtau + H5 * A5 + A4 / Rval5 + HRS5 * A4 + HRG5 * A4;
-		b[4] = M5 * cp5 * tempOld[4] / dtau + H5 * A5 * tempOut + A4 * ssolrad * alpha5 + HRS5 * A4 * TSKY + HRG5 * A4 * TGROUND;
-
-		// NODE 6 IS MASS OF WOOD IN ATTIC I.E. JOISTS AND TRUSSES
-		A[5][0] = -H6 * A6;
-		A[5][5] = M6 * cp6 / dtau + H6 * A6;
-		b[5] = M6 * cp6 * tempOld[5] / dtau;
-
-		// NODE  7 ON INSIDE OF CEILING
-		A[6][6] = M7 * cp7 / dtau + H7 * A7 + hr7 * A7 + A7 / Rval7;
-		b[6] = M7 * cp7 / dtau * tempOld[6];
-		A[6][7] = -A7 / Rval7;
-		A[6][15] = -H7 * A7;
-		A[6][12] = -hr7 * A7;
-
-		if(ductLocation == 1) {
-			// ducts in house
-			A[6][6] = M7 * cp7 / dtau + H7 * A7 + hr7 * A7 + A7 / Rval7;
-		}
-
-		// NODE 8 ON ATTIC FLOOR
-		A[7][0] = -H8 * A8;
-		A[7][1] = -HR8t2 * A8;
-		A[7][3] = -HR8t4 * A8;
-		A[7][6] = -A8 / Rval8;
-		A[7][7] = M8 * cp8 / dtau + H8 * A8 + HR8t2 * A8 + HR8t4 * A8 + A8 / Rval8;				// + HR8t11 * A8 + HR8t14 * A8
-		b[7] = M8 * cp8 / dtau * tempOld[7];
-
-		// NODE 9 IS INSIDE ENDWALLS THAT ARE BOTH LUMPED TOGETHER
-		A[8][0] = -H9 * A9;
-		A[8][8] = M9 * cp9 / dtau + H9 * A9 + A9 / Rval9;
-		A[8][9] = -A9 / Rval9;
-		b[8] = M9 * cp9 * tempOld[8] / dtau;
-
-		// NODE 10 IS OUTSIDE ENDWALLS THAT ARE BOTH LUMPED TOGETHER
-		A[9][8] = -A10 / Rval10;
-		A[9][9] = M10 * cp10 / dtau + H10 * A10 + A10 / Rval10;
-		b[9] = M10 * cp10 * tempOld[9] / dtau + H10 * A10 * tempOut;
-
-		// NODE 11 Exterior Return Duct Surface
-		// Remember that the fluid properties are evaluated at a constant temperature
-		// therefore, the convection on the inside of the ducts is
-		A[10][0] = -A11 * H11 / 2;
-		A[10][1] = -A11 * HR11t2 / 3;
-		A[10][3] = -A11 * HR11t4 / 3;
-		A[10][10] = M11 * cp11 / dtau + H11 * A11 / 2 + A12 / (Rval11 + 1 / HI11) + A11 / 3 * HR11t2 + A11 / 3 * HR11t4;
-		b[10] = M11 * cp11 * tempOld[10] / dtau;
-		A[10][11] = -A12 / (Rval11 + 1 / HI11);
-
-		if(ductLocation == 1) {
-			// ducts in house
-			A[10][0] = 0;
-			A[10][1] = 0;
-			A[10][3] = 0;
-			A[10][10] = M11 * cp11 / dtau + H11 * A11 + A12 / (Rval11 + 1 / HI11);
-			b[10] = M11 * cp11 * tempOld[10] / dtau;
-			A[10][15] = -A11 * H11;
-		}
-
-		// NODE 12 Air in return duct
-		A[11][10] = -A12 / (Rval11 + 1 / HI11);
-
-		if(mCeiling >= 0) {
+		HR14t4 = SIGMA * (state.tempOld[13] + state.tempOld[3]) * (pow(state.tempOld[13], 2) + pow(state.tempOld[3], 2)) / R14t4;
+		HR14t2 = SIGMA * (state.tempOld[13] + state.tempOld[1]) * (pow(state.tempOld[13], 2) + pow(state.tempOld[1], 2)) / R14t2;		
+	}
+
+	// left overs
+	// underside of ceiling
+	R7 = (1 - EPS1) / EPS1 + 1 + (1 - EPS1) / EPS1 * (A7 / A13);
+
+	// FOR RAD COEF LAST HOUSE TEMP USED AS INITIAL ESTIMATE OF CEIL TEMP
+	hr7 = SIGMA * (state.tempOld[6] + state.tempOld[12] * (pow(state.tempOld[6], 2) + pow(state.tempOld[12], 2)) / R7);
+	Beta = building.roofPitch;                                				// ROOF PITCH
+	FRS = (1 - state.sc) * (180 - Beta) / 180;      					// ROOF-SKY SHAPE FACTOR
+
+	if(state.sc < 1) {
+		RS5 = (1 - epsshingles) / epsshingles + 1 / FRS;
+		HRS5 = SIGMA * (state.tempOld[4] + state.TSKY) * (pow(state.tempOld[4], 2) + pow(state.TSKY, 2)) / RS5;
+	} else {
+		HRS5 = 0;
+	}
+
+	FG5 = 1 - FRS;                            					// ROOF-GROUND SHAPE FACTOR
+	TGROUND = state.tempOut;                           					// ASSUMING GROUND AT AIR TEMP
+	RG5 = (1 - epsshingles) / epsshingles + 1 / FG5;
+	HRG5 = SIGMA * (state.tempOld[4] + TGROUND) * (pow(state.tempOld[4], 2) + pow(TGROUND, 2)) / RG5;
+
+	// asphalt shingles
+	if(building.roofType == 1) {
+		alpha5 = .92;
+		alpha3 = .92;
+	} else if(building.roofType == 2) {
+		// red clay tile - edited for ConSol to be light brown concrete
+		alpha5 = .58; 											// .67
+		alpha3 = .58; 											// .67
+	} else if(building.roofType == 3) {
+		// low coating clay tile
+		alpha5 = .5;
+		alpha3 = .5;
+	} else if(building.roofType == 4) {
+		// asphalt shingles  & white coating
+		alpha5 = .15;
+		alpha3 = .15;
+	}
+
+	// South Sheathing
+	if(state.sc < 1) {
+		RS3 = (1 - epsshingles) / epsshingles + 1 / FRS;
+		HRS3 = SIGMA * (state.tempOld[2] + state.TSKY) * (pow(state.tempOld[2], 2) + pow(state.TSKY, 2)) / RS3;
+	} else {
+		HRS3 = 0;
+	}
+
+	FG3 = 1 - FRS;                            					// ROOF-GROUND SHAPE FACTOR
+	RG3 = (1 - epsshingles) / epsshingles + 1 / FG3;
+	HRG3 = SIGMA * (state.tempOld[2] + TGROUND) * (pow(state.tempOld[2], 2) + pow(TGROUND, 2)) / RG3;
+	
+	// NODE 1 IS ATTIC AIR
+	if(state.flow.mCeiling >= 0) {
+		// flow from attic to house
+		A[0][0] = state.M1 * cp1 / building.dtau + H14 * A14 / 2 + H11 * A11 / 2 + H8 * A8 + H6 * A6 + state.flow.mCeiling * cp1 + state.flow.mSupAHoff * cp15 + state.flow.mRetAHoff * cp12 + H4 * A4 + H2 * A2 + A9 * H9 - state.flow.matticenvout * cp1 - state.flow.mRetLeak * cp1;
+		state.b[0] = state.M1 * cp1 * state.tempOld[0] / building.dtau + state.flow.matticenvin * cp1 * state.tempOut + state.flow.mSupLeak * cp1 * toldcur[14];
+	} else {
+		// flow from house to attic
+		A[0][0] = state.M1 * cp1 / building.dtau + H14 * A14 / 2 + H11 * A11 / 2 + H8 * A8 + H6 * A6 + H4 * A4 + H2 * A2 + A9 * H9 - state.flow.matticenvout * cp1 - state.flow.mRetLeak * cp1;
+		state.b[0] = state.M1 * cp1 * state.tempOld[0] / building.dtau - state.flow.mCeiling * cp1 * toldcur[15] - state.flow.mSupAHoff * cp15 * toldcur[14] - state.flow.mRetAHoff * cp12 * toldcur[11] + state.flow.matticenvin * cp1 * state.tempOut + state.flow.mSupLeak * cp15 * toldcur[14];
+	}
+
+	A[0][1] = -H2 * A2;
+	A[0][3] = -H4 * A4;
+	A[0][5] = -H6 * A6;
+	A[0][7] = -H8 * A8;
+	A[0][8] = -H9 * A9;
+	A[0][10] = -H11 * A11 / 2;
+	A[0][13] = -H14 * A14 / 2;
+
+	if(building.duct.ductLocation == 1) {
+		// ducts in house
+		if(state.flow.mCeiling >= 0) {
 			// flow from attic to house
-			A[11][11] = M12 * cp12 / dtau + A12 / (Rval11 + 1 / HI11) + mAH * cp12 + mRetAHoff * cp12;
-			b[11] = M12 * cp12 * tempOld[11] / dtau + mRetAHoff * cp1 * toldcur[0] - mRetLeak * cp1 * toldcur[0] - mRetReg * cp1 * toldcur[15] - mFanCycler * cp1 * tempOut - mHRV_AH * cp16 * ((1 - HRV_ASE) * tempOut + HRV_ASE * tempOld[15]) - mERV_AH * cp16 * ((1-ERV_SRE) * tempOut + ERV_SRE * tempOld[15]);
-			
+			A[0][0] = state.M1 * cp1 / building.dtau + H8 * A8 + H6 * A6 + state.flow.mCeiling * cp1 + state.flow.mSupAHoff * cp15 + state.flow.mRetAHoff * cp12 + H4 * A4 + H2 * A2 + A9 * H9 - state.flow.matticenvout * cp1 - state.flow.mRetLeak * cp1;
+			state.b[0] = state.M1 * cp1 * state.tempOld[0] / building.dtau + state.flow.matticenvin * cp1 * state.tempOut + state.flow.mSupLeak * cp1 * toldcur[14];
 		} else {
 			// flow from house to attic
-			A[11][11] = M12 * cp12 / dtau + A12 / (Rval11 + 1 / HI11) + mAH * cp12 - mRetAHoff * cp12;
-			b[11] = M12 * cp12 * tempOld[11] / dtau - mRetAHoff * cp16 * toldcur[15] - mRetLeak * cp1 * toldcur[0] - mRetReg * cp1 * toldcur[15] - mFanCycler * cp1 * tempOut - mHRV_AH * cp16 * ((1 - HRV_ASE) * tempOut + HRV_ASE * tempOld[15]) - mERV_AH * cp16 * ((1-ERV_SRE) * tempOut + ERV_SRE * tempOld[15]);
+			A[0][0] = state.M1 * cp1 / building.dtau + H8 * A8 + H6 * A6 + H4 * A4 + H2 * A2 + A9 * H9 - state.flow.matticenvout * cp1 - state.flow.mRetLeak * cp1;
+			state.b[0] = state.M1 * cp1 * state.tempOld[0] / building.dtau - state.flow.mCeiling * cp1 * toldcur[15] - state.flow.mSupAHoff * cp15 * toldcur[14] - state.flow.mRetAHoff * cp12 * toldcur[11] + state.flow.matticenvin * cp1 * state.tempOut + state.flow.mSupLeak * cp15 * toldcur[14];
 		}
+		// no duct surface conduction losses
+		A[0][10] = 0;
+		A[0][13] = 0;
+	}
 
-		// node 13 is the mass of the structure of the house that interacts
 
-		// with the house air to increase its effective thermal mass
-		// August 99, 95% of solar gain goes to house mass, 5% to house air now
-		// Solar gain also calculate more carefully
+	// NODE 2 IS INSIDE NORTH SHEATHING
+	A[1][0] = -H2 * A2;
+	A[1][1] = M2 * cp2 / building.dtau + H2 * A2 + A2 / Rval2 + HR2t4 * A2 + HR2t8 * A2 + HR2t11 * A2 + HR2t14 * A2;
+	state.b[1] = M2 * cp2 * state.tempOld[1] / building.dtau;
+	A[1][2] = -A2 / Rval2;
+	A[1][3] = -HR2t4 * A2;
+	A[1][7] = -HR2t8 * A2;
+	A[1][10] = -HR2t11 * A2;
+	A[1][13] = -HR2t14 * A2;
+
+	if(building.duct.ductLocation == 1) {
+		// ducts in house
+		A[1][1] = M2 * cp2 / building.dtau + H2 * A2 + A2 / Rval2 + HR2t4 * A2 + HR2t8 * A2;			// + HR2t11 * A2 + HR2t14 * A2
+		state.b[1] = M2 * cp2 * state.tempOld[1] / building.dtau;
+		A[1][10] = 0;													// -HR2t11 * A2
+		A[1][13] = 0;													// -HR2t14 * A2
+	}
 
-		for(int i=0; i < 4; i++) {
-			S = ((i+1) - 1) * pi / 2;
-			cphi = (SBETA * sin(L) - sin(dec)) / CBETA / cos(L);
-			cphi2 = pow(cphi, 2);
+	// NODE 3 IS OUTSIDE NORTH SHEATHING
+	A[2][1] = -A2 / Rval3;
+	A[2][2] = M3 * cp3 / building.dtau + H3 * A3 + A2 / Rval3 + HRS3 * A2 + HRG3 * A2;
+	state.b[2] = M3 * cp3 * state.tempOld[2] / building.dtau + H3 * A3 * state.tempOut + A2 * state.nsolrad * alpha3 + HRS3 * A2 * state.TSKY + HRG3 * A2 * TGROUND;
+
+	// NODE 4 IS INSIDE SOUTH SHEATHING
+	A[3][0] = -H4 * A4;
+	A[3][1] = -HR4t2 * A4;
+	A[3][3] = M4 * cp4 / building.dtau + H4 * A4 + A4 / Rval4 + HR4t2 * A4 + HR4t8 * A4 + HR4t11 * A4 + HR4t14 * A4;
+	state.b[3] = M4 * cp4 * state.tempOld[3] / building.dtau;
+	A[3][4] = -A4 / Rval4;
+	A[3][7] = -HR4t8 * A4;
+	A[3][10] = -HR4t11 * A4;
+	A[3][13] = -HR4t14 * A4;
+
+	if(building.duct.ductLocation == 1) {
+		A[3][3] = M4 * cp4 / building.dtau + H4 * A4 + A4 / Rval4 + HR4t2 * A4 + HR4t8 * A4;			// + HR4T11 * A4 + HR4T14 * A4
+		state.b[3] = M4 * cp4 * state.tempOld[3] / building.dtau;
+		A[3][10] = 0;													// -HR4T11 * A4
+		A[3][13] = 0;													// -HR4T14 * A4
+	}
 
-			if(cphi == 1) {
-				sphi = sqrt(1 - cphi2);
-			} else {
-				sphi = 0;
-			}
+	// NODE 5 IS OUTSIDE SOUTH SHEATHING
+	A[4][3] = -A4 / Rval5;
+	A[4][4] = M5 * cp5 / building.dtau + H5 * A5 + A4 / Rval5 + HRS5 * A4 + HRG5 * A4;
+	state.b[4] = M5 * cp5 * state.tempOld[4] / building.dtau + H5 * A5 * state.tempOut + A4 * state.ssolrad * alpha5 + HRS5 * A4 * state.TSKY + HRG5 * A4 * TGROUND;
+
+	// NODE 6 IS MASS OF WOOD IN ATTIC I.E. JOISTS AND TRUSSES
+	A[5][0] = -H6 * A6;
+	A[5][5] = M6 * cp6 / building.dtau + H6 * A6;
+	state.b[5] = M6 * cp6 * state.tempOld[5] / building.dtau;
+
+	// NODE  7 ON INSIDE OF CEILING
+	A[6][6] = M7 * cp7 / building.dtau + H7 * A7 + hr7 * A7 + A7 / Rval7;
+	state.b[6] = M7 * cp7 / building.dtau * state.tempOld[6];
+	A[6][7] = -A7 / Rval7;
+	A[6][15] = -H7 * A7;
+	A[6][12] = -hr7 * A7;
+
+	if(building.duct.ductLocation == 1) {
+		// ducts in house
+		A[6][6] = M7 * cp7 / building.dtau + H7 * A7 + hr7 * A7 + A7 / Rval7;
+	}
 
-			if(cphi == 0) {
-				if(sphi > 0) {
-					phi = pi / 2;
-				} else {
-					phi = -pi / 2;
-				}
-			} else if(cphi == 1) {
-				phi = 0;
-			} else {
-				phi = atan(sphi / cphi);
-			}
+	// NODE 8 ON ATTIC FLOOR
+	A[7][0] = -H8 * A8;
+	A[7][1] = -HR8t2 * A8;
+	A[7][3] = -HR8t4 * A8;
+	A[7][6] = -A8 / Rval8;
+	A[7][7] = M8 * cp8 / building.dtau + H8 * A8 + HR8t2 * A8 + HR8t4 * A8 + A8 / Rval8;				// + HR8t11 * A8 + HR8t14 * A8
+	state.b[7] = M8 * cp8 / building.dtau * state.tempOld[7];
+
+	// NODE 9 IS INSIDE ENDWALLS THAT ARE BOTH LUMPED TOGETHER
+	A[8][0] = -H9 * A9;
+	A[8][8] = M9 * cp9 / building.dtau + H9 * A9 + A9 / Rval9;
+	A[8][9] = -A9 / Rval9;
+	state.b[8] = M9 * cp9 * state.tempOld[8] / building.dtau;
+
+	// NODE 10 IS OUTSIDE ENDWALLS THAT ARE BOTH LUMPED TOGETHER
+	A[9][8] = -A10 / Rval10;
+	A[9][9] = M10 * cp10 / building.dtau + H10 * A10 + A10 / Rval10;
+	state.b[9] = M10 * cp10 * state.tempOld[9] / building.dtau + H10 * A10 * state.tempOut;
+
+	// NODE 11 Exterior Return Duct Surface
+	// Remember that the fluid properties are evaluated at a constant temperature
+	// therefore, the convection on the inside of the ducts is
+	A[10][0] = -A11 * H11 / 2;
+	A[10][1] = -A11 * HR11t2 / 3;
+	A[10][3] = -A11 * HR11t4 / 3;
+	A[10][10] = M11 * cp11 / building.dtau + H11 * A11 / 2 + A12 / (Rval11 + 1 / HI11) + A11 / 3 * HR11t2 + A11 / 3 * HR11t4;
+	state.b[10] = M11 * cp11 * state.tempOld[10] / building.dtau;
+	A[10][11] = -A12 / (Rval11 + 1 / HI11);
+
+	if(building.duct.ductLocation == 1) {
+		// ducts in house
+		A[10][0] = 0;
+		A[10][1] = 0;
+		A[10][3] = 0;
+		A[10][10] = M11 * cp11 / building.dtau + H11 * A11 + A12 / (Rval11 + 1 / HI11);
+		state.b[10] = M11 * cp11 * state.tempOld[10] / building.dtau;
+		A[10][15] = -A11 * H11;
+	}
+
+	// NODE 12 Air in return duct
+	A[11][10] = -A12 / (Rval11 + 1 / HI11);
+
+	if(state.flow.mCeiling >= 0) {
+		// flow from attic to house
+		A[11][11] = state.M12 * cp12 / building.dtau + A12 / (Rval11 + 1 / HI11) + state.flow.mAH * cp12 + state.flow.mRetAHoff * cp12;
+		state.b[11] = state.M12 * cp12 * state.tempOld[11] / building.dtau + state.flow.mRetAHoff * cp1 * toldcur[0] - state.flow.mRetLeak * cp1 * toldcur[0] - state.flow.mRetReg * cp1 * toldcur[15] - state.flow.mFanCycler * cp1 * state.tempOut - state.flow.mHRV_AH * cp16 * ((1 - building.HRV_ASE) * state.tempOut + building.HRV_ASE * state.tempOld[15]) - state.flow.mERV_AH * cp16 * ((1-building.ERV_SRE) * state.tempOut + building.ERV_SRE * state.tempOld[15]);
+		
+	} else {
+		// flow from house to attic
+		A[11][11] = state.M12 * cp12 / building.dtau + A12 / (Rval11 + 1 / HI11) + state.flow.mAH * cp12 - state.flow.mRetAHoff * cp12;
+		state.b[11] = state.M12 * cp12 * state.tempOld[11] / building.dtau - state.flow.mRetAHoff * cp16 * toldcur[15] - state.flow.mRetLeak * cp1 * toldcur[0] - state.flow.mRetReg * cp1 * toldcur[15] - state.flow.mFanCycler * cp1 * state.tempOut - state.flow.mHRV_AH * cp16 * ((1 - building.HRV_ASE) * state.tempOut + building.HRV_ASE * state.tempOld[15]) - state.flow.mERV_AH * cp16 * ((1-building.ERV_SRE) * state.tempOut + building.ERV_SRE * state.tempOld[15]);
+	}
+
+	// node 13 is the mass of the structure of the house that interacts
 
-			Gamma = phi - S;
-			ct = CBETA * cos(Gamma);
+	// with the house air to increase its effective thermal mass
+	// August 99, 95% of solar gain goes to house mass, 5% to house air now
+	// Solar gain also calculate more carefully
 
-			if(ct <= -.2) {
-				incsolar[i] = Csol * idirect * .45;
+	for(int i=0; i < 4; i++) {
+		S = ((i+1) - 1) * pi / 2;
+		cphi = (state.SBETA * sin(building.L) - sin(state.dec)) / state.CBETA / cos(building.L);
+		cphi2 = pow(cphi, 2);
+
+		if(cphi == 1) {
+			sphi = sqrt(1 - cphi2);
+		} else {
+			sphi = 0;
+		}
+
+		if(cphi == 0) {
+			if(sphi > 0) {
+				phi = pi / 2;
 			} else {
-				incsolar[i] = Csol * idirect * (.55 + .437 * CBETA + .313 * pow(CBETA, 2));
+				phi = -pi / 2;
 			}
+		} else if(cphi == 1) {
+			phi = 0;
+		} else {
+			phi = atan(sphi / cphi);
 		}
 
-		incsolarS = incsolar[0];
-		incsolarW = incsolar[1];
-		incsolarN = incsolar[2];
-		incsolarE = incsolar[3];
+		Gamma = phi - S;
+		ct = state.CBETA * cos(Gamma);
 
-		solgain = winShadingCoef * (windowS * incsolarS + windowWE / 2 * incsolarW + windowN * incsolarN + windowWE / 2 * incsolarE);
-
-		// incident solar radiations averaged for solair temperature
-		incsolarvar = (incsolarN + incsolarS + incsolarE + incsolarW) / 4;
-		
-		A[12][12] = M13 * cp13 / dtau + H13 * A13 + hr7 * A7;
-		A[12][15] = -H13 * A13;
-		A[12][6] = -hr7 * A7;
-		b[12] = M13 * cp13 * tempOld[12] / dtau + .95 * solgain;
-
-		// NODE 14
-		A[13][0] = -A14 * H14 / 2;
-		A[13][1] = -A14 * HR14t2 / 3;
-		A[13][3] = -A14 * HR14t4 / 3;
-		A[13][13] = M14 * cp14 / dtau + H14 * A14 / 2 + A15 / (Rval14 + 1 / HI14) + A14 * HR14t2 / 3 + A14 / 3 * HR14t4;
-		b[13] = M14 * cp14 * tempOld[13] / dtau;
-		A[13][14] = -A15 / (Rval14 + 1 / HI14);
-		if(ductLocation == 1) {
-			// ducts in house
-			A[13][0] = 0;					// -A14 * H14 / 2
-			A[13][1] = 0;					// -A14 * HR14t2
-			A[13][3] = 0;					// -A14 * HR14t4
-			A[13][13] = M14 * cp14 / dtau + H14 * A14 + A15 / (Rval14 + 1 / HI14);
-			A[13][15] = -A14 * H14;
-		}
-
-		// NODE 15 Air in SUPPLY duct
-		// capacity is AC unit capcity in Watts
-		// this is a sensible heat balance, the moisture is balanced in a separate routine.
-
-		A[14][13] = -A15 / (Rval14 + 1 / HI14);
-
-		if(mCeiling >= 0) {
-			// flow from attic to house
-			A[14][14] = M15 * cp15 / dtau + A15 / (Rval14 + 1 / HI14) + mSupReg * cp15 + mSupLeak * cp15 + mSupAHoff * cp15;
-			b[14] = M15 * cp15 * tempOld[14] / dtau - capacityc + capacityh + evapcap + mAH * cp12 * toldcur[11] + mSupAHoff * cp1 * toldcur[0];
+		if(ct <= -.2) {
+			incsolar[i] = state.Csol * weather.idirect * .45;
 		} else {
-			// flow from house to attic
-			A[14][14] = M15 * cp15 / dtau + A15 / (Rval14 + 1 / HI14) + mSupReg * cp15 + mSupLeak * cp15 - mSupAHoff * cp15;
-			b[14] = M15 * cp15 * tempOld[14] / dtau - capacityc + capacityh + evapcap + mAH * cp12 * toldcur[11] - mSupAHoff * cp16 * toldcur[15];
+			incsolar[i] = state.Csol * weather.idirect * (.55 + .437 * state.CBETA + .313 * pow(state.CBETA, 2));
 		}
+	}
+
+	incsolarS = incsolar[0];
+	incsolarW = incsolar[1];
+	incsolarN = incsolar[2];
+	incsolarE = incsolar[3];
 
-		// NODE 16 AIR IN HOUSE
-		// use solair tmeperature for house UA
-		// the .03 is from 1993 AHSRAE Fund. SI 26.5
-		tsolair = incsolarvar * .03 + tempOut;
+	state.solgain = building.winShadingCoef * (building.windowS * incsolarS + building.windowWE / 2 * incsolarW + building.windowN * incsolarN + building.windowWE / 2 * incsolarE);
 
-		if(mCeiling >= 0) {
+	// incident solar radiations averaged for solair temperature
+	incsolarvar = (incsolarN + incsolarS + incsolarE + incsolarW) / 4;
+	
+	A[12][12] = M13 * cp13 / building.dtau + H13 * A13 + hr7 * A7;
+	A[12][15] = -H13 * A13;
+	A[12][6] = -hr7 * A7;
+	state.b[12] = M13 * cp13 * state.tempOld[12] / building.dtau + .95 * state.solgain;
+
+	// NODE 14
+	A[13][0] = -A14 * H14 / 2;
+	A[13][1] = -A14 * HR14t2 / 3;
+	A[13][3] = -A14 * HR14t4 / 3;
+	A[13][13] = M14 * cp14 / building.dtau + H14 * A14 / 2 + A15 / (Rval14 + 1 / HI14) + A14 * HR14t2 / 3 + A14 / 3 * HR14t4;
+	state.b[13] = M14 * cp14 * state.tempOld[13] / building.dtau;
+	A[13][14] = -A15 / (Rval14 + 1 / HI14);
+	if(building.duct.ductLocation == 1) {
+		// ducts in house
+		A[13][0] = 0;					// -A14 * H14 / 2
+		A[13][1] = 0;					// -A14 * HR14t2
+		A[13][3] = 0;					// -A14 * HR14t4
+		A[13][13] = M14 * cp14 / building.dtau + H14 * A14 + A15 / (Rval14 + 1 / HI14);
+		A[13][15] = -A14 * H14;
+	}
+
+	// NODE 15 Air in SUPPLY duct
+	// capacity is AC unit capcity in Watts
+	// this is a sensible heat balance, the moisture is balanced in a separate routine.
+
+	A[14][13] = -A15 / (Rval14 + 1 / HI14);
+
+	if(state.flow.mCeiling >= 0) {
+		// flow from attic to house
+		A[14][14] = state.M15 * cp15 / building.dtau + A15 / (Rval14 + 1 / HI14) + state.flow.mSupReg * cp15 + state.flow.mSupLeak * cp15 + state.flow.mSupAHoff * cp15;
+		state.b[14] = state.M15 * cp15 * state.tempOld[14] / building.dtau - state.equip.capacityc + state.equip.capacityh + state.equip.evapcap + state.flow.mAH * cp12 * toldcur[11] + state.flow.mSupAHoff * cp1 * toldcur[0];
+	} else {
+		// flow from house to attic
+		A[14][14] = state.M15 * cp15 / building.dtau + A15 / (Rval14 + 1 / HI14) + state.flow.mSupReg * cp15 + state.flow.mSupLeak * cp15 - state.flow.mSupAHoff * cp15;
+		state.b[14] = state.M15 * cp15 * state.tempOld[14] / building.dtau - state.equip.capacityc + state.equip.capacityh + state.equip.evapcap + state.flow.mAH * cp12 * toldcur[11] - state.flow.mSupAHoff * cp16 * toldcur[15];
+	}
+
+	// NODE 16 AIR IN HOUSE
+	// use solair tmeperature for house UA
+	// the .03 is from 1993 AHSRAE Fund. SI 26.5
+	tsolair = incsolarvar * .03 + state.tempOut;
+
+	if(state.flow.mCeiling >= 0) {
+		// flow from attic to house
+		A[15][15] = state.M16 * cp16 / building.dtau + H7 * A7 - state.flow.mRetReg * cp16 - state.flow.mHouseOUT * cp16 + H13 * A13 + state.UA;
+		state.b[15] = state.M16 * cp16 * state.tempOld[15] / building.dtau + (state.flow.mHouseIN - state.flow.mHRV) * cp16 * state.tempOut + state.flow.mHRV * cp16 * (( 1 - building.HRV_ASE) * state.tempOut + building.HRV_ASE * state.tempOld[15]) + state.UA * tsolair + .05 * state.solgain + state.flow.mSupReg * cp1 * toldcur[14] + state.flow.mCeiling * cp1 * toldcur[0] + state.flow.mSupAHoff * cp15 * toldcur[14] + state.flow.mRetAHoff * cp12 * toldcur[11] + state.internalGains;
+	} else {
+		// flow from house to attic
+		A[15][15] = state.M16 * cp16 / building.dtau + H7 * A7 - state.flow.mCeiling * cp16 - state.flow.mSupAHoff * cp16 - state.flow.mRetAHoff * cp16 - state.flow.mRetReg * cp16 - state.flow.mHouseOUT * cp16 + H13 * A13 + state.UA;
+		state.b[15] = state.M16 * cp16 * state.tempOld[15] / building.dtau + (state.flow.mHouseIN - state.flow.mHRV) * cp16 * state.tempOut + state.flow.mHRV * cp16 * ((1 - building.HRV_ASE) * state.tempOut + building.HRV_ASE * state.tempOld[15]) + state.UA * tsolair + .05 * state.solgain + state.flow.mSupReg * cp1 * toldcur[14] + state.internalGains;
+	}
+
+	A[15][6] = -H7 * A7;
+	A[15][12] = -H13 * A13;
+
+	if(building.duct.ductLocation == 1) {
+		// ducts in house
+		if(state.flow.mCeiling >= 0) {
 			// flow from attic to house
-			A[15][15] = M16 * cp16 / dtau + H7 * A7 - mRetReg * cp16 - mHouseOUT * cp16 + H13 * A13 + UA;
-			b[15] = M16 * cp16 * tempOld[15] / dtau + (mHouseIN - mHRV) * cp16 * tempOut + mHRV * cp16 * (( 1 - HRV_ASE) * tempOut + HRV_ASE * tempOld[15]) + UA * tsolair + .05 * solgain + mSupReg * cp1 * toldcur[14] + mCeiling * cp1 * toldcur[0] + mSupAHoff * cp15 * toldcur[14] + mRetAHoff * cp12 * toldcur[11] + internalGains;
+			A[15][15] = state.M16 * cp16 / building.dtau + H7 * A7 + A11 * H11 + A14 * H14 - state.flow.mRetReg * cp16 - state.flow.mHouseOUT * cp16 + H13 * A13 + state.UA;
+			state.b[15] = state.M16 * cp16 * state.tempOld[15] / building.dtau + (state.flow.mHouseIN - state.flow.mHRV) * cp16 * state.tempOut + state.flow.mHRV * cp16 * ((1 - building.HRV_ASE) * state.tempOut + building.HRV_ASE * state.tempOld[15]) + state.UA * tsolair + .05 * state.solgain + state.flow.mSupReg * cp1 * toldcur[14] + state.flow.mCeiling * cp1 * toldcur[0] + state.flow.mSupAHoff * cp15 * toldcur[14] + state.flow.mRetAHoff * cp12 * toldcur[11];
 		} else {
 			// flow from house to attic
-			A[15][15] = M16 * cp16 / dtau + H7 * A7 - mCeiling * cp16 - mSupAHoff * cp16 - mRetAHoff * cp16 - mRetReg * cp16 - mHouseOUT * cp16 + H13 * A13 + UA;
-			b[15] = M16 * cp16 * tempOld[15] / dtau + (mHouseIN - mHRV) * cp16 * tempOut + mHRV * cp16 * ((1 - HRV_ASE) * tempOut + HRV_ASE * tempOld[15]) + UA * tsolair + .05 * solgain + mSupReg * cp1 * toldcur[14] + internalGains;
+			A[15][15] = state.M16 * cp16 / building.dtau + H7 * A7 + A11 * H11 + A14 * H14 - state.flow.mCeiling * cp16 - state.flow.mSupAHoff * cp16 - state.flow.mRetAHoff * cp16 - state.flow.mRetReg * cp16 - state.flow.mHouseOUT * cp16 + H13 * A13 + state.UA;
+			state.b[15] = state.M16 * cp16 * state.tempOld[15] / building.dtau + (state.flow.mHouseIN - state.flow.mHRV) * cp16 * state.tempOut + state.flow.mHRV * cp16 * ((1 - building.HRV_ASE) * state.tempOut + building.HRV_ASE * state.tempOld[15]) + state.UA * tsolair + .05 * state.solgain + state.flow.mSupReg * cp1 * toldcur[14];
 		}
+		A[15][10] = -A11 * H11;
+		A[15][13] = -A14 * H14;
+	}
 
-		A[15][6] = -H7 * A7;
-		A[15][12] = -H13 * A13;
+	asize = sizeof(A)/sizeof(A[0]);
+	asize2 = sizeof(A[0])/sizeof(A[0][0]);
+}
 
-		if(ductLocation == 1) {
-			// ducts in house
-			if(mCeiling >= 0) {
-				// flow from attic to house
-				A[15][15] = M16 * cp16 / dtau + H7 * A7 + A11 * H11 + A14 * H14 - mRetReg * cp16 - mHouseOUT * cp16 + H13 * A13 + UA;
-				b[15] = M16 * cp16 * tempOld[15] / dtau + (mHouseIN - mHRV) * cp16 * tempOut + mHRV * cp16 * ((1 - HRV_ASE) * tempOut + HRV_ASE * tempOld[15]) + UA * tsolair + .05 * solgain + mSupReg * cp1 * toldcur[14] + mCeiling * cp1 * toldcur[0] + mSupAHoff * cp15 * toldcur[14] + mRetAHoff * cp12 * toldcur[11];
-			} else {
-				// flow from house to attic
-				A[15][15] = M16 * cp16 / dtau + H7 * A7 + A11 * H11 + A14 * H14 - mCeiling * cp16 - mSupAHoff * cp16 - mRetAHoff * cp16 - mRetReg * cp16 - mHouseOUT * cp16 + H13 * A13 + UA;
-				b[15] = M16 * cp16 * tempOld[15] / dtau + (mHouseIN - mHRV) * cp16 * tempOut + mHRV * cp16 * ((1 - HRV_ASE) * tempOut + HRV_ASE * tempOld[15]) + UA * tsolair + .05 * solgain + mSupReg * cp1 * toldcur[14];
+int heat_struct::f_converged(houseState_struct& state, solver_struct& solver) {
+	if(abs(state.b[0] - toldcur[0]) < .1) {
+		solver.iterations = heatIterations;
+		solver.residual = abs(state.b[0] - toldcur[0]);
+		return 1;
+	}
+	for(int i=0; i < 16; i++) {
+		toldcur[i] = state.b[i];
+	}
+	return 0;
+}
+
+void sub_heat(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather, solver_struct& solver) {
+	PROFILE_COUNT(PROF_HEAT);
+	CAPTURE_CALL(f_captureHeat(building, state, weather));
+
+	heat_struct heat;
+
+	heat.begin(building, state, weather);
+
+	// ITERATION OF TEMPERATURES WITHIN HEAT SUBROUTINE
+	// THIS ITERATES BETWEEN ALL TEMPERATURES BEFORE RETURNING TO MAIN PROGRAM
+	while(1) {
+		heat.assemble(building, state, weather);
+
+		PROFILE_COUNT(PROF_MATSEQN);
+		state.ERRCODE = MatSEqn(heat.A, state.b, heat.asize, heat.asize2, state.bsize);
+
+		if(heat.f_converged(state, solver))
+			break;
+	} // END of DO LOOP
+}
+
+void sub_heatLanes(const building_struct* const building[], houseState_struct* const state[], const weatherSample_struct* const weather[],
+	solver_struct solver[], const int active[], int lanes) {
+	heat_struct heat[MAX_LANES];
+	double A[ArraySize][ArraySize][MAX_LANES];		// The lanes' systems, lane innermost
+	double b[ArraySize][MAX_LANES];
+	int errcode[MAX_LANES];
+	int iterating[MAX_LANES];						// Lanes whose temperatures have not converged yet
+	int numIterating = 0;
+
+	for(int l=0; l < lanes; l++) {
+		iterating[l] = active[l];
+		if(active[l]) {
+			heat[l].begin(*building[l], *state[l], *weather[l]);
+			numIterating++;
+		}
+	}
+
+	while(numIterating > 0) {
+		for(int l=0; l < lanes; l++) {
+			if(!iterating[l])
+				continue;
+			heat[l].assemble(*building[l], *state[l], *weather[l]);
+			for(int i=0; i < ArraySize; i++) {
+				for(int j=0; j < ArraySize; j++) {
+					A[i][j][l] = heat[l].A[i][j];
+				}
+				b[i][l] = state[l]->b[i];
 			}
-			A[15][10] = -A11 * H11;
-			A[15][13] = -A14 * H14;
 		}
 
-		asize = sizeof(A)/sizeof(A[0]);
-		asize2 = sizeof(A[0])/sizeof(A[0][0]);
-		
-		ERRCODE = MatSEqn(A, b, asize, asize2, bsize);
+		MatSEqnLanes(A, b, iterating, errcode, lanes);
 
-		if(abs(b[0] - toldcur[0]) < .1) {
-			break;
-		} else {
-			for(int i=0; i < 16; i++) {
-				toldcur[i] = b[i];
+		for(int l=0; l < lanes; l++) {
+			if(!iterating[l])
+				continue;
+			for(int i=0; i < ArraySize; i++) {
+				state[l]->b[i] = b[i][l];
+			}
+			state[l]->ERRCODE = errcode[l];
+			if(heat[l].f_converged(*state[l], solver[l])) {
+				iterating[l] = 0;
+				numIterating--;
 			}
 		}
-	} // END of DO LOOP
+	}
 }
 
-void sub_moisture ( 
-	double* HR, 
-	double* hrold, 
-	double& Mw1, 
-	double& Mw2, 
-	double& Mw3, 
-	double& Mw4, 
-	double& Mw5, 
-	double& dtau, 
-	double& matticenvout, 
-	double& mCeiling, 
-	double& mSupAHoff, 
-	double& mRetAHoff, 
-	double& matticenvin, 
-	double& HROUT, 
-	double& mSupLeak, 
-	double& mAH, 
-	double& mRetReg, 
-	double& mRetLeak, 
-	double& mSupReg, 
-	double& latcap, 
-	double& mHouseIN, 
-	double& mHouseOUT, 
-	double& latentLoad, 
-	double& mFanCycler, 
-	double& mHRV_AH,
-	double& mERV_AH, 
-	double& ERV_TRE,
-	double& MWha,
-	double& airDensityIN,
-	double& airDensityOUT
-	) {
+void sub_moisture(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather) {
+		CAPTURE_CALL(f_captureMoisture(building, state, weather));
 		double Q[5];
 		double R[5];
 
@@ -1099,402 +1069,399 @@ void sub_moisture (
 		// this routine takes humidity ratios and mass flows and calculates W in each zone
 
 		// Attic Air
-		if(mCeiling >= 0) {
+		if(state.flow.mCeiling >= 0) {
 			// flow from attic to house
-			Q[0] = Mw1 / dtau - matticenvout - mRetLeak + mCeiling + mSupAHoff + mRetAHoff;
-			R[0] = Mw1 * hrold[0] / dtau + matticenvin * HROUT + mSupLeak * hrold[2];
+			Q[0] = state.M1 / building.dtau - state.flow.matticenvout - state.flow.mRetLeak + state.flow.mCeiling + state.flow.mSupAHoff + state.flow.mRetAHoff;
+			R[0] = state.M1 * state.hrold[0] / building.dtau + state.flow.matticenvin * weather.HROUT + state.flow.mSupLeak * state.hrold[2];
 		} else {
 			// flow from house to attic
-			Q[0] = Mw1 / dtau - matticenvout - mRetLeak;
-			R[0] = Mw1 * hrold[0] / dtau + matticenvin * HROUT + mSupLeak * hrold[2] - mCeiling * hrold[3] - mSupAHoff * hrold[2] - mRetAHoff * hrold[1];
+			Q[0] = state.M1 / building.dtau - state.flow.matticenvout - state.flow.mRetLeak;
+			R[0] = state.M1 * state.hrold[0] / building.dtau + state.flow.matticenvin * weather.HROUT + state.flow.mSupLeak * state.hrold[2] - state.flow.mCeiling * state.hrold[3] - state.flow.mSupAHoff * state.hrold[2] - state.flow.mRetAHoff * state.hrold[1];
 		}
 
 		// Return Air
-		if(mCeiling >= 0) { // flow from attic to house
-			Q[1] = Mw2 / dtau + mAH + mRetAHoff;
-			R[1] = Mw2 * hrold[1] / dtau - mRetLeak * hrold[0] + mRetAHoff * hrold[0] - mRetReg * hrold[3] - mFanCycler * HROUT - mERV_AH * ((1-ERV_TRE) * HROUT + ERV_TRE * hrold[3]) - mHRV_AH * HROUT; 
+		if(state.flow.mCeiling >= 0) { // flow from attic to house
+			Q[1] = state.M12 / building.dtau + state.flow.mAH + state.flow.mRetAHoff;
+			R[1] = state.M12 * state.hrold[1] / building.dtau - state.flow.mRetLeak * state.hrold[0] + state.flow.mRetAHoff * state.hrold[0] - state.flow.mRetReg * state.hrold[3] - state.flow.mFanCycler * weather.HROUT - state.flow.mERV_AH * ((1-building.ERV_TRE) * weather.HROUT + building.ERV_TRE * state.hrold[3]) - state.flow.mHRV_AH * weather.HROUT; 
 		} else { // flow from house to attic
-			Q[1] = Mw2 / dtau - mRetAHoff + mAH;
-			R[1] = Mw2 * hrold[1] / dtau - mRetAHoff * hrold[3] - mRetLeak * hrold[0] - mRetReg * hrold[3] - mFanCycler * HROUT - mERV_AH * ((1-ERV_TRE) * HROUT + ERV_TRE * hrold[3]) - mHRV_AH * HROUT;
+			Q[1] = state.M12 / building.dtau - state.flow.mRetAHoff + state.flow.mAH;
+			R[1] = state.M12 * state.hrold[1] / building.dtau - state.flow.mRetAHoff * state.hrold[3] - state.flow.mRetLeak * state.hrold[0] - state.flow.mRetReg * state.hrold[3] - state.flow.mFanCycler * weather.HROUT - state.flow.mERV_AH * ((1-building.ERV_TRE) * weather.HROUT + building.ERV_TRE * state.hrold[3]) - state.flow.mHRV_AH * weather.HROUT;
 		}
 
 		// Supply Air
-		if(mCeiling >= 0) { // flow from attic to house
-			Q[2] = Mw3 / dtau + mSupLeak + mSupReg + mSupAHoff;
-			R[2] = Mw3 * hrold[2] / dtau + mAH * hrold[1] + mSupAHoff * hrold[0] - latcap / 2501000;
+		if(state.flow.mCeiling >= 0) { // flow from attic to house
+			Q[2] = state.M15 / building.dtau + state.flow.mSupLeak + state.flow.mSupReg + state.flow.mSupAHoff;
+			R[2] = state.M15 * state.hrold[2] / building.dtau + state.flow.mAH * state.hrold[1] + state.flow.mSupAHoff * state.hrold[0] - state.equip.latcap / 2501000;
 		} else { // flow from house to attic
-			Q[2] = Mw3 / dtau + mSupLeak + mSupReg - mSupAHoff;
-			R[2] = Mw3 * hrold[2] / dtau + mAH * hrold[1] - mSupAHoff * hrold[3] - latcap / 2501000;
+			Q[2] = state.M15 / building.dtau + state.flow.mSupLeak + state.flow.mSupReg - state.flow.mSupAHoff;
+			R[2] = state.M15 * state.hrold[2] / building.dtau + state.flow.mAH * state.hrold[1] - state.flow.mSupAHoff * state.hrold[3] - state.equip.latcap / 2501000;
 		}
 
 		// House Air
-		if(mCeiling >= 0) { // flow from attic to house
-			Q[3] = Mw4 / dtau - mHouseOUT - mRetReg + MWha;
-			R[3] = Mw4 * hrold[3] / dtau + mHouseIN * HROUT + mSupReg * hrold[2] + mCeiling * hrold[0] + mSupAHoff * hrold[2] + mRetAHoff * hrold[1] + latentLoad + MWha * hrold[4];
+		if(state.flow.mCeiling >= 0) { // flow from attic to house
+			Q[3] = state.M16 / building.dtau - state.flow.mHouseOUT - state.flow.mRetReg + building.MWha;
+			R[3] = state.M16 * state.hrold[3] / building.dtau + state.flow.mHouseIN * weather.HROUT + state.flow.mSupReg * state.hrold[2] + state.flow.mCeiling * state.hrold[0] + state.flow.mSupAHoff * state.hrold[2] + state.flow.mRetAHoff * state.hrold[1] + building.latentLoad + building.MWha * state.hrold[4];
 		} else { // flow from house to attic
-			Q[3] = Mw4 / dtau - mHouseOUT - mRetReg - mCeiling - mSupAHoff - mRetAHoff + MWha;
-			R[3] = Mw4 * hrold[3] / dtau + mHouseIN * HROUT + mSupReg * hrold[2] + latentLoad + MWha * hrold[4];
+			Q[3] = state.M16 / building.dtau - state.flow.mHouseOUT - state.flow.mRetReg - state.flow.mCeiling - state.flow.mSupAHoff - state.flow.mRetAHoff + building.MWha;
+			R[3] = state.M16 * state.hrold[3] / building.dtau + state.flow.mHouseIN * weather.HROUT + state.flow.mSupReg * state.hrold[2] + building.latentLoad + building.MWha * state.hrold[4];
 		}
 
 		// House furnishings/storage
-		Q[4] = Mw5 / dtau + MWha;
-		R[4] = Mw5 * hrold[4] / dtau + MWha * hrold[3];
+		Q[4] = building.Mw5 / building.dtau + building.MWha;
+		R[4] = building.Mw5 * state.hrold[4] / building.dtau + building.MWha * state.hrold[3];
 		
 		for(int i=0; i < 5; i++) {
-			HR[i] = R[i] / Q[i];
+			state.HR[i] = R[i] / Q[i];
 		}
 }
 
-void sub_houseLeak (
-	int& AHflag,
-	double& flag, 
-	double& windSpeed, 
-	double& windAngle, 
-	double& tempHouse, 
-	double& tempAttic, 
-	double& tempOut, 
-	double& C, 
-	double& n, 
-	double& h, 
-	double& R, 
-	double& X, 
-	int& numFlues, 
-	flue_struct* flue, 
-	double* wallFraction, 
-	double* floorFraction, 
-	double* Sw, 
-	double& flueShelterFactor, 
-	int& numWinDoor, 
-	winDoor_struct* winDoor, 
-	int& numFans, 
-	fan_struct* fan, 
-	int& numPipes, 
-	pipe_struct* Pipe, 
-	double& mIN, 
-	double& mOUT, 
-	double& Pint, 
-	double& mFlue, 
-	double& mCeiling, 
-	double* mFloor, 
-	double& atticC, 
-	double& dPflue, 
-	double& dPceil, 
-	double& dPfloor, 
-	int& Crawl, 
-	double& Hfloor, 
-	string& rowOrIsolated, 
-	double* soffitFraction, 
-	double& Patticint, 
-	double* wallCp, 
-	double& airDensityRef, 
-	double& airTempRef, 
-	double& mSupReg, 
-	double& mAH, 
-	double& mRetLeak, 
-	double& mSupLeak, 
-	double& mRetReg, 
-	double& mHouseIN, 
-	double& mHouseOUT, 
-	double& supC, 
-	double& supn, 
-	double& retC, 
-	double& retn, 
-	double& mSupAHoff, 
-	double& mRetAHoff, 
-	double& Aeq,
-	double& airDensityIN,
-	double& airDensityOUT,
-	double& airDensityATTIC,
-	double& ceilingC,
-	double& houseVolume,
-	double& windPressureExp,
-	double& Q622
-	) {
-		double dtheta = 11.3;
-		int nofirst = 0;
-
-		double Cpwallvar = 0;		// This variable replaces the non-array wallCp var
-		double CPvar = 0;			// This variable replaces the non-array CP var
-		double Bovar = 0;			// This variable is to replace Bo[-1] and to account for Bo(0) in BASIC version
-
-		double Mwall[4];
-		double Mwallin[4];
-		double Mwallout[4];
-		double Bo[4];
-		double CP[4][4];
-		double dPint;
-		//double rhoi;
-		//double rhoo;
-		//double rhoa;
-		//double fluePressureExp;
-		double dPwind;
-		double dPtemp;
-		double dPwalltop = 0;
-		double dPwallbottom = 0;
-		double Cproof;
-		double Cpwalls;
-		double Cpattic;		
-		double Cpfloor;
-		double Cwall;
-		double Cfloor;
-		
-		mFlue = 0;
-		mCeiling = 0;
+// The locals of one sub_houseLeak call. begin() sets up the pressure coefficients and the first guess of the house
+// pressure, f_balance() sums the mass flows in and out of the house at state.Pint and end() splits the flows found at
+// the last pressure tried. sub_houseLeak() bisects on state.Pint until the step is below .0001 Pa.
+struct houseLeak_struct {
+	void begin(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather);
+	double f_balance(const building_struct& building, houseState_struct& state);
+	void end(houseState_struct& state, solver_struct& solver);
+
+	double dtheta;
+	int nofirst;
+
+	double Cpwallvar;		// This variable replaces the non-array wallCp var
+	double CPvar;			// This variable replaces the non-array CP var
+	double Bovar;			// This variable is to replace Bo[-1] and to account for Bo(0) in BASIC version
+
+	double Mwall[4];
+	double Mwallin[4];
+	double Mwallout[4];
+	double Bo[4];
+	double CP[4][4];
+	double dPint;
+	//double rhoi;
+	//double rhoo;
+	//double rhoa;
+	//double fluePressureExp;
+	double dPwind;
+	double dPtemp;
+	double dPwalltop;
+	double dPwallbottom;
+	double Cproof;
+	double Cpwalls;
+	double Cpattic;
+	double Cpfloor;
+	double Cwall;
+	double Cfloor;
+};
+
+void houseLeak_struct::begin(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather) {
+	dtheta = 11.3;
+	nofirst = 0;
+	Cpwallvar = 0;
+	CPvar = 0;
+	Bovar = 0;
+	dPwalltop = 0;
+	dPwallbottom = 0;
 
-		for(int i=0; i < 4; i++) {
-			mFloor[i] = 0;			
-			Mwall[i] = 0;
-			Mwallin[i] = 0;
-			Mwallout[i] = 0;
-			wallCp[i] = 0;
-			Bo[i] = 0;
-			for(int j=0; j < 4; j++) {
-				CP[i][j] = 0;
-			}
+	state.mFlue = 0;
+	state.flow.mCeiling = 0;
+
+	for(int i=0; i < 4; i++) {
+		state.mFloor[i] = 0;			
+		Mwall[i] = 0;
+		Mwallin[i] = 0;
+		Mwallout[i] = 0;
+		state.wallCp[i] = 0;
+		Bo[i] = 0;
+		for(int j=0; j < 4; j++) {
+			CP[i][j] = 0;
 		}
+	}
 
-		// These are now calculated in the main function and passed to the sub-routines
-		//rhoi = airDensityRef * airTempRef / tempHouse;
-		//rhoo = airDensityRef * airTempRef / tempOut;
-		//rhoa = airDensityRef * airTempRef / tempAttic;
+	// These are now calculated in the main function and passed to the sub-routines
+	//rhoi = airDensityRef * airTempRef / tempHouse;
+	//rhoo = airDensityRef * airTempRef / tempOut;
+	//rhoa = airDensityRef * airTempRef / tempAttic;
 
-		// the following are pressure differences common to all the flow equations
-		dPwind = airDensityOUT / 2 * pow(windSpeed,2);
-		dPtemp = airDensityOUT * g * (tempHouse - tempOut) / tempHouse;
-		
-		// the following are some typical pressure coefficients for rectangular houses
-		
-		Cproof = -.4;
+	// the following are pressure differences common to all the flow equations
+	dPwind = state.airDensityOUT / 2 * pow(state.windSpeed,2);
+	dPtemp = state.airDensityOUT * g * (state.tempHouse - state.tempOut) / state.tempHouse;
+	
+	// the following are some typical pressure coefficients for rectangular houses
+	
+	Cproof = -.4;
+
+	for(int i=0; i < 4; i++) {
+		CP[i][0] = .6;
+		CP[i][1] = -.3;
+	}
+	// here the variation of each wall Cp with wind angle is accounted for:
+	// for row houses:
 
+	if(strUppercase(building.rowOrIsolated) == "R") {
+		CP[0][2] = -0.2;
+		CP[0][3] = -0.2;
+		CP[1][2] = -0.2;
+		CP[1][3] = -0.2;
+		CP[2][2] = -0.65;
+		CP[2][3] = -0.65;
+		CP[3][2] = -0.65;
+		CP[3][3] = -0.65;
+	} else {
+		// for isolated houses
 		for(int i=0; i < 4; i++) {
-			CP[i][0] = .6;
-			CP[i][1] = -.3;
-		}
-		// here the variation of each wall Cp with wind angle is accounted for:
-		// for row houses:
-
-		if(strUppercase(rowOrIsolated) == "R") {
-			CP[0][2] = -0.2;
-			CP[0][3] = -0.2;
-			CP[1][2] = -0.2;
-			CP[1][3] = -0.2;
-			CP[2][2] = -0.65;
-			CP[2][3] = -0.65;
-			CP[3][2] = -0.65;
-			CP[3][3] = -0.65;
-		} else {
-			// for isolated houses
-			for(int i=0; i < 4; i++) {
-				CP[i][2] = -0.65;
-				CP[i][3] = -0.65;
-			}
+			CP[i][2] = -0.65;
+			CP[i][3] = -0.65;
 		}
+	}
 
-		f_CpTheta(CP, windAngle, wallCp);
+	f_CpTheta(CP, weather.direction, state.wallCp);
 
-		Cpwalls = 0;
-		Cpattic = 0;
+	Cpwalls = 0;
+	Cpattic = 0;
 
-		for(int i=0; i < 4; i++) {
-			Cpattic = Cpattic + pow(Sw[i], 2) * wallCp[i] * soffitFraction[i];
-			Cpwalls = Cpwalls + pow(Sw[i], 2) * wallCp[i] * wallFraction[i];			// Shielding weighted Cp
-		}
+	for(int i=0; i < 4; i++) {
+		Cpattic = Cpattic + pow(state.Sw[i], 2) * state.wallCp[i] * building.soffitFraction[i];
+		Cpwalls = Cpwalls + pow(state.Sw[i], 2) * state.wallCp[i] * building.wallFraction[i];			// Shielding weighted Cp
+	}
+
+	Cpattic = Cpattic + pow(building.flueShelterFactor, 2) * Cproof * building.soffitFraction[4];
+
+	//if(flag < 1) {        // Yihuan: delete the if condition for the flag
+		state.Pint = 0;			// a reasonable first guess   
+		dPint = 200;		// increased from 25 to account for economizer operation
+		//dPint = 25;		// increased from 25 to account for economizer operation
+	//} else {
+		//dPint = .25;
+//}
+}
+
+double houseLeak_struct::f_balance(const building_struct& building, houseState_struct& state) {
+	state.mIN = 0;
+	state.mOUT = 0;
+	
+	if(building.numFlues) {					//FF: This IF behaves as if(numFlues != 0)
+		f_flueFlow(state.tempHouse, building.flueShelterFactor, dPwind, dPtemp, building.h, state.Pint, building.numFlues, building.flue, state.mFlue, state.airDensityOUT, state.airDensityIN, state.dPflue, state.tempOut, building.Aeq, building.airTempRef, building.houseVolume, building.windPressureExp, building.Q622);
 
-		Cpattic = Cpattic + pow(flueShelterFactor, 2) * Cproof * soffitFraction[4];
+		if(state.mFlue >= 0) {
+			state.mIN = state.mIN + state.mFlue;		// Add mass flow through flue
+		} else {
+			state.mOUT = state.mOUT + state.mFlue;
+		}
+	}
+	
+	
 
-		//if(flag < 1) {        // Yihuan: delete the if condition for the flag
-			Pint = 0;			// a reasonable first guess   
-			dPint = 200;		// increased from 25 to account for economizer operation
-			//dPint = 25;		// increased from 25 to account for economizer operation
-		//} else {
-			//dPint = .25;
-	//}
+	if((building.R - building.X) / 2) {
+		if(building.Crawl == 1) {
+			// for a crawlspace the flow is put into array position 1
+			Cpfloor = Cpwalls;
+			Cfloor = state.C * (building.R - building.X) / 2;
 
-		do {
-			mIN = 0;
-			mOUT = 0;
+			f_floorFlow3(Cfloor, Cpfloor, dPwind, state.Pint, state.C, building.n, state.mFloor[0], state.airDensityOUT, state.airDensityIN, state.dPfloor, building.Hfloor, dPtemp);
 			
-			if(numFlues) {					//FF: This IF behaves as if(numFlues != 0)
-				f_flueFlow(tempHouse, flueShelterFactor, dPwind, dPtemp, h, Pint, numFlues, flue, mFlue, airDensityOUT, airDensityIN, dPflue, tempOut, Aeq, airTempRef, houseVolume, windPressureExp, Q622);
+			if(state.mFloor[0] >= 0) {
+				state.mIN = state.mIN + state.mFloor[0];
+			} else {
+				state.mOUT = state.mOUT + state.mFloor[0];
+			}
+
+		} else {
+			for(int i=0; i < 4; i++) {
+				Cpfloor = pow(state.Sw[i], 2) * state.wallCp[i];
+				Cfloor = state.C * (building.R - building.X) / 2 * building.floorFraction[i];
 
-				if(mFlue >= 0) {
-					mIN = mIN + mFlue;		// Add mass flow through flue
+				f_floorFlow3(Cfloor, Cpfloor, dPwind, state.Pint, state.C, building.n, state.mFloor[i], state.airDensityOUT, state.airDensityIN, state.dPfloor, building.Hfloor, dPtemp);
+				
+				if(state.mFloor[i] >= 0) {							
+					state.mIN = state.mIN + state.mFloor[i];
 				} else {
-					mOUT = mOUT + mFlue;
+					state.mOUT = state.mOUT + state.mFloor[i];
 				}
-			}
-			
-			
+			}					
+		}
+	}
+	
+	if((building.R + building.X) / 2) {
 
-			if((R - X) / 2) {
-				if(Crawl == 1) {
-					// for a crawlspace the flow is put into array position 1
-					Cpfloor = Cpwalls;
-					Cfloor = C * (R - X) / 2;
+		f_ceilingFlow(state.AHflag, building.R, building.X, state.Patticint, building.h, dPtemp, dPwind, state.Pint, state.C, building.n, state.flow.mCeiling, building.atticC, state.airDensityATTIC, state.airDensityIN, state.dPceil, state.tempAttic, state.tempHouse, state.tempOut, state.airDensityOUT, state.flow.mSupAHoff, state.flow.mRetAHoff, building.duct.supC, building.duct.supn, building.duct.retC, building.duct.retn, state.ceilingC);
 
-					f_floorFlow3(Cfloor, Cpfloor, dPwind, Pint, C, n, mFloor[0], airDensityOUT, airDensityIN, dPfloor, Hfloor, dPtemp);
-					
-					if(mFloor[0] >= 0) {
-						mIN = mIN + mFloor[0];
-					} else {
-						mOUT = mOUT + mFloor[0];
-					}
+		if(state.flow.mCeiling >= 0) {
+			state.mIN = state.mIN + state.flow.mCeiling + state.flow.mSupAHoff + state.flow.mRetAHoff;
+		} else {
+			state.mOUT = state.mOUT + state.flow.mCeiling + state.flow.mSupAHoff + state.flow.mRetAHoff;
+		}
+	}
 
-				} else {
-					for(int i=0; i < 4; i++) {
-						Cpfloor = pow(Sw[i], 2) * wallCp[i];
-						Cfloor = C * (R - X) / 2 * floorFraction[i];
-
-						f_floorFlow3(Cfloor, Cpfloor, dPwind, Pint, C, n, mFloor[i], airDensityOUT, airDensityIN, dPfloor, Hfloor, dPtemp);
-						
-						if(mFloor[i] >= 0) {							
-							mIN = mIN + mFloor[i];
-						} else {
-							mOUT = mOUT + mFloor[i];
-						}
-					}					
-				}
-			}
+	// the neutral level is calculated for each wall:
+	f_neutralLevel2(dPtemp, dPwind, state.Sw, state.Pint, state.wallCp, Bo, building.h);
+	
+	if(building.R < 1) {
+		for(int i=0; i < 4; i++) {
+			Cpwallvar = pow(state.Sw[i], 2) * state.wallCp[i];
+			Cwall = state.C * (1 - building.R) * building.wallFraction[i];
 			
-			if((R + X) / 2) {
-
-				f_ceilingFlow(AHflag, R, X, Patticint, h, dPtemp, dPwind, Pint, C, n, mCeiling, atticC, airDensityATTIC, airDensityIN, dPceil, tempAttic, tempHouse, tempOut, airDensityOUT, mSupAHoff, mRetAHoff, supC, supn, retC, retn, ceilingC);
+			f_wallFlow3(state.tempHouse, state.tempOut, state.airDensityIN, state.airDensityOUT, Bo[i], Cpwallvar, building.n, Cwall, building.h, state.Pint, dPtemp, dPwind, Mwall[i], Mwallin[i], Mwallout[i], dPwalltop, dPwallbottom, building.Hfloor);
+			
+			state.mIN = state.mIN + Mwallin[i];
+			state.mOUT = state.mOUT + Mwallout[i];
+		}
+	}
 
-				if(mCeiling >= 0) {
-					mIN = mIN + mCeiling + mSupAHoff + mRetAHoff;
-				} else {
-					mOUT = mOUT + mCeiling + mSupAHoff + mRetAHoff;
-				}
-			}
+	for(int i=0; i < building.numFans; i++) {
+		if(state.fan[i].on == 1) {						// for cycling fans they will somtimes be off and we don;t want ot include them
 
-			// the neutral level is calculated for each wall:
-			f_neutralLevel2(dPtemp, dPwind, Sw, Pint, wallCp, Bo, h);
+			f_fanFlow(state.fan[i], state.airDensityOUT, state.airDensityIN);					
 			
-			if(R < 1) {
-				for(int i=0; i < 4; i++) {
-					Cpwallvar = pow(Sw[i], 2) * wallCp[i];
-					Cwall = C * (1 - R) * wallFraction[i];
-					
-					f_wallFlow3(tempHouse, tempOut, airDensityIN, airDensityOUT, Bo[i], Cpwallvar, n, Cwall, h, Pint, dPtemp, dPwind, Mwall[i], Mwallin[i], Mwallout[i], dPwalltop, dPwallbottom, Hfloor);
-					
-					mIN = mIN + Mwallin[i];
-					mOUT = mOUT + Mwallout[i];
-				}
+			if(state.fan[i].m >= 0) {
+				state.mIN = state.mIN + state.fan[i].m;
+			} else {
+				state.mOUT = state.mOUT + state.fan[i].m;
 			}
+		}
+	}
+	
+	for(int i=0; i < building.numPipes; i++) {
 
-			for(int i=0; i < numFans; i++) {
-				if(fan[i].on == 1) {						// for cycling fans they will somtimes be off and we don;t want ot include them
+		// FF: This if is to counter the 0 index out of bound present in BASIC version
+		// example: if pipe[i].wall = 0 then it would look for Sw[0] in BASIC version, which defaults to 0 while in the C++ version
+		// it would try to find Sw[-1] and cause error.
 
-					f_fanFlow(fan[i], airDensityOUT, airDensityIN);					
-					
-					if(fan[i].m >= 0) {
-						mIN = mIN + fan[i].m;
-					} else {
-						mOUT = mOUT + fan[i].m;
-					}
-				}
-			}
-			
-			for(int i=0; i < numPipes; i++) {
+		if(state.Pipe[i].wall - 1 >= 0)
+			CPvar = pow(state.Sw[state.Pipe[i].wall - 1], 2) * state.wallCp[state.Pipe[i].wall - 1];
+		else
+			CPvar = 0;
+
+		f_pipeFlow(state.airDensityOUT, state.airDensityIN, CPvar, dPwind, dPtemp, state.Pint, state.Pipe[i], state.tempHouse, state.tempOut, building.airTempRef);
+		
+		if(state.Pipe[i].m >= 0) {
+			state.mIN = state.mIN + state.Pipe[i].m;
+		} else {
+			state.mOUT = state.mOUT + state.Pipe[i].m;
+		}
+	}
+	
+	for(int i=0; i < building.numWinDoor; i++) {
+		if(state.winDoor[i].wall-1 >= 0) {
+			Cpwallvar = pow(state.Sw[state.winDoor[i].wall-1], 2) * state.wallCp[state.winDoor[i].wall-1];
+			Bovar = Bo[state.winDoor[i].wall-1];
+		} else {
+			Cpwallvar = 0;
+			Bovar = 0;
+		}
 
-				// FF: This if is to counter the 0 index out of bound present in BASIC version
-				// example: if pipe[i].wall = 0 then it would look for Sw[0] in BASIC version, which defaults to 0 while in the C++ version
-				// it would try to find Sw[-1] and cause error.
+		f_winDoorFlow(state.tempHouse, state.tempOut, state.airDensityIN, state.airDensityOUT, building.h, Bovar, Cpwallvar, building.n, state.Pint, dPtemp, dPwind, state.winDoor[i]);
+		
+		state.mIN = state.mIN + state.winDoor[i].mIN;
+		state.mOUT = state.mOUT + state.winDoor[i].mOUT;
+	}
 
-				if(Pipe[i].wall - 1 >= 0)
-					CPvar = pow(Sw[Pipe[i].wall - 1], 2) * wallCp[Pipe[i].wall - 1];
-				else
-					CPvar = 0;
+	// DUCT MASS FLOWS
+	// Msup is flow out of supply registers plus leakage to inside
+	// Mret is flow into return registers plus leakage to inside
 
-				f_pipeFlow(airDensityOUT, airDensityIN, CPvar, dPwind, dPtemp, Pint, Pipe[i], tempHouse, tempOut, airTempRef);
-				
-				if(Pipe[i].m >= 0) {
-					mIN = mIN + Pipe[i].m;
-				} else {
-					mOUT = mOUT + Pipe[i].m;
-				}
-			}
-			
-			for(int i=0; i < numWinDoor; i++) {
-				if(winDoor[i].wall-1 >= 0) {
-					Cpwallvar = pow(Sw[winDoor[i].wall-1], 2) * wallCp[winDoor[i].wall-1];
-					Bovar = Bo[winDoor[i].wall-1];
-				} else {
-					Cpwallvar = 0;
-					Bovar = 0;
-				}
+	state.mIN = state.mIN + state.flow.mSupReg;
+	state.mOUT = state.mOUT + state.flow.mRetReg; // Note Mret should be negative
 
-				f_winDoorFlow(tempHouse, tempOut, airDensityIN, airDensityOUT, h, Bovar, Cpwallvar, n, Pint, dPtemp, dPwind, winDoor[i]);
-				
-				mIN = mIN + winDoor[i].mIN;
-				mOUT = mOUT + winDoor[i].mOUT;
-			}
+	return state.mIN + state.mOUT;
+}
 
-			// DUCT MASS FLOWS
-			// Msup is flow out of supply registers plus leakage to inside
-			// Mret is flow into return registers plus leakage to inside
+void houseLeak_struct::end(houseState_struct& state, solver_struct& solver) {
+	solver.residual = abs(state.mIN + state.mOUT);		// Mass imbalance at the last pressure tried [kg/s]
 
-			mIN = mIN + mSupReg;
-			mOUT = mOUT + mRetReg; // Note Mret should be negative
+	if(state.flow.mCeiling >= 0) { // flow from attic to house
+		state.flow.mHouseIN = state.mIN - state.flow.mCeiling - state.flow.mSupReg - state.flow.mSupAHoff - state.flow.mRetAHoff;
+		state.flow.mHouseOUT = state.mOUT - state.flow.mRetReg;
+	} else {
+		state.flow.mHouseIN = state.mIN - state.flow.mSupReg;
+		state.flow.mHouseOUT = state.mOUT - state.flow.mCeiling - state.flow.mRetReg - state.flow.mSupAHoff - state.flow.mRetAHoff;
+	}
+	// nopressure:
+}
 
-			Pint = Pint - sgn(mIN + mOUT) * dPint;
-			dPint = dPint / 2;
+void sub_houseLeak(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather, solver_struct& solver) {
+	PROFILE_COUNT(PROF_HOUSELEAK);
+	CAPTURE_CALL(f_captureHouseLeak(building, state, weather));
 
-		} while (dPint > .0001);
-		//} while (dPint > .01);
+	houseLeak_struct leak;
 
-		if(mCeiling >= 0) { // flow from attic to house
-			mHouseIN = mIN - mCeiling - mSupReg - mSupAHoff - mRetAHoff;
-			mHouseOUT = mOUT - mRetReg;
-		} else {
-			mHouseIN = mIN - mSupReg;
-			mHouseOUT = mOUT - mCeiling - mRetReg - mSupAHoff - mRetAHoff;
+	leak.begin(building, state, weather);
+
+	solver.iterations = 0;
+
+	do {
+		solver.iterations++;
+		state.Pint = state.Pint - sgn(leak.f_balance(building, state)) * leak.dPint;
+		leak.dPint = leak.dPint / 2;
+	} while(leak.dPint > .0001);
+
+	leak.end(state, solver);
+}
+
+// The bisection of sub_houseLeak() or sub_atticLeak() for several lanes: pressure is the state member bisected on and
+// step the leak_struct member with its step. The pressures and steps are kept by lane and moved on for every lane at
+// once, a lane that has stopped moving by nothing.
+template<class leak_struct> static void sub_bisectLanes(double houseState_struct::* pressure, double leak_struct::* step,
+	const building_struct* const building[], houseState_struct* const state[], const weatherSample_struct* const weather[],
+	solver_struct solver[], const int active[], int lanes) {
+	leak_struct leak[MAX_LANES];
+	double P[MAX_LANES];
+	double dP[MAX_LANES];
+	double net[MAX_LANES];				// Mass imbalance at P [kg/s]
+	int bisecting[MAX_LANES];
+	int numBisecting = 0;
+
+	for(int l=0; l < lanes; l++) {
+		P[l] = 0;
+		dP[l] = 0;
+		net[l] = 0;
+		bisecting[l] = active[l];
+		if(active[l]) {
+			leak[l].begin(*building[l], *state[l], *weather[l]);
+			P[l] = state[l]->*pressure;
+			dP[l] = leak[l].*step;
+			solver[l].iterations = 0;
+			numBisecting++;
+		}
+	}
+
+	while(numBisecting > 0) {
+		for(int l=0; l < lanes; l++) {
+			if(!bisecting[l])
+				continue;
+			solver[l].iterations++;
+			state[l]->*pressure = P[l];
+			net[l] = leak[l].f_balance(*building[l], *state[l]);
+		}
+
+		numBisecting = 0;
+		for(int l=0; l < lanes; l++) {
+			P[l] = P[l] - bisecting[l] * sgn(net[l]) * dP[l];
+			dP[l] = bisecting[l] ? dP[l] / 2 : dP[l];
+			bisecting[l] = bisecting[l] && dP[l] > .0001;
+			numBisecting = numBisecting + bisecting[l];
 		}
-		// nopressure:
+	}
+
+	for(int l=0; l < lanes; l++) {
+		if(active[l]) {
+			state[l]->*pressure = P[l];
+			leak[l].end(*state[l], solver[l]);
+		}
+	}
 }
 
-void sub_atticLeak ( 
-	double& flag, 
-	double& windSpeed, 
-	double& windAngle, 
-	double& tempHouse, 
-	double& tempOut, 
-	double& tempAttic, 
-	double& atticC, 
-	double& atticPressureExp, 
-	double& h, 
-	double& roofPeakHeight, 
-	double& flueShelterFactor, 
-	double* Sw, 
-	int& numAtticVents, 
-	atticVent_struct* atticVent, 
-	soffit_struct* soffit, 
-	double& mAtticIN, 
-	double& mAtticOUT, 
-	double& Patticint, 
-	double& mCeiling, 
-	string& rowOrIsolated, 
-	double* soffitFraction, 
-	double& roofPitch, 
-	string& roofPeakOrient, 
-	int& numAtticFans, 
-	fan_struct* atticFan, 
-	double& airDensityRef, 
-	double& airTempRef, 
-	double& mSupReg, 
-	double& mRetLeak, 
-	double& mSupLeak, 
-	double& matticenvin, 
-	double& matticenvout, 
-	double& dtau, 
-	double& mSupAHoff, 
-	double& mRetAHoff,
-	double& airDensityIN,
-	double& airDensityOUT,
-	double& airDensityATTIC
-) {
-
-	double dtheta = 0;	
+void sub_houseLeakLanes(const building_struct* const building[], houseState_struct* const state[], const weatherSample_struct* const weather[],
+	solver_struct solver[], const int active[], int lanes) {
+	sub_bisectLanes(&houseState_struct::Pint, &houseLeak_struct::dPint, building, state, weather, solver, active, lanes);
+}
+
+// The locals of one sub_atticLeak call, split as for sub_houseLeak (see houseLeak_struct): f_balance() sums the mass
+// flows in and out of the attic at state.Patticint.
+struct atticLeak_struct {
+	void begin(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather);
+	double f_balance(const building_struct& building, houseState_struct& state);
+	void end(houseState_struct& state, solver_struct& solver);
+
+	double dtheta;
 	double Matticwall[4];
 	double Matticwallin[4];
 	double Matticwallout[4];
@@ -1513,11 +1480,18 @@ void sub_atticLeak (
 	double dPatticint;
 	double Croof;
 	double Cpr;
-	double Broofo = 0;
-	double Mroof = 0;
-	double dProoftop = 0;
-	double dProofbottom = 0;
+	double Broofo;
+	double Mroof;
+	double dProoftop;
+	double dProofbottom;
 	double CPvar;
+};
+
+void atticLeak_struct::begin(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather) {
+	Broofo = 0;
+	Mroof = 0;
+	dProoftop = 0;
+	dProofbottom = 0;
 
 	dtheta = 11.3;
 
@@ -1538,11 +1512,11 @@ void sub_atticLeak (
 	//rhou = airDensityRef * airTempRef / tempOut;
 	//rhoa = airDensityRef * airTempRef / tempAttic;
 
-	mAtticFloor = -mCeiling;
+	mAtticFloor = -state.flow.mCeiling;
 
 	// the following are pressure differences common to all the flow equations
-	dPwind = airDensityOUT / 2 * pow(windSpeed, 2);
-	dPtemp = airDensityOUT * g * (tempAttic - tempOut) / tempAttic;
+	dPwind = state.airDensityOUT / 2 * pow(state.windSpeed, 2);
+	dPtemp = state.airDensityOUT * g * (state.tempAttic - state.tempOut) / state.tempAttic;
 
 	/*if(dPwind == 0 && dPtemp == 0) {
 		Qnet = 0;
@@ -1550,17 +1524,17 @@ void sub_atticLeak (
 	}*/
 
 	// the following are some typical pressure coefficients for pitched roofs
-	if(roofPitch < 10) {
+	if(building.roofPitch < 10) {
 		Cproof[0] = -.8;
 		Cproof[1] = -.4;
-	} else if(roofPitch > 30) {
+	} else if(building.roofPitch > 30) {
 		Cproof[0] = .3;
 		Cproof[1] = -.5;
 	} else {
 		Cproof[0] = -.4;
 		Cproof[1] = -.4;
 	}
-	if(strUppercase(rowOrIsolated) == "R") {
+	if(strUppercase(building.rowOrIsolated) == "R") {
 		Cproof[2] = -.2;
 		Cproof[3] = -.2;
 	} else {
@@ -1568,10 +1542,10 @@ void sub_atticLeak (
 		Cproof[2] = -.6;
 		Cproof[3] = -.6;
 	}
-	if(strUppercase(roofPeakOrient) == "D") {
+	if(strUppercase(building.roofPeakOrient) == "D") {
 		Cproof[2] = Cproof[0];
 		Cproof[3] = Cproof[1];
-		if(strUppercase(rowOrIsolated) == "R") {
+		if(strUppercase(building.rowOrIsolated) == "R") {
 			Cproof[0] = -.2;
 			Cproof[1] = -.2;
 		} else {
@@ -1595,7 +1569,7 @@ void sub_atticLeak (
 	// here the variation of each wall Cp with wind angle is accounted for:
 	// for row houses:
 
-	if(strUppercase(rowOrIsolated) == "R") {
+	if(strUppercase(building.rowOrIsolated) == "R") {
 		CP[0][2] = -.2;
 		CP[0][3] = -.2;
 		CP[1][2] = -.2;
@@ -1613,125 +1587,152 @@ void sub_atticLeak (
 	}
 
 	// f_CpTheta CP(), windAngle, wallCp()
-	f_CpTheta(CP, windAngle, wallCp);
+	f_CpTheta(CP, weather.direction, wallCp);
 
 	// for pitched roof leaks
-	f_roofCpTheta(Cproof, windAngle, Cppitch, roofPitch);
+	f_roofCpTheta(Cproof, weather.direction, Cppitch, building.roofPitch);
 	
-	if(flag < 2) {
-		Patticint = 0;            // a reasonable first guess
+	if(state.flag < 2) {
+		state.Patticint = 0;            // a reasonable first guess
 		dPatticint = 25;
 	} else {
 		dPatticint = .25;
 	}
+}
 
-	do {
-		mAtticIN = 0;
-		mAtticOUT = 0;
-		
-		// the following section is for the pitched part of the roof where the two pitched faces are assumed to have the same leakage
-		Croof = atticC * soffitFraction[4] / 2;
-		
-		// for first pitched part either front, above wall 1, or side above wall 3
-		if(strUppercase(roofPeakOrient) == "D") {
-			Cpr = Cppitch[2] * pow(Sw[2], 2);
-		} else {
-			Cpr = Cppitch[0] * pow(Sw[0], 2);
-		}
+double atticLeak_struct::f_balance(const building_struct& building, houseState_struct& state) {
+	state.mAtticIN = 0;
+	state.mAtticOUT = 0;
+	
+	// the following section is for the pitched part of the roof where the two pitched faces are assumed to have the same leakage
+	Croof = building.atticC * building.soffitFraction[4] / 2;
+	
+	// for first pitched part either front, above wall 1, or side above wall 3
+	if(strUppercase(building.roofPeakOrient) == "D") {
+		Cpr = Cppitch[2] * pow(state.Sw[2], 2);
+	} else {
+		Cpr = Cppitch[0] * pow(state.Sw[0], 2);
+	}
 
-		// the neutral level is calculated separately for each roof roofPitch
-		f_neutralLevel3(dPtemp, dPwind, Patticint, Cpr, Broofo, roofPeakHeight);
-		
-		// developed from wallflow3:
-		f_roofFlow(tempAttic, tempOut, airDensityATTIC, airDensityOUT, Broofo, Cpr, atticPressureExp, Croof, roofPeakHeight, Patticint, dPtemp, dPwind, Mroof, Matticwallin[0], Matticwallout[0], dProoftop, dProofbottom, h);
+	// the neutral level is calculated separately for each roof roofPitch
+	f_neutralLevel3(dPtemp, dPwind, state.Patticint, Cpr, Broofo, building.roofPeakHeight);
+	
+	// developed from wallflow3:
+	f_roofFlow(state.tempAttic, state.tempOut, state.airDensityATTIC, state.airDensityOUT, Broofo, Cpr, building.atticPressureExp, Croof, building.roofPeakHeight, state.Patticint, dPtemp, dPwind, Mroof, Matticwallin[0], Matticwallout[0], dProoftop, dProofbottom, building.h);
 
-		mAtticIN = mAtticIN + Matticwallin[0];
-		mAtticOUT = mAtticOUT + Matticwallout[0];
+	state.mAtticIN = state.mAtticIN + Matticwallin[0];
+	state.mAtticOUT = state.mAtticOUT + Matticwallout[0];
 
-		// for second pitched part either back, above wall 2, or side above wall 4
-		if(strUppercase(roofPeakOrient) == "D") {
-			Cpr = Cppitch[3] * pow(Sw[3], 2);
-		} else {
-			Cpr = Cppitch[1] * pow(Sw[1], 2);
-		}
+	// for second pitched part either back, above wall 2, or side above wall 4
+	if(strUppercase(building.roofPeakOrient) == "D") {
+		Cpr = Cppitch[3] * pow(state.Sw[3], 2);
+	} else {
+		Cpr = Cppitch[1] * pow(state.Sw[1], 2);
+	}
 
-		f_neutralLevel3(dPtemp, dPwind, Patticint, Cpr, Broofo, roofPeakHeight);
+	f_neutralLevel3(dPtemp, dPwind, state.Patticint, Cpr, Broofo, building.roofPeakHeight);
 
-		// developed from wallflow3:
-		f_roofFlow(tempAttic, tempOut, airDensityATTIC, airDensityOUT, Broofo, Cpr, atticPressureExp, Croof, roofPeakHeight, Patticint, dPtemp, dPwind, Mroof, Matticwallin[1], Matticwallout[1], dProoftop, dProofbottom, h);
+	// developed from wallflow3:
+	f_roofFlow(state.tempAttic, state.tempOut, state.airDensityATTIC, state.airDensityOUT, Broofo, Cpr, building.atticPressureExp, Croof, building.roofPeakHeight, state.Patticint, dPtemp, dPwind, Mroof, Matticwallin[1], Matticwallout[1], dProoftop, dProofbottom, building.h);
 
-		mAtticIN = mAtticIN + Matticwallin[1];
-		mAtticOUT = mAtticOUT + Matticwallout[1];
+	state.mAtticIN = state.mAtticIN + Matticwallin[1];
+	state.mAtticOUT = state.mAtticOUT + Matticwallout[1];
 
-		for(int i=0; i < numAtticVents; i++) {
+	for(int i=0; i < building.numAtticVents; i++) {
 
-			// FF: This if is to counter the 0 index out of bound present in BASIC version
-			// example: if atticVent[i].wall = 0 then it would look for Sw[0] in BASIC version, which defaults to 0 while in the C++ version
-			// it would try to find Sw[-1] and cause error. Original version:
-			// CPvar = pow(Sw[atticVent[i].wall], 2) * Cppitch[atticVent[i].wall];
-			if(atticVent[i].wall - 1 >= 0)
-				CPvar = pow(Sw[atticVent[i].wall - 1], 2) * Cppitch[atticVent[i].wall - 1];
-			else
-				CPvar = 0;
+		// FF: This if is to counter the 0 index out of bound present in BASIC version
+		// example: if atticVent[i].wall = 0 then it would look for Sw[0] in BASIC version, which defaults to 0 while in the C++ version
+		// it would try to find Sw[-1] and cause error. Original version:
+		// CPvar = pow(Sw[atticVent[i].wall], 2) * Cppitch[atticVent[i].wall];
+		if(state.atticVent[i].wall - 1 >= 0)
+			CPvar = pow(state.Sw[state.atticVent[i].wall - 1], 2) * Cppitch[state.atticVent[i].wall - 1];
+		else
+			CPvar = 0;
 
-			f_atticVentFlow(airDensityOUT, airDensityATTIC, CPvar, dPwind, dPtemp, Patticint, atticVent[i], tempAttic, tempOut, airTempRef);
-			
-			if(atticVent[i].m >= 0) {
-				mAtticIN = mAtticIN + atticVent[i].m;
-			} else {
-				mAtticOUT = mAtticOUT + atticVent[i].m;
-			}
+		f_atticVentFlow(state.airDensityOUT, state.airDensityATTIC, CPvar, dPwind, dPtemp, state.Patticint, state.atticVent[i], state.tempAttic, state.tempOut, building.airTempRef);
+		
+		if(state.atticVent[i].m >= 0) {
+			state.mAtticIN = state.mAtticIN + state.atticVent[i].m;
+		} else {
+			state.mAtticOUT = state.mAtticOUT + state.atticVent[i].m;
 		}
-		// note that gable vents are the same as soffits
-		for(int i=0; i < 4; i++) {
-			CPvar = pow(Sw[i], 2) * wallCp[i];
+	}
+	// note that gable vents are the same as soffits
+	for(int i=0; i < 4; i++) {
+		CPvar = pow(state.Sw[i], 2) * wallCp[i];
 
-			f_soffitFlow(airDensityOUT, airDensityATTIC, CPvar, dPwind, dPtemp, Patticint, soffit[i], soffitFraction[i], atticC, atticPressureExp, tempAttic, tempOut, airTempRef);
+		f_soffitFlow(state.airDensityOUT, state.airDensityATTIC, CPvar, dPwind, dPtemp, state.Patticint, state.soffit[i], building.soffitFraction[i], building.atticC, building.atticPressureExp, state.tempAttic, state.tempOut, building.airTempRef);
 
-			if(soffit[i].m >= 0)
-				mAtticIN = mAtticIN + soffit[i].m;
-			else
-				mAtticOUT = mAtticOUT + soffit[i].m;
-		}
-		
-		for(int i=0; i < numAtticFans; i++) {
-			if(atticFan[i].on == 1) {        // for cycling fans hey will somtimes be off and we don;t want ot include them
+		if(state.soffit[i].m >= 0)
+			state.mAtticIN = state.mAtticIN + state.soffit[i].m;
+		else
+			state.mAtticOUT = state.mAtticOUT + state.soffit[i].m;
+	}
+	
+	for(int i=0; i < building.numAtticFans; i++) {
+		if(state.atticFan[i].on == 1) {        // for cycling fans hey will somtimes be off and we don;t want ot include them
 
-				f_atticFanFlow(atticFan[i], airDensityOUT, airDensityATTIC);
+			f_atticFanFlow(state.atticFan[i], state.airDensityOUT, state.airDensityATTIC);
 
-				if(atticFan[i].m >= 0)
-					mAtticIN = mAtticIN + atticFan[i].m;
-				else
-					mAtticOUT = mAtticOUT + atticFan[i].m;
-			}
+			if(state.atticFan[i].m >= 0)
+				state.mAtticIN = state.mAtticIN + state.atticFan[i].m;
+			else
+				state.mAtticOUT = state.mAtticOUT + state.atticFan[i].m;
 		}
+	}
 
-		// Attic floor flow is determined first by HOUSELEAK
-		// this fixed flow rate will fix the Patticint that is then
-		// passed back to HOUSELEAK as the interior pressure of the attic
+	// Attic floor flow is determined first by HOUSELEAK
+	// this fixed flow rate will fix the Patticint that is then
+	// passed back to HOUSELEAK as the interior pressure of the attic
 
-		// note that mattic floor has a sign change so that inflow to the attic is positive for a negative mCeiling
-		if(mAtticFloor >= 0)
-			mAtticIN = mAtticIN + mAtticFloor - mSupAHoff - mRetAHoff;
-		else
-			mAtticOUT = mAtticOUT + mAtticFloor - mSupAHoff - mRetAHoff;
+	// note that mattic floor has a sign change so that inflow to the attic is positive for a negative mCeiling
+	if(mAtticFloor >= 0)
+		state.mAtticIN = state.mAtticIN + mAtticFloor - state.flow.mSupAHoff - state.flow.mRetAHoff;
+	else
+		state.mAtticOUT = state.mAtticOUT + mAtticFloor - state.flow.mSupAHoff - state.flow.mRetAHoff;
+
+	state.mAtticIN = state.mAtticIN + state.flow.mSupLeak;
+	state.mAtticOUT = state.mAtticOUT + state.flow.mRetLeak;
 
-		mAtticIN = mAtticIN + mSupLeak;
-		mAtticOUT = mAtticOUT + mRetLeak;
+	return state.mAtticIN + state.mAtticOUT;
+}
 
-		Patticint = Patticint - sgn(mAtticIN + mAtticOUT) * dPatticint;
-		dPatticint = dPatticint / 2;
-	} while(dPatticint > .0001);
+void atticLeak_struct::end(houseState_struct& state, solver_struct& solver) {
+	solver.residual = abs(state.mAtticIN + state.mAtticOUT);		// Mass imbalance at the last pressure tried [kg/s]
 
 	if(mAtticFloor >= 0) {
-		matticenvin = mAtticIN - mAtticFloor - mSupLeak + mSupAHoff + mRetAHoff;
-		matticenvout = mAtticOUT - mRetLeak;
+		state.flow.matticenvin = state.mAtticIN - mAtticFloor - state.flow.mSupLeak + state.flow.mSupAHoff + state.flow.mRetAHoff;
+		state.flow.matticenvout = state.mAtticOUT - state.flow.mRetLeak;
 	} else {
-		matticenvin = mAtticIN - mSupLeak;
-		matticenvout = mAtticOUT - mAtticFloor - mRetLeak + mSupAHoff + mRetAHoff;
+		state.flow.matticenvin = state.mAtticIN - state.flow.mSupLeak;
+		state.flow.matticenvout = state.mAtticOUT - mAtticFloor - state.flow.mRetLeak + state.flow.mSupAHoff + state.flow.mRetAHoff;
 	}
 }
 
+void sub_atticLeak(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather, solver_struct& solver) {
+	PROFILE_COUNT(PROF_ATTICLEAK);
+	CAPTURE_CALL(f_captureAtticLeak(building, state, weather));
+
+	atticLeak_struct leak;
+
+	leak.begin(building, state, weather);
+
+	solver.iterations = 0;
+
+	do {
+		solver.iterations++;
+		state.Patticint = state.Patticint - sgn(leak.f_balance(building, state)) * leak.dPatticint;
+		leak.dPatticint = leak.dPatticint / 2;
+	} while(leak.dPatticint > .0001);
+
+	leak.end(state, solver);
+}
+
+void sub_atticLeakLanes(const building_struct* const building[], houseState_struct* const state[], const weatherSample_struct* const weather[],
+	solver_struct solver[], const int active[], int lanes) {
+	sub_bisectLanes(&houseState_struct::Patticint, &atticLeak_struct::dPatticint, building, state, weather, solver, active, lanes);
+}
+
 void sub_filterLoading ( 
 	int& MERV,
 	int& loadingRate,
@@ -2001,7 +2002,8 @@ int sgn(double sgnvar) {
 }
 
 
-void f_CpTheta(double CP[4][4], double& windAngle, double* wallCp) {
+void f_CpTheta(double CP[4][4], const double& windAngle, double* wallCp) {
+	CAPTURE_CALL(f_captureCpTheta(CP, windAngle, wallCp));
 	// this function takes Cps from a single wind angle perpendicular to the
 	// upwind wall and finds Cps for all the walls for any wind angle
 	
@@ -2028,8 +2030,10 @@ void f_CpTheta(double CP[4][4], double& windAngle, double* wallCp) {
 	}
 }
 
-void f_flueFlow(double& tempHouse, double& flueShelterFactor, double& dPwind, double& dPtemp, double& h, double& Pint, int& numFlues, flue_struct* flue, double& mFlue,
-	double& airDensityOUT, double& airDensityIN, double& dPflue, double& tempOut, double& Aeq, double& airTempRef, double& houseVolume, double& windPressureExp, double& Q622) {
+void f_flueFlow(const double& tempHouse, const double& flueShelterFactor, const double& dPwind, const double& dPtemp, const double& h,
+	const double& Pint, const int& numFlues, const flue_struct* flue, double& mFlue, const double& airDensityOUT,
+	const double& airDensityIN, double& dPflue, const double& tempOut, const double& Aeq, const double& airTempRef,
+	const double& houseVolume, const double& windPressureExp, const double& Q622) {
 
 		// calculates flow through the flue
 
@@ -2096,8 +2100,8 @@ void f_flueFlow(double& tempHouse, double& flueShelterFactor, double& dPwind, do
 }
 
 
-void f_floorFlow3(double& Cfloor, double& Cpfloor, double& dPwind, double& Pint, double& C,
-	double& n, double& mFloor, double& airDensityOUT, double& airDensityIN, double& dPfloor, double& Hfloor, double& dPtemp) {
+void f_floorFlow3(const double& Cfloor, const double& Cpfloor, const double& dPwind, const double& Pint, const double& C, const double& n,
+	double& mFloor, const double& airDensityOUT, const double& airDensityIN, double& dPfloor, const double& Hfloor, const double& dPtemp) {
 
 		// calculates flow through floor level leaks
 		dPfloor = Pint + Cpfloor * dPwind - Hfloor * dPtemp;
@@ -2108,10 +2112,11 @@ void f_floorFlow3(double& Cfloor, double& Cpfloor, double& dPwind, double& Pint,
 			mFloor = -airDensityIN * Cfloor * pow(-dPfloor,n);
 }
 
-void f_ceilingFlow(int& AHflag, double& R, double& X, double& Patticint, double& h, double& dPtemp,
-	double& dPwind, double& Pint, double& C, double& n, double& mCeiling, double& atticC, double& airDensityATTIC,
-	double& airDensityIN, double& dPceil, double& tempAttic, double& tempHouse, double& tempOut, double& airDensityOUT,
-	double& mSupAHoff, double& mRetAHoff, double& supC, double& supn, double& retC, double& retn, double& ceilingC) {
+void f_ceilingFlow(const int& AHflag, const double& R, const double& X, const double& Patticint, const double& h, const double& dPtemp,
+	const double& dPwind, const double& Pint, const double& C, const double& n, double& mCeiling, const double& atticC,
+	const double& airDensityATTIC, const double& airDensityIN, double& dPceil, const double& tempAttic, const double& tempHouse,
+	const double& tempOut, const double& airDensityOUT, double& mSupAHoff, double& mRetAHoff, const double& supC, const double& supn,
+	const double& retC, const double& retn, const double& ceilingC) {
 
 		//double ceilingC;
 
@@ -2151,7 +2156,8 @@ void f_ceilingFlow(int& AHflag, double& R, double& X, double& Patticint, double&
 		}
 }
 
-void f_neutralLevel2(double& dPtemp, double& dPwind, double* Sw, double& Pint, double* wallCp, double* Bo, double& h) {
+void f_neutralLevel2(const double& dPtemp, const double& dPwind, const double* Sw, const double& Pint, const double* wallCp, double* Bo,
+	const double& h) {
 	// calculates the neutral level for each wall
 	for(int i=0; i < 4; i++) {
 		if(dPtemp)
@@ -2161,9 +2167,11 @@ void f_neutralLevel2(double& dPtemp, double& dPwind, double* Sw, double& Pint, d
 	}
 }
 
-void f_wallFlow3(double& tempHouse, double& tempOut, double& airDensityIN, double& airDensityOUT, double& Bo, double& wallCp,
-	double& n, double& Cwall, double& h, double& Pint, double& dPtemp, double& dPwind, double& Mwall,
-	double& Mwallin, double& Mwallout, double& dPwalltop, double& dPwallbottom, double& Hfloor) {
+void f_wallFlow3(const double& tempHouse, const double& tempOut, const double& airDensityIN, const double& airDensityOUT, const double& Bo,
+	const double& wallCp, const double& n, const double& Cwall, const double& h, const double& Pint, const double& dPtemp,
+	const double& dPwind, double& Mwall, double& Mwallin, double& Mwallout, double& dPwalltop, double& dPwallbottom, const double& Hfloor) {
+		CAPTURE_CALL(f_captureWallFlow3(tempHouse, tempOut, airDensityIN, airDensityOUT, Bo, wallCp, n, Cwall, h, Pint, dPtemp, dPwind,
+			Mwall, Mwallin, Mwallout, dPwalltop, dPwallbottom, Hfloor));
 		
 		// calculates the flow through a wall
 		double Hwall = h - Hfloor;
@@ -2214,7 +2222,7 @@ void f_wallFlow3(double& tempHouse, double& tempOut, double& airDensityIN, doubl
 		Mwall = Mwallin + Mwallout;
 }
 
-void f_fanFlow(fan_struct& fan, double& airDensityOUT, double& airDensityIN) {
+void f_fanFlow(fan_struct& fan, const double& airDensityOUT, const double& airDensityIN) {
 	
 	// calculates flow through ventilation fans
 	if(fan.q < 0)
@@ -2223,8 +2231,8 @@ void f_fanFlow(fan_struct& fan, double& airDensityOUT, double& airDensityIN) {
 		fan.m = airDensityOUT * fan.q;
 }
 
-void f_pipeFlow(double& airDensityOUT, double& airDensityIN, double& CP, double& dPwind, double& dPtemp,
-	double& Pint, pipe_struct& Pipe, double& tempHouse, double& tempOut, double& airTempRef) {
+void f_pipeFlow(const double& airDensityOUT, const double& airDensityIN, const double& CP, const double& dPwind, const double& dPtemp,
+	const double& Pint, pipe_struct& Pipe, const double& tempHouse, const double& tempOut, const double& airTempRef) {
 		
 		// calculates flow through pipes
 		// changed on NOV 7 th 1990 so Pipe.A is Cpipe
@@ -2242,8 +2250,10 @@ void f_pipeFlow(double& airDensityOUT, double& airDensityIN, double& CP, double&
 			Pipe.m = -airDensityIN * Pipe.A * pow((airTempRef / tempHouse), (3 * Pipe.n - 2)) * pow(-Pipe.dP, Pipe.n);
 }
 
-void f_winDoorFlow(double& tempHouse, double& tempOut, double& airDensityIN, double& airDensityOUT, double& h, double& Bo,
-	double& wallCp, double& n, double& Pint, double& dPtemp, double& dPwind, winDoor_struct& winDoor) {
+void f_winDoorFlow(const double& tempHouse, const double& tempOut, const double& airDensityIN, const double& airDensityOUT, const double& h,
+	const double& Bo, const double& wallCp, const double& n, const double& Pint, const double& dPtemp, const double& dPwind,
+	winDoor_struct& winDoor) {
+		CAPTURE_CALL(f_captureWinDoorFlow(tempHouse, tempOut, airDensityIN, airDensityOUT, h, Bo, wallCp, n, Pint, dPtemp, dPwind, winDoor));
 
 		// calculates flow through open doors or windows
 
@@ -2343,7 +2353,7 @@ void f_winDoorFlow(double& tempHouse, double& tempOut, double& airDensityIN, dou
 		winDoor.m = winDoor.mIN + winDoor.mOUT;
 }
 
-void f_roofCpTheta(double* Cproof, double& windAngle, double* Cppitch, double& roofPitch) {
+void f_roofCpTheta(const double* Cproof, const double& windAngle, double* Cppitch, const double& roofPitch) {
 	
 	double Theta;
 	double C2;
@@ -2385,7 +2395,8 @@ void f_roofCpTheta(double* Cproof, double& windAngle, double* Cppitch, double& r
 	}
 }
 
-void f_neutralLevel3(double& dPtemp, double& dPwind, double& Patticint, double& Cpr, double& Broofo, double& roofPeakHeight) {
+void f_neutralLevel3(const double& dPtemp, const double& dPwind, const double& Patticint, const double& Cpr, double& Broofo,
+	const double& roofPeakHeight) {
 	// calculates the neutral level for the attic
 	if(dPtemp != 0)
 		Broofo = (Patticint + dPwind * Cpr) / dPtemp / roofPeakHeight;
@@ -2395,9 +2406,10 @@ void f_neutralLevel3(double& dPtemp, double& dPwind, double& Patticint, double&
 
 
 
-void f_roofFlow(double& tempAttic, double& tempOut, double& airDensityATTIC, double& airDensityOUT, double& Broofo, double& Cpr,
-	double& atticPressureExp, double& Croof, double& roofPeakHeight, double& Patticint, double& dPtemp, double& dPwind,
-	double& Mroof, double& Mroofin, double& Mroofout, double& dProoftop, double& dProofbottom, double& H) {
+void f_roofFlow(const double& tempAttic, const double& tempOut, const double& airDensityATTIC, const double& airDensityOUT,
+	const double& Broofo, const double& Cpr, const double& atticPressureExp, const double& Croof, const double& roofPeakHeight,
+	const double& Patticint, const double& dPtemp, const double& dPwind, double& Mroof, double& Mroofin, double& Mroofout,
+	double& dProoftop, double& dProofbottom, const double& H) {
 		
 		double Hroof;
 		double dummy1;
@@ -2450,8 +2462,9 @@ void f_roofFlow(double& tempAttic, double& tempOut, double& airDensityATTIC, dou
 		Mroof = Mroofin + Mroofout;
 }
 
-void f_atticVentFlow(double& airDensityOUT, double& airDensityATTIC, double& CP, double& dPwind, double& dPtemp, double& Patticint,
-	atticVent_struct& atticVent, double& tempAttic, double& tempOut, double& airTempRef) {
+void f_atticVentFlow(const double& airDensityOUT, const double& airDensityATTIC, const double& CP, const double& dPwind,
+	const double& dPtemp, const double& Patticint, atticVent_struct& atticVent, const double& tempAttic, const double& tempOut,
+	const double& airTempRef) {
 
 		// calculates flow through attic roof vents
 		atticVent.dP = Patticint - dPtemp * atticVent.h + dPwind * CP;
@@ -2462,8 +2475,9 @@ void f_atticVentFlow(double& airDensityOUT, double& airDensityATTIC, double& CP,
 			atticVent.m = -airDensityATTIC * atticVent.A * pow((airTempRef / tempAttic), (3 * atticVent.n - 2)) * pow(-atticVent.dP, atticVent.n);
 }
 
-void f_soffitFlow(double& airDensityOUT, double& airDensityATTIC, double& CP, double& dPwind, double& dPtemp, double& Patticint,
-	soffit_struct& soffit, double& soffitFraction, double& atticC, double& atticPressureExp, double& tempAttic, double& tempOut, double& airTempRef) {
+void f_soffitFlow(const double& airDensityOUT, const double& airDensityATTIC, const double& CP, const double& dPwind, const double& dPtemp,
+	const double& Patticint, soffit_struct& soffit, const double& soffitFraction, const double& atticC, const double& atticPressureExp,
+	const double& tempAttic, const double& tempOut, const double& airTempRef) {
 		
 		// calculates flow through attic soffit vents and Gable end vents	
 		soffit.dP = Patticint - dPtemp * soffit.h + dPwind * CP;
@@ -2474,7 +2488,7 @@ void f_soffitFlow(double& airDensityOUT, double& airDensityATTIC, double& CP, do
 			soffit.m = -airDensityATTIC * soffitFraction * atticC * pow((airTempRef / tempAttic), (3 * atticPressureExp - 2)) * pow(-soffit.dP, atticPressureExp);
 }
 
-void f_atticFanFlow(fan_struct& atticFan, double& airDensityOUT, double& airDensityATTIC) {
+void f_atticFanFlow(fan_struct& atticFan, const double& airDensityOUT, const double& airDensityATTIC) {
 	
 	// calculates flow through ventilation fans
 	if(atticFan.q < 0)
@@ -2486,6 +2500,7 @@ void f_atticFanFlow(fan_struct& atticFan, double& airDensityOUT, double& airDens
 // ----- MatSEqn definitions -----
 
 int MatSEqn(double A[][ArraySize], double* b, int asize, int asize2, int bsize) {
+	CAPTURE_CALL(f_captureMatSEqn(A, b, asize, asize2, bsize));
 	// Error codes returned:
 	//      0  no error                     -1  matrix not invertible
 	//     -2  matrix not square            -3  inner dimensions different
@@ -2513,7 +2528,7 @@ int MatSEqn(double A[][ArraySize], double* b, int asize, int asize2, int bsize)
 
 	if(continuevar != -1) {
 		errcode = (errcode + 5) % 200 - 5;
-		cout << "\nMatSeqn continue error: " << errcode << endl;
+		sub_report("\nMatSeqn continue error: " + to_string((long long) errcode));
 		return errcode;	
 	}
 	
@@ -2521,7 +2536,7 @@ int MatSEqn(double A[][ArraySize], double* b, int asize, int asize2, int bsize)
 	if(asize != bsize) {
 		ERR = 197;
 		errcode = (ERR + 5) % 200 - 5;
-		cout << "\nMatSeqn size error: " << errcode << endl;
+		sub_report("\nMatSeqn size error: " + to_string((long long) errcode));
 		return errcode;
 	}
 	
@@ -2533,7 +2548,7 @@ int MatSEqn(double A[][ArraySize], double* b, int asize, int asize2, int bsize)
 
 	if(errcode !=0) {
 		errcode = (errcode + 5) % 200 - 5;
-		cout << "\nMatSeqn error: " << errcode << endl;
+		sub_report("\nMatSeqn error: " + to_string((long long) errcode));
 		return errcode;
 	}
 	
@@ -2562,7 +2577,7 @@ int matlu(double A[][ArraySize], int* rpvt, int* cpvt, int asize, int asize2, in
 	if(asize != asize2) {
 		errcode = 198;
 		continuevar = 0;
-		cout << "\nMatlu error: " << errcode << endl;
+		sub_report("\nMatlu error: " + to_string((long long) errcode));
 		return errcode;
 	}
 
@@ -2582,7 +2597,7 @@ int matlu(double A[][ArraySize], int* rpvt, int* cpvt, int asize, int asize2, in
 		if(rownorm[row] == 0) {
 			errcode = 199;
 			continuevar = 0;
-			cout << "\nMatlu error: " << errcode << endl;
+			sub_report("\nMatlu error: " + to_string((long long) errcode));
 			return errcode;
 		}
 	}
@@ -2610,7 +2625,7 @@ int matlu(double A[][ArraySize], int* rpvt, int* cpvt, int asize, int asize2, in
 		if(max == 0) {
 			errcode = 199;
 			continuevar = 0;
-			cout << "\nMatlu error: " << errcode << endl;
+			sub_report("\nMatlu error: " + to_string((long long) errcode));
 			return errcode;
 		} else if(pvt > 1 && max < (deps * oldmax)) {				// check if drop in pivots is too much
 			errcode = 199;
@@ -2656,7 +2671,7 @@ int matlu(double A[][ArraySize], int* rpvt, int* cpvt, int asize, int asize2, in
 	if(A[rpvt[asize-1]][cpvt[asize-1]] == 0) {
 		errcode = 199;
 		continuevar = 0;
-		cout << "\nMatlu error: " << errcode << endl;
+		sub_report("\nMatlu error: " + to_string((long long) errcode));
 		return errcode;
 	} else if(((abs(A[rpvt[asize-1]][cpvt[asize-1]])) / rownorm[rpvt[asize-1]]) < (deps * oldmax)) {
 		// if pivot is not identically zero then continue remains TRUE
@@ -2697,3 +2712,186 @@ int matbs(double A[][ArraySize], double* b, double* x, int* rpvt, int* cpvt, int
 	return 0;
 }
 
+// ----- MatSEqnLanes definitions -----
+
+// A lane that matlu() gives up on gets MatSEqn's messages and error code, and keeps its b
+static void sub_singularLane(int& errcode, int& solving) {
+	sub_report("\nMatlu error: " + to_string((long long) 199));
+	sub_report("\nMatSeqn continue error: " + to_string((long long) -1));
+	errcode = -1;
+	solving = 0;
+}
+
+// MatSEqn() for the 16 node systems of up to MAX_LANES houses, stored lane innermost (A[row][col][lane],
+// b[row][lane]) so that the pivot search, the row operations and the backsolve run across the lanes. The pivot rows
+// and columns are swapped in place, lane by lane, instead of being followed through rpvt and cpvt, which gives each
+// lane the operations that MatSEqn() would apply to it, in the same order. Only the active lanes are solved and
+// written back; a lane found singular is masked off. errcode gets each lane's MatSEqn() code; returns the lanes with
+// a nonzero one.
+int MatSEqnLanes(double A[][ArraySize][MAX_LANES], double b[][MAX_LANES], const int active[], int errcode[], int lanes) {
+	const int asize = ArraySize;
+
+	double rownorm[ArraySize][MAX_LANES];
+	double y[ArraySize][MAX_LANES];					// b, with its rows swapped as those of A
+	double x[ArraySize][MAX_LANES];
+	int cpos[ArraySize][MAX_LANES];					// Unknown now in each column
+	double max[MAX_LANES];
+	double oldmax[MAX_LANES];
+	int bestrow[MAX_LANES];
+	int bestcol[MAX_LANES];
+	int solving[MAX_LANES];
+	int errors = 0;
+
+	for(int l=0; l < lanes; l++) {
+		solving[l] = active[l];
+		errcode[l] = 0;
+		oldmax[l] = 0;
+	}
+
+	for(int row = 0; row < asize; row++) {
+		for(int l=0; l < lanes; l++) {
+			rownorm[row][l] = 0;
+			y[row][l] = b[row][l];
+			cpos[row][l] = row;
+		}
+		for(int col = 0; col < asize; col++) {
+			for(int l=0; l < lanes; l++) {
+				rownorm[row][l] = rownorm[row][l] + abs(A[row][col][l]);
+			}
+		}
+	}
+
+	// if any rownorm is zero, the matrix is singular
+	for(int l=0; l < lanes; l++) {
+		for(int row = 0; row < asize && solving[l]; row++) {
+			if(rownorm[row][l] == 0)
+				sub_singularLane(errcode[l], solving[l]);
+		}
+	}
+
+	for(int pvt = 0; pvt < (asize-1); pvt++) {
+		// Find best available pivot, as matlu()
+		for(int l=0; l < lanes; l++) {
+			max[l] = 0;
+			bestrow[l] = pvt;
+			bestcol[l] = pvt;
+		}
+
+		for(int row = pvt; row < asize; row++) {
+			for(int col = pvt; col < asize; col++) {
+				for(int l=0; l < lanes; l++) {
+					double temp = abs(A[row][col][l]) / rownorm[row][l];
+					int better = temp > max[l];
+					max[l] = better ? temp : max[l];
+					bestrow[l] = better ? row : bestrow[l];
+					bestcol[l] = better ? col : bestcol[l];
+				}
+			}
+		}
+
+		for(int l=0; l < lanes; l++) {
+			if(!solving[l])
+				continue;
+			if(max[l] == 0)
+				sub_singularLane(errcode[l], solving[l]);
+			else if(pvt > 1 && max[l] < (deps * oldmax[l]))		// check if drop in pivots is too much
+				errcode[l] = 199;
+			oldmax[l] = max[l];
+		}
+
+		// Bring each lane's pivot to [pvt][pvt]
+		for(int l=0; l < lanes; l++) {
+			int r = bestrow[l];
+			int c = bestcol[l];
+			double temp;
+
+			if(r != pvt) {
+				for(int col = 0; col < asize; col++) {
+					temp = A[pvt][col][l];
+					A[pvt][col][l] = A[r][col][l];
+					A[r][col][l] = temp;
+				}
+				temp = rownorm[pvt][l];
+				rownorm[pvt][l] = rownorm[r][l];
+				rownorm[r][l] = temp;
+				temp = y[pvt][l];
+				y[pvt][l] = y[r][l];
+				y[r][l] = temp;
+			}
+
+			if(c != pvt) {
+				for(int row = 0; row < asize; row++) {
+					temp = A[row][pvt][l];
+					A[row][pvt][l] = A[row][c][l];
+					A[row][c][l] = temp;
+				}
+				int tempswap = cpos[pvt][l];
+				cpos[pvt][l] = cpos[c][l];
+				cpos[c][l] = tempswap;
+			}
+		}
+
+		// Eliminate all values below the pivot
+		for(int row = (pvt+1); row < asize; row++) {
+			for(int l=0; l < lanes; l++) {
+				A[row][pvt][l] = -A[row][pvt][l] / A[pvt][pvt][l];		// save multipliers
+			}
+			for(int col = (pvt+1); col < asize; col++) {
+				for(int l=0; l < lanes; l++) {
+					A[row][col][l] = A[row][col][l] + A[row][pvt][l] * A[pvt][col][l];
+				}
+			}
+		}
+	}
+
+	// if last pivot is zero or pivot drop is too large, A is singular
+	for(int l=0; l < lanes; l++) {
+		if(!solving[l])
+			continue;
+		if(A[asize-1][asize-1][l] == 0)
+			sub_singularLane(errcode[l], solving[l]);
+		else if((abs(A[asize-1][asize-1][l]) / rownorm[asize-1][l]) < (deps * oldmax[l]))
+			errcode[l] = 199;
+	}
+
+	// do row operations on b using the multipliers in L to find Lb
+	for(int pvt = 0; pvt < (asize-1); pvt++) {
+		for(int row = pvt+1 ; row < asize; row++) {
+			for(int l=0; l < lanes; l++) {
+				y[row][l] = y[row][l] + A[row][pvt][l] * y[pvt][l];
+			}
+		}
+	}
+
+	// backsolve Ux=Lb to find x
+	for(int row = asize-1; row >= 0; row--) {
+		for(int l=0; l < lanes; l++) {
+			x[row][l] = y[row][l];
+		}
+		for(int col = (row+1); col < asize; col++) {
+			for(int l=0; l < lanes; l++) {
+				x[row][l] = x[row][l] - A[row][col][l] * x[col][l];
+			}
+		}
+		for(int l=0; l < lanes; l++) {
+			x[row][l] = x[row][l] / A[row][row][l];
+		}
+	}
+
+	for(int l=0; l < lanes; l++) {
+		if(solving[l]) {
+			for(int row = 0; row < asize; row++) {
+				b[cpos[row][l]][l] = x[row][l];						// Put solution in b for return
+			}
+			if(errcode[l] != 0) {
+				errcode[l] = (errcode[l] + 5) % 200 - 5;
+				sub_report("\nMatSeqn error: " + to_string((long long) errcode[l]));
+			}
+		}
+		if(errcode[l] != 0)
+			errors++;
+	}
+
+	return errors;
+}
+
@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include <string>
+#include "weather.h"
 
 using namespace std;
 
@@ -61,243 +62,212 @@ struct flue_struct {
 	double flueTemp;
 };
 
-// Additional functions
+// Mass flows and duct air velocities that change every minute. Kept together so the per-minute
+// airflow, heat and moisture routines work on one contiguous block rather than dozens of references.
+struct flow_struct {
+	double mAH;				// Mass flow of air through air handler
+	double mSupReg;			// Mass flow out of the supply registers
+	double mRetReg;			// Mass flow into the return registers
+	double mSupLeak;		// Mass flow of the air that leaks from the supply ducts into the attic
+	double mRetLeak;		// Mass flow of the air that leaks from the attic into the return ducts
+	double mSupAHoff;		// Supply duct flow with the air handler off
+	double mRetAHoff;		// Return duct flow with the air handler off
+	double mCeiling;		// Ceiling mass flow (+ve from attic to house)
+	double mHouseIN;		// Envelope mass flow into the house
+	double mHouseOUT;		// Envelope mass flow out of the house
+	double matticenvin;		// Mass flow into the attic through the attic envelope
+	double matticenvout;	// Mass flow out of the attic through the attic envelope
+	double mFanCycler;		// Outside air flow into the return (fan cycler)
+	double mHRV;			// Mass flow of stand-alone HRV unit
+	double mHRV_AH;			// Mass flow of HRV unit integrated with the Air Handler
+	double mERV_AH;			// Mass flow of ERV unit integrated with the Air Handler
+	double supVel;			// Supply air velocity
+	double retVel;			// Return air velocity
+};
+
+// Duct geometry, material properties and leakage. Set once from the building inputs and only read after that.
+struct duct_struct {
+	double ductLocation;
+	double supLength;
+	double retLength;
+	double supDiameter;
+	double retDiameter;
+	double supThickness;
+	double retThickness;
+	double supRval;
+	double retRval;
+	double supArea;			// Surface area of supply ducts [m2]
+	double retArea;			// Surface area of return ducts [m2]
+	double supVolume;		// Volume of supply ducts [m3]
+	double retVolume;		// Volume of return ducts [m3]
+	double supCp;			// Specific heat capacity of supply duct material [j/kg/K]
+	double retCp;			// Specific heat capacity of return duct material [j/kg/K]
+	double suprho;			// Supply duct density [kg/m^3]
+	double retrho;			// Return duct density [kg/m^3]
+	double supC;			// Supply leak flow coefficient
+	double supn;			// Supply leak pressure exponent
+	double retC;			// Return leak flow coefficient
+	double retn;			// Return leak pressure exponent
+};
 
-void sub_heat ( 
-	double& tempOut, 
-	double& airDensityRef, 
-	double& airTempRef, 
-	double& mCeiling, 
-	double& AL4, 
-	double& windSpeed, 
-	double& ssolrad, 
-	double& nsolrad, 
-	double* tempOld, 
-	double& atticVolume, 
-	double& houseVolume, 
-	double& sc, 
-	double* b, 
-	int& ERRCODE, 
-	double& TSKY, 
-	double& floorArea, 
-	double& roofPitch, 
-	double& ductLocation, 
-	double& mSupReg, 
-	double& mRetReg, 
-	double& mRetLeak, 
-	double& mSupLeak, 
-	double& mAH, 
-	double& supRval, 
-	double& retRval, 
-	double& supDiameter, 
-	double& retDiameter, 
-	double& supArea, 
-	double& retArea, 
-	double& supThickness, 
-	double& retThickness, 
-	double& supVolume, 
-	double& retVolume, 
-	double& supCp, 
-	double& retCp, 
-	double& supVel, 
-	double& retVel, 
-	double& suprho, 
-	double& retrho, 
-	double& pRef, 
-	double& HROUT, 
-	double& diffuse, 
-	double& UA, 
-	double& matticenvin, 
-	double& matticenvout, 
-	double& mHouseIN, 
-	double& mHouseOUT, 
-	double& planArea, 
-	double& mSupAHoff, 
-	double& mRetAHoff, 
-	double& solgain, 
-	double& windowS, 
-	double& windowN, 
-	double& windowWE, 
-	double& winShadingCoef, 
-	double& mFanCycler, 
-	double& roofPeakHeight, 
-	double& h, 
-	//double& Whouse,
-	double& retLength,
-	double& supLength,
-	int& roofType,
-	double& M1,
-	double& M12,
-	double& M15,
-	double& M16,
-	double& roofRval,
-	double& rceil,
-	int& AHflag, 
-	double& dtau,
-	double& mERV_AH,
-	double& ERV_SRE,
-	double& mHRV,
-	double& HRV_ASE,
-	double& mHRV_AH,
-	double& SBETA,
-	double& CBETA,
-	double& L,
-	double& dec,
-	double& Csol,
-	int& idirect,
-	double& capacityc,
-	double& capacityh,
-	double& evapcap,
-	double& internalGains,
-	int bsize,
-	double& airDensityIN,
-	double& airDensityOUT,
-	double& airDensityATTIC,
-	double& airDensitySUP,
-	double& airDensityRET,
-	int& numStories,
-	double& storyHeight
-);
+// Heating and cooling delivered by the equipment model in the current minute
+struct equipment_struct {
+	double capacityc;		// Sensible cooling capacity [W]
+	double capacityh;		// Heating capacity including fan heat [W]
+	double evapcap;			// Total evaporator capacity [W]
+	double latcap;			// Latent cooling capacity [W]
+};
 
-void sub_moisture ( 
-	double* HR, 
-	double* hrold, 
-	double& Mw1, 
-	double& Mw2, 
-	double& Mw3, 
-	double& Mw4, 
-	double& Mw5, 
-	double& dtau, 
-	double& matticenvout, 
-	double& mCeiling, 
-	double& mSupAHoff, 
-	double& mRetAHoff, 
-	double& matticenvin, 
-	double& HROUT, 
-	double& mSupLeak, 
-	double& mAH, 
-	double& mRetReg, 
-	double& mRetLeak, 
-	double& mSupReg, 
-	double& latcap, 
-	double& mHouseIN, 
-	double& mHouseOUT, 
-	double& latentLoad, 
-	double& mFanCycler, 
-	double& mHRV_AH,
-	double& mERV_AH, 
-	double& ERV_TRE,
-	double& MWha,
-	double& airDensityIN,
-	double& airDensityOUT
-);
+// Work done by one call to an iterative solver, reported for convergence telemetry
+struct solver_struct {
+	int iterations;			// Passes through the solver loop
+	double residual;		// Change (or imbalance) left at the final pass, in the units of the solved quantity
+};
 
-void sub_houseLeak ( 
-	int& AHflag,
-	double& flag, 
-	double& U, 
-	double& windAngle, 
-	double& tempHouse, 
-	double& tempAttic, 
-	double& tempOut, 
-	double& C, 
-	double& n, 
-	double& h, 
-	double& R, 
-	double& X, 
-	int& numFlues, 
-	flue_struct* flue, 
-	double* wallFraction, 
-	double* floorFraction, 
-	double* Sw, 
-	double& flueShelterFactor, 
-	int& numWinDoor, 
-	winDoor_struct* winDoor, 
-	int& numFans, 
-	fan_struct* fan, 
-	int& numPipes, 
-	pipe_struct* Pipe, 
-	double& mIN, 
-	double& mOUT, 
-	double& Pint, 
-	double& mFlue, 
-	double& mCeiling, 
-	double* mFloor, 
-	double& atticC, 
-	double& dPflue, 
-	double& dPceil, 
-	double& dPfloor, 
-	int& Crawl, 
-	double& Hfloor, 
-	string& row, 
-	double* soffitFraction, 
-	double& Patticint, 
-	double* wallCp, 
-	double& airDensityRef, 
-	double& airTempRef, 
-	double& mSupReg, 
-	double& mAH, 
-	double& mRetLeak, 
-	double& mSupLeak, 
-	double& mRetReg, 
-	double& mHouseIN, 
-	double& mHouseOUT, 
-	double& supC, 
-	double& supn, 
-	double& retC, 
-	double& retn, 
-	double& mSupAHoff, 
-	double& mRetAHoff, 
-	double& Aeq,
-	double& airDensityIN,
-	double& airDensityOUT,
-	double& airDensityATTIC,
-	double& ceilingC,
-	double& houseVolume,
-	double& windPressureExp,
-	double& Q622
-);
+// The building as the airflow, heat and moisture routines see it: inputs and the constants derived from them.
+// Set by init() and only read after that.
+struct building_struct {
+	double n;				// Envelope Pressure Exponent
+	double h;				// Eaves Height [m]
+	double R;				// Ceiling Floor Leakage Sum
+	double X;				// Ceiling Floor Leakage Difference
+	int numFlues;			// Number of flues/chimneys/passive stacks
+	flue_struct flue[6];
+	double flueShelterFactor;	// Shelter factor at the top of the flue (1 if the flue is higher than surrounding obstacles
+	int numPipes;			// Number of passive vents but appears to do much the same as flues
+	int numWinDoor;
+	int numFans;
+	int numAtticVents;
+	int numAtticFans;
+	double wallFraction[4];
+	double floorFraction[4];
+	double soffitFraction[5];
+	int Crawl;
+	double Hfloor;
+	string rowOrIsolated;	// House in a row (R) or isolated (any string other than R)
+	double houseVolume;		// Conditioned volume of house (m3)
+	double floorArea;		// Conditioned floor area (m2)
+	double planArea;		// Footprint of house (m2)
+	int numStories;			// Number of stories in the building (for Nomalized Leakage calculation)
+	double storyHeight;		// Story height (m)
+	double windowWE;
+	double windowN;
+	double windowS;
+	double winShadingCoef;
+	double atticVolume;
+	double atticC;
+	double atticPressureExp;
+	double roofPitch;
+	string roofPeakOrient;	// Roof peak orientation, D = perpendicular to front of house (Wall 1), P = parrallel to front of house
+	double roofPeakHeight;
+	double roofRval;
+	int roofType;
+	duct_struct duct;
+	double latentLoad;
+	double MWha;			// MWha is the moisture transport coefficient that scales with floor area (to scale with surface area of moisture)
+	double Mw5;				// Active mass of moisture in the house (empirical)
+	double HRV_ASE;			// Apparent Sensible Effectiveness of HRV unit
+	double ERV_SRE;			// Sensible Recovery Efficiency of ERV unit
+	double ERV_TRE;			// Total Recovery Efficiency of ERV unit, includes humidity transfer for moisture subroutine
+	double windPressureExp;	// Power law exponent of the wind speed profile at the building site
+	double Q622;			// ASHRAE 62.2 Mechanical Ventilation Rate [ACH]
+	double Aeq;				// Equivalent air change rate of house to meet 62.2 minimum for RIVEC calculations
+	double airDensityRef;	// Reference air density at 20 deg C at sea level [kg/m3]
+	double airTempRef;		// Reference room temp [K] = 20 deg C
+	double dtau;			// Simulation timestep [s]
+	double L;				// Latitude [radians]
+	double massFactor;		// Multiplies the internal mass of the house (calibration_struct in simulation.h)
+};
 
-void sub_atticLeak ( 
-	double& flag, 
-	double& U, 
-	double& windAngle, 
-	double& tempHouse, 
-	double& tempOut, 
-	double& tempAttic, 
-	double& atticC, 
-	double& atticPressureExp, 
-	double& h, 
-	double& roofPeakHeight, 
-	double& flueShelterFactor, 
-	double* Sw, 
-	int& numAtticVents, 
-	atticVent_struct* atticVent, 
-	soffit_struct* soffit, 
-	double& mAtticIN, 
-	double& mAtticOUT, 
-	double& Patticint, 
-	double& mCeiling, 
-	string& row, 
-	double* soffitFraction, 
-	double& roofPitch, 
-	string& roofPeakOrient, 
-	int& numAtticFans, 
-	fan_struct* atticFan, 
-	double& airDensityRef, 
-	double& airTempRef, 
-	double& mSupReg, 
-	double& mRetLeak, 
-	double& mSupLeak, 
-	double& matticenvin, 
-	double& matticenvout, 
-	double& dtau, 
-	double& mSupAHoff, 
-	double& mRetAHoff,
-	double& airDensityIN,
-	double& airDensityOUT,
-	double& airDensityATTIC
-	);
+// The house as it changes from minute to minute: the weather converted for the routines, node temperatures,
+// humidity ratios, pressures and mass flows. The vent, fan and window arrays are here as they hold their flows.
+struct houseState_struct {
+	double tempOut;			// Outdoor temperature [K]
+	double windSpeed;		// Wind speed at the eaves [m/s]
+	double pRef;			// Outdoor air pressure [Pa]
+	double sc;				// Cloud cover fraction
+	double SBETA;			// Sine and cosine of the solar altitude
+	double CBETA;
+	double dec;				// Solar declination [radians]
+	double Csol;
+	double diffuse;			// Diffuse solar radiation [W/m2]
+	double ssolrad;			// Solar radiation on the south and north roofs [W/m2]
+	double nsolrad;
+	double airDensityOUT;
+	double airDensityIN;
+	double airDensityATTIC;
+	double airDensitySUP;
+	double airDensityRET;
+	int AHflag;				// Air Handler Flag (0/1/2 = OFF/HEATING MODE/COOLING MODE, 100 = fan on for venting, 102 = heating cool down for 1 minute at end of heating cycle)
+	double flag;			// Should be an int?
+	double C;				// Envelope Leakage Coefficient [m3/sPa^n], raised while the economizer runs
+	double ceilingC;
+	double AL4;
+	double Sw[4];
+	double wallCp[4];
+	winDoor_struct winDoor[10];
+	fan_struct fan[10];
+	fan_struct atticFan[10];
+	pipe_struct Pipe[10];
+	atticVent_struct atticVent[10];
+	soffit_struct soffit[4];
+	double tempHouse;
+	double tempAttic;
+	double tempOld[16];
+	double b[16];
+	int bsize;
+	double M1;				// Mass of attic air
+	double M12;				// Mass of return air
+	double M15;				// Mass of supply air
+	double M16;				// Mass of house air
+	double HR[5];
+	double hrold[5];
+	double Pint;
+	double Patticint;
+	double mIN;
+	double mOUT;
+	double mFlue;
+	double mFloor[4];
+	double mAtticIN;
+	double mAtticOUT;
+	double dPflue;
+	double dPceil;
+	double dPfloor;
+	flow_struct flow;		// Mass flows for the current minute
+	equipment_struct equip;	// Heating and cooling capacities for the current minute
+	double UA;
+	double rceil;
+	double internalGains;
+	double solgain;
+	double TSKY;
+	int ERRCODE;
+};
+
+// Additional functions
+
+// The per-minute routines read the building and the minute's weather sample (the humidity ratio, wind direction
+// and direct solar radiation as read) and update the state
+void sub_heat(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather, solver_struct& solver);
+void sub_moisture(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather);
+void sub_houseLeak(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather, solver_struct& solver);
+void sub_atticLeak(const building_struct& building, houseState_struct& state, const weatherSample_struct& weather, solver_struct& solver);
+
+// Houses that the lane routines below work on at once
+const int MAX_LANES = 16;
+
+// The same routines for up to MAX_LANES houses, lane l being the house of building[l], state[l] and weather[l].
+// Only the lanes whose active entry is 1 are worked on, and each ends as the single-house routine would leave it.
+// The pressure bisections step every lane together, a lane being masked off once its step is below .0001 Pa (so an
+// attic that starts from a .25 Pa step drops out before one that starts from 25 Pa). The flows at each lane's pressure
+// are still summed lane by lane. The temperature iteration of sub_heatLanes() solves the node balances of all its
+// lanes in one call of MatSEqnLanes() a pass, on a block of houses x 16 nodes, and masks off each lane whose attic
+// air temperature has converged.
+void sub_heatLanes(const building_struct* const building[], houseState_struct* const state[], const weatherSample_struct* const weather[],
+	solver_struct solver[], const int active[], int lanes);
+void sub_houseLeakLanes(const building_struct* const building[], houseState_struct* const state[], const weatherSample_struct* const weather[],
+	solver_struct solver[], const int active[], int lanes);
+void sub_atticLeakLanes(const building_struct* const building[], houseState_struct* const state[], const weatherSample_struct* const weather[],
+	solver_struct solver[], const int active[], int lanes);
 
 void sub_filterLoading (
 	int& MERV,
@@ -0,0 +1,225 @@
+#include "output.h"
+#include "report.h"
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+
+using namespace std;
+
+static const char* aggregationNames[] = { "mean", "min", "max", "sum", "last" };
+static const int numAggregations = 5;
+
+// Names of the built-in variables, in the order of outputVariable_enum
+static const char* builtinNames[OUT_VARIABLES] = {
+	"Time", "Min", "windSpeed", "tempOut", "tempHouse", "setpoint", "tempAttic", "tempSupply", "tempReturn", "AHflag",
+	"AHpower", "Hcap", "compressPower", "Ccap", "mechVentPower", "HR", "SHR", "Mcoil", "housePress", "Qhouse",
+	"ACH", "ACHflue", "ventSum", "nonRivecVentSum", "fan1", "fan2", "fan3", "fan4", "fan5", "fan6",
+	"fan7", "rivecOn", "turnover", "relExpRIVEC", "relDoseRIVEC", "occupiedExpReal", "occupiedDoseReal", "occupied", "occupiedExp", "occupiedDose",
+	"DAventLoad", "MAventLoad", "HROUT", "HRhouse", "RH%house", "RHind60", "RHind70", "HRattic", "HRreturn", "HRsupply",
+	"HRmaterials", "mAH_cumu", "qAH", "wAH", "retLF", "mCeiling", "mHouseIN", "mHouseOUT", "mSupReg", "mRetReg",
+	"mSupAHoff", "mRetAHoff", "mHouse", "mIN", "mOUT", "atticPress", "flag", "AIM2", "AEQaim2FlowDiff", "qFanFlowRatio",
+	"C"
+};
+
+// The registry, made on first use so that registrations from the static initialisers of any file come after the
+// built-in variables. A deque keeps every name where it is as more are added.
+struct outputRegistry_struct {
+	outputRegistry_struct();
+	int f_find(string& name);
+
+	mutex lock;
+	deque<string> names;
+};
+
+outputRegistry_struct::outputRegistry_struct() {
+	for(int i = 0; i < OUT_VARIABLES; i++)
+		names.push_back(builtinNames[i]);
+}
+
+int outputRegistry_struct::f_find(string& name) {
+	for(size_t i = 0; i < names.size(); i++) {
+		if(names[i] == name)
+			return (int) i;
+	}
+	return -1;
+}
+
+static outputRegistry_struct& f_registry() {
+	static outputRegistry_struct registry;
+	return registry;
+}
+
+int f_registerOutput(string name) {
+	outputRegistry_struct& registry = f_registry();
+	lock_guard<mutex> guard(registry.lock);
+	int variable = registry.f_find(name);
+	if(variable >= 0)
+		return variable;
+	registry.names.push_back(name);
+	return (int) registry.names.size() - 1;
+}
+
+int f_outputCount() {
+	outputRegistry_struct& registry = f_registry();
+	lock_guard<mutex> guard(registry.lock);
+	return (int) registry.names.size();
+}
+
+const char* f_outputName(int variable) {
+	outputRegistry_struct& registry = f_registry();
+	lock_guard<mutex> guard(registry.lock);
+	return variable >= 0 && variable < (int) registry.names.size() ? registry.names[variable].c_str() : 0;
+}
+
+int f_outputVariable(string name) {
+	if(name == "RHhouse")
+		name = "RH%house";
+
+	outputRegistry_struct& registry = f_registry();
+	lock_guard<mutex> guard(registry.lock);
+	return registry.f_find(name);
+}
+
+int f_readOutputs(string outputsFile_name, vector<outputSpec_struct>& specs) {
+	ifstream outputsFile(outputsFile_name);
+	if(!outputsFile) {
+		sub_report("Cannot open: " + outputsFile_name);
+		return 1;
+	}
+
+	string line;
+	while(getline(outputsFile, line)) {
+		if(!line.empty() && line[line.size() - 1] == '\r')
+			line.erase(line.size() - 1);
+
+		istringstream fields(line);
+		string resolution, column;
+		outputSpec_struct spec;
+		if(!(fields >> spec.extension) || spec.extension[0] == '#')
+			continue;
+
+		fields >> resolution;
+		if(resolution == "minute")
+			spec.period = 1;
+		else if(resolution == "10min")
+			spec.period = 10;
+		else if(resolution == "hourly")
+			spec.period = 60;
+		else if(resolution == "daily")
+			spec.period = 1440;
+		else
+			spec.period = atoi(resolution.c_str());
+
+		int bad = spec.period < 1;
+		while(fields >> column) {
+			size_t colon = column.find(':');
+			int variable = f_outputVariable(column.substr(0, colon));
+			int aggregation = colon == string::npos ? AGG_MEAN : -1;
+			for(int a = 0; a < numAggregations && colon != string::npos; a++) {
+				if(column.substr(colon + 1) == aggregationNames[a])
+					aggregation = a;
+			}
+			if(variable < 0 || aggregation < 0)
+				bad = 1;
+
+			spec.variables.push_back(variable);
+			spec.aggregation.push_back(aggregation);
+			spec.header.push_back(column);
+		}
+
+		if(bad || spec.variables.empty()) {
+			sub_report("Bad line in " + outputsFile_name + ": " + line);
+			return 2;
+		}
+		specs.push_back(spec);
+	}
+	return 0;
+}
+
+int outputWriter_struct::open(string fileName, outputSpec_struct& spec, int level) {
+	this->spec = spec;
+	value.assign(spec.variables.size(), 0);
+	minutes = 0;
+
+	file.open(fileName, level);
+	if(!file) {
+		sub_report("Cannot open: " + file.fileName);
+		return 1;
+	}
+
+	for(size_t i = 0; i < spec.header.size(); i++)
+		file << (i ? "\t" : "") << spec.header[i];
+	file << endl;
+	return 0;
+}
+
+void outputWriter_struct::add(double* output) {
+	for(size_t i = 0; i < spec.variables.size(); i++) {
+		double x = output[spec.variables[i]];
+		switch (spec.aggregation[i]) {
+		case AGG_MEAN:
+		case AGG_SUM:
+			value[i] = minutes ? value[i] + x : x;
+			break;
+		case AGG_MIN:
+			if(!minutes || x < value[i])
+				value[i] = x;
+			break;
+		case AGG_MAX:
+			if(!minutes || x > value[i])
+				value[i] = x;
+			break;
+		case AGG_LAST:
+			value[i] = x;
+			break;
+		}
+	}
+	minutes++;
+
+	if(minutes == spec.period)
+		sub_writeRow();
+}
+
+void outputWriter_struct::sub_writeRow() {
+	for(size_t i = 0; i < value.size(); i++) {
+		double x = spec.aggregation[i] == AGG_MEAN ? value[i] / minutes : value[i];
+		file << (i ? "\t" : "") << x;
+	}
+	file << "\n";			// No flush per row; close() flushes
+	minutes = 0;
+}
+
+int outputWriter_struct::close() {
+	if(minutes > 0)
+		sub_writeRow();
+	return file.close();
+}
+
+const summaryColumn_struct summaryColumns[SUMMARY_COLUMNS] = {
+	{ "Temp_out", 0 }, { "Temp_attic", 0 }, { "Temp_house", 0 },
+	{ "AH_kWh", 1 }, { "furnace_kWh", 1 }, { "compressor_kWh", 1 }, { "mechVent_kWh", 1 }, { "total_kWh", 1 },
+	{ "mean_ACH", 0 }, { "flue_ACH", 0 },
+	{ "meanRelExpReal", 0 }, { "meanRelDoseReal", 0 }, { "meanOccupiedExpReal", 0 }, { "meanOccupiedDoseReal", 0 },
+	{ "occupiedMinCount", 1 }, { "rivecMinutes", 1 }, { "NL", 0 }, { "C", 0 }, { "Aeq", 0 }, { "filterChanges", 1 },
+	{ "MERV", 0 }, { "loadingRate", 0 }, { "DryAirVentLoad", 1 }, { "MoistAirVentLoad", 1 }, { "RHexcAnnual60", 0 },
+	{ "RHexcAnnual70", 0 }
+};
+
+int f_readSummary(string rc2File_name, vector<string>& columns, vector<double>& values) {
+	ifstream rc2File(rc2File_name);
+	string header, line, column;
+	columns.clear();
+	values.clear();
+	if(!getline(rc2File, header) || !getline(rc2File, line))
+		return 0;
+
+	istringstream names(header), fields(line);
+	double value;
+	while(names >> column && fields >> value) {
+		columns.push_back(column);
+		values.push_back(value);
+	}
+	return values.size() == SUMMARY_COLUMNS;
+}
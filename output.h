@@ -0,0 +1,171 @@
+#pragma once
+#ifndef output_h
+#define output_h
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "writer.h"
+
+using namespace std;
+
+// Variables a simulation can report each minute, held in a registry of names. Each registered variable gets a
+// handle, its position in simulation_struct::output, which step() fills every minute; statistics, output files,
+// the C interface and the FMU (fmudesc.cpp writes its output list) all find variables by name through here.
+//
+// The built-in variables, named as in the .rco, .hum and .fil headers and followed by fields that used to need a
+// recompile to see, are registered first, so this enum holds their handles. Anything else is registered by name
+// from the code that sets it, once at start-up, either to be set in step() through its handle:
+//
+//	static const int OUT_COILLOAD = f_registerOutput("coilLoad");
+//	...
+//	output[OUT_COILLOAD] = coilLoad;
+//
+// or bound to a member of simulation_struct that step() copies each minute (see simulation.h):
+//
+//	static const int OUT_TEMPGROUND = f_registerOutput("tempGround", &simulation_struct::tempGround);
+enum outputVariable_enum {
+	OUT_TIME,				// Hour of the day
+	OUT_MIN,				// Minute of the simulation
+	OUT_WINDSPEED,
+	OUT_TEMPOUT,
+	OUT_TEMPHOUSE,
+	OUT_SETPOINT,
+	OUT_TEMPATTIC,
+	OUT_TEMPSUPPLY,
+	OUT_TEMPRETURN,
+	OUT_AHFLAG,
+	OUT_AHPOWER,
+	OUT_HCAP,
+	OUT_COMPRESSPOWER,
+	OUT_CCAP,
+	OUT_MECHVENTPOWER,
+	OUT_HR,					// House humidity ratio [g/kg]
+	OUT_SHR,
+	OUT_MCOIL,
+	OUT_HOUSEPRESS,
+	OUT_QHOUSE,
+	OUT_ACH,
+	OUT_ACHFLUE,
+	OUT_VENTSUM,
+	OUT_NONRIVECVENTSUM,
+	OUT_FAN1,
+	OUT_FAN2,
+	OUT_FAN3,
+	OUT_FAN4,
+	OUT_FAN5,
+	OUT_FAN6,
+	OUT_FAN7,
+	OUT_RIVECON,
+	OUT_TURNOVER,
+	OUT_RELEXPRIVEC,
+	OUT_RELDOSERIVEC,
+	OUT_OCCUPIEDEXPREAL,
+	OUT_OCCUPIEDDOSEREAL,
+	OUT_OCCUPIED,
+	OUT_OCCUPIEDEXP,
+	OUT_OCCUPIEDDOSE,
+	OUT_DAVENTLOAD,
+	OUT_MAVENTLOAD,
+	OUT_HROUT,
+	OUT_HRHOUSE,			// House humidity ratio [kg/kg]
+	OUT_RHHOUSE,
+	OUT_RHIND60,
+	OUT_RHIND70,
+	OUT_HRATTIC,
+	OUT_HRRETURN,
+	OUT_HRSUPPLY,
+	OUT_HRMATERIALS,
+	OUT_MAH_CUMU,			// Cumulative mass through the air handler [kg]
+	OUT_QAH,
+	OUT_WAH,
+	OUT_RETLF,
+	OUT_MCEILING,
+	OUT_MHOUSEIN,
+	OUT_MHOUSEOUT,
+	OUT_MSUPREG,
+	OUT_MRETREG,
+	OUT_MSUPAHOFF,
+	OUT_MRETAHOFF,
+	OUT_MHOUSE,
+	OUT_MIN_HOUSE,			// mIN, house envelope inflow
+	OUT_MOUT_HOUSE,			// mOUT, house envelope outflow
+	OUT_ATTICPRESS,
+	OUT_FLAG,				// Ceiling flow iterations
+	OUT_AIM2,
+	OUT_AEQAIM2FLOWDIFF,
+	OUT_QFANFLOWRATIO,
+	OUT_C,
+	OUT_VARIABLES			// Built-in variables; f_outputCount() gives all of them
+};
+
+// Registers an output variable and returns its handle. A name that is already registered gets its handle back.
+int f_registerOutput(string name);
+
+// Variables registered so far. Simulations size their output to this in init(), so register before that.
+int f_outputCount();
+
+// Name of a registered variable, or 0. The name stays valid for the whole run.
+const char* f_outputName(int variable);
+
+// Handle of a named output variable, or -1. "RHhouse" is accepted for the RH%house column.
+int f_outputVariable(string name);
+
+// How a column is reduced over the minutes of one row
+enum outputAggregation_enum {
+	AGG_MEAN,
+	AGG_MIN,
+	AGG_MAX,
+	AGG_SUM,
+	AGG_LAST
+};
+
+// One line of the output specification file: an extra output file, the minutes per row and its columns.
+//
+//	# extension	resolution	columns (name or name:mean, :min, :max, :sum or :last; mean if not given)
+//	min			minute		Min tempHouse RH%house mCeiling mHouseIN
+//	hrl			hourly		Min:last tempOut tempHouse tempHouse:max AHpower:sum
+//
+// Resolution is minute, 10min, hourly, daily or a number of minutes.
+struct outputSpec_struct {
+	string extension;
+	int period;
+	vector<int> variables;
+	vector<int> aggregation;
+	vector<string> header;
+};
+
+// Returns 1 if the file cannot be opened and 2 for a line that cannot be used
+int f_readOutputs(string outputsFile_name, vector<outputSpec_struct>& specs);
+
+// One output file of a simulation. add() takes every minute; a row is written each spec.period minutes,
+// and close() writes whatever is left of the last period (returning 1 if the file could not all be written).
+struct outputWriter_struct {
+	int open(string fileName, outputSpec_struct& spec, int level);
+	void add(double* output);
+	int close();
+
+	void sub_writeRow();
+
+	outputSpec_struct spec;
+	outputStream_struct file;
+	vector<double> value;
+	int minutes;			// Minutes in the current row
+};
+
+const int SUMMARY_COLUMNS = 26;			// Columns of the .rc2 annual summary (see simulation_struct::finish)
+
+// A column of the .rc2 annual summary, in the order finish() writes them. Totals over the simulation (energy,
+// minutes, filter changes and ventilation loads) add up over parts of a year; the others are means or inputs.
+struct summaryColumn_struct {
+	const char* name;
+	int total;
+};
+
+extern const summaryColumn_struct summaryColumns[SUMMARY_COLUMNS];
+
+// Reads the values of an .rc2 annual summary with their column names. Returns 0 if the file is missing or
+// incomplete (a run that was stopped while writing it).
+int f_readSummary(string rc2File_name, vector<string>& columns, vector<double>& values);
+
+#endif
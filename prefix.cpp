@@ -0,0 +1,256 @@
+#include "prefix.h"
+#include "report.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+using namespace std;
+
+// Inputs a variant can change. Each is only read in the branch of step() for its season (see the heating and
+// cooling thermostat calculations and the equipment model), so it cannot make a difference before then.
+enum prefixInput_enum {
+	INPUT_HEATSETPOINT,
+	INPUT_UAH,
+	INPUT_CEILRVAL_HEAT,
+	INPUT_COOLSETPOINT,
+	INPUT_UAC,
+	INPUT_CEILRVAL_COOL,
+	INPUT_CAPACITYARI,
+	INPUT_EERARI,
+	INPUT_CHARGE,
+	PREFIX_INPUTS
+};
+
+static const char* prefixInputs[PREFIX_INPUTS] = {
+	"heatSetpoint", "UAh", "ceilRval_heat",
+	"coolSetpoint", "UAc", "ceilRval_cool", "capacityari", "EERari", "charge"
+};
+
+static const int prefixGuards[PREFIX_INPUTS] = {
+	GUARD_HEATING, GUARD_HEATING, GUARD_HEATING,
+	GUARD_COOLING, GUARD_COOLING, GUARD_COOLING, GUARD_COOLING, GUARD_COOLING, GUARD_COOLING
+};
+
+static void sub_setInput(simulation_struct* sim, int input, double value) {
+	switch (input) {
+	case INPUT_HEATSETPOINT:
+		for(int i = 0; i < 24; i++)
+			sim->heatThermostat[i] = value;
+		break;
+	case INPUT_UAH:
+		sim->UAh = value;
+		break;
+	case INPUT_CEILRVAL_HEAT:
+		sim->ceilRval_heat = value;
+		break;
+	case INPUT_COOLSETPOINT:
+		for(int i = 0; i < 24; i++)
+			sim->coolThermostat[i] = value;
+		break;
+	case INPUT_UAC:
+		sim->UAc = value;
+		break;
+	case INPUT_CEILRVAL_COOL:
+		sim->ceilRval_cool = value;
+		break;
+	case INPUT_CAPACITYARI:
+		sim->capacityari = value;
+		break;
+	case INPUT_EERARI:
+		sim->EERari = value;
+		break;
+	case INPUT_CHARGE:
+		sim->charge = value;
+		break;
+	}
+}
+
+// 1 if the base has just simulated a minute that reads one of the variant's inputs
+static int f_guardFired(simulation_struct* base, variantSpec_struct& spec) {
+	for(size_t i = 0; i < spec.inputs.size(); i++) {
+		int guard = prefixGuards[spec.inputs[i]];
+		if((guard == GUARD_HEATING && base->hcFlag == 1) || (guard == GUARD_COOLING && base->hcFlag == 2))
+			return 1;
+	}
+	return 0;
+}
+
+int f_readVariants(string variantsFile_name, vector<variantSpec_struct>& specs) {
+	ifstream variantsFile(variantsFile_name);
+	if(!variantsFile) {
+		sub_report("Cannot open: " + variantsFile_name);
+		return 1;
+	}
+
+	string line;
+	while(getline(variantsFile, line)) {
+		if(!line.empty() && line[line.size() - 1] == '\r')
+			line.erase(line.size() - 1);
+
+		istringstream fields(line);
+		string setting;
+		variantSpec_struct spec;
+		if(!(fields >> spec.name) || spec.name[0] == '#')
+			continue;
+
+		int bad = !(fields >> spec.base);
+		while(fields >> setting) {
+			size_t equals = setting.find('=');
+			int input = -1;
+			for(int i = 0; i < PREFIX_INPUTS && equals != string::npos; i++) {
+				if(setting.substr(0, equals) == prefixInputs[i])
+					input = i;
+			}
+			if(input < 0)
+				bad = 1;
+
+			spec.inputs.push_back(input);
+			spec.values.push_back(equals == string::npos ? 0 : atof(setting.substr(equals + 1).c_str()));
+		}
+
+		if(bad || spec.inputs.empty()) {
+			sub_report("Bad line in " + variantsFile_name + ": " + line);
+			return 2;
+		}
+		specs.push_back(spec);
+	}
+	return 0;
+}
+
+// Opens the variants' files, named like the base's. Returns 1 if one cannot be opened.
+int prefix_struct::init(simulation_struct* base, vector<variantSpec_struct>& specs) {
+	this->base = base;
+	checkpoint = 0;
+	minutes = 0;
+	numWaiting = (int) specs.size();
+
+	baseStreams = base->f_streams();
+	baseText.assign(baseStreams.size(), vector<char>());
+	for(size_t i = 0; i < baseStreams.size(); i++)
+		baseStreams[i]->keepCopy(&baseText[i]);
+
+	string basePrefix = base->outPath + base->output_file;
+	variants.resize(specs.size());
+	for(size_t v = 0; v < specs.size(); v++) {
+		variants[v].spec = specs[v];
+		variants[v].forked = 0;
+		for(size_t i = 0; i < baseStreams.size(); i++) {
+			string extension = baseStreams[i]->fileName.substr(basePrefix.size());
+			if(base->compressionLevel > 0)
+				extension.erase(extension.size() - 3);			// open() adds the .gz again
+
+			outputStream_struct* stream = new outputStream_struct();
+			variants[v].streams.push_back(stream);
+			stream->open(base->outPath + specs[v].name + extension, base->compressionLevel);
+			if(!*stream) {
+				sub_report("Cannot open: " + stream->fileName);
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+void prefix_struct::add(const weatherSample_struct& weather) {
+	if(numWaiting > 0 && minutes % 1440 == 0)
+		sub_checkpoint();
+	if(numWaiting > 0)
+		replay.push_back(weather);
+	minutes++;
+}
+
+// Passes the base's output since the last checkpoint to the waiting variants
+void prefix_struct::sub_passText() {
+	for(size_t i = 0; i < baseStreams.size(); i++) {
+		baseStreams[i]->updateCopy();
+		for(size_t v = 0; v < variants.size(); v++) {
+			if(!variants[v].forked && !baseText[i].empty())
+				variants[v].streams[i]->write(&baseText[i][0], baseText[i].size());
+		}
+		baseText[i].clear();
+	}
+}
+
+void prefix_struct::sub_checkpoint() {
+	sub_passText();
+	delete checkpoint;
+	checkpoint = base->f_fork();
+	replay.clear();
+}
+
+// A copy of from with the variant's inputs, name and files
+simulation_struct* prefix_struct::f_fork(variant_struct& variant, simulation_struct* from) {
+	simulation_struct* sim = from->f_fork();
+	for(size_t i = 0; i < variant.spec.inputs.size(); i++)
+		sub_setInput(sim, variant.spec.inputs[i], variant.spec.values[i]);
+	sim->output_file = variant.spec.name;
+
+	// The copy's streams are all closed; these are the ones f_streams() gave for the base, in the same order
+	vector<outputStream_struct*> streams;
+	if(sim->minuteOutputFlag == 1) {
+		streams.push_back(&sim->outputFile);
+		streams.push_back(&sim->moistureFile);
+		streams.push_back(&sim->filterFile);
+	}
+	for(size_t i = 0; i < sim->outputs.size(); i++)
+		streams.push_back(&sim->outputs[i]->file);
+	for(size_t i = 0; i < streams.size() && i < variant.streams.size(); i++)
+		streams[i]->swap(*variant.streams[i]);
+
+	variant.forked = 1;
+	numWaiting--;
+	return sim;
+}
+
+vector<simulation_struct*> prefix_struct::check() {
+	vector<simulation_struct*> forked;
+	if(numWaiting == 0)
+		return forked;
+
+	for(size_t v = 0; v < variants.size(); v++) {
+		if(variants[v].forked || !f_guardFired(base, variants[v].spec))
+			continue;
+
+		simulation_struct* sim = f_fork(variants[v], checkpoint);
+		for(size_t m = 0; m < replay.size(); m++)
+			sim->step(replay[m]);
+		forked.push_back(sim);
+	}
+
+	if(numWaiting == 0) {
+		for(size_t i = 0; i < baseStreams.size(); i++)
+			baseStreams[i]->keepCopy(0);
+		delete checkpoint;
+		checkpoint = 0;
+		replay.clear();
+	}
+	return forked;
+}
+
+vector<simulation_struct*> prefix_struct::finish() {
+	vector<simulation_struct*> forked;
+	if(numWaiting == 0)
+		return forked;
+
+	sub_passText();
+	for(size_t v = 0; v < variants.size(); v++) {
+		if(!variants[v].forked)
+			forked.push_back(f_fork(variants[v], base));
+	}
+	for(size_t i = 0; i < baseStreams.size(); i++)
+		baseStreams[i]->keepCopy(0);
+	return forked;
+}
+
+void prefix_struct::close() {
+	delete checkpoint;
+	checkpoint = 0;
+	for(size_t v = 0; v < variants.size(); v++) {
+		for(size_t i = 0; i < variants[v].streams.size(); i++) {
+			variants[v].streams[i]->close();
+			delete variants[v].streams[i];
+		}
+	}
+	variants.clear();
+}
@@ -0,0 +1,75 @@
+#pragma once
+#ifndef prefix_h
+#define prefix_h
+
+#include <string>
+#include <vector>
+#include "simulation.h"
+#include "weather.h"
+
+using namespace std;
+
+// Prefix sharing for sweep variants. A variant is a batch simulation (its base) with a few inputs changed, and
+// many inputs are only read in one season: a variant of cooling inputs follows its base exactly until the first
+// cooling minute. The base is run as usual; each variant is forked from it (simulation_struct::f_fork) at the
+// start of the day its inputs are first read, and replays that day on its own before joining the lockstep group.
+// Until then its files receive the base's output, so each variant gets the same files as if run from the start.
+// A variant whose inputs are never read is a copy of its base at the end of the run.
+//
+// The variants come from a file with one line per variant:
+//
+//	# variant		base	input=value ...
+//	t1_eer13		t1		EERari=13 charge=0.9
+//	t1_cool78		t1		coolSetpoint=298.7
+//
+// Base is the output name of a batch simulation; the variant's files are named after the variant.
+// Inputs that can be varied are listed in prefixInputs (prefix.cpp), each with the season that first reads it.
+// Setpoints are in K and apply to every hour.
+
+// When an input is first read: the first minute simulated in that season
+enum prefixGuard_enum {
+	GUARD_HEATING,			// hcFlag == 1
+	GUARD_COOLING			// hcFlag == 2
+};
+
+struct variantSpec_struct {
+	string name;
+	string base;
+	vector<int> inputs;		// Positions in prefixInputs
+	vector<double> values;
+};
+
+// Returns 1 if the file cannot be opened and 2 for a line that cannot be used
+int f_readVariants(string variantsFile_name, vector<variantSpec_struct>& specs);
+
+struct variant_struct {
+	variantSpec_struct spec;
+	vector<outputStream_struct*> streams;	// The variant's own files, fed from the base until the fork
+	int forked;
+};
+
+// The variants of one base simulation. add() is called with each weather sample before the base steps and
+// check() after it; check() returns the variants forked in that minute, already stepped up to the group's minute.
+// finish() is called before the base's finish() and returns the variants that never forked.
+struct prefix_struct {
+	int init(simulation_struct* base, vector<variantSpec_struct>& specs);
+	void add(const weatherSample_struct& weather);
+	vector<simulation_struct*> check();
+	vector<simulation_struct*> finish();
+	void close();
+
+	void sub_passText();
+	void sub_checkpoint();
+	simulation_struct* f_fork(variant_struct& variant, simulation_struct* from);
+
+	simulation_struct* base;
+	simulation_struct* checkpoint;				// Base at the start of the current day
+	vector<weatherSample_struct> replay;		// Weather since the checkpoint
+	vector<outputStream_struct*> baseStreams;
+	vector<vector<char> > baseText;				// Base output since the checkpoint, one per stream
+	vector<variant_struct> variants;
+	long int minutes;
+	int numWaiting;
+};
+
+#endif
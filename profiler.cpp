@@ -0,0 +1,157 @@
+#include "profiler.h"
+
+#ifdef REGCAP_PROFILE
+
+#include "report.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+
+using namespace std;
+
+PROFILE_THREAD long long profileCalls[PROF_COUNTERS];
+
+static const char* sectionNames[PROF_SECTIONS] = {
+	"Weather", "Occupancy", "Thermostat", "RIVEC decision", "Fans", "Equipment", "Moisture",
+	"Heat and mass transport", "IAQ", "Output", "Step"
+};
+
+static const char* counterNames[PROF_COUNTERS] = {
+	"sub_houseLeak", "sub_atticLeak", "sub_heat", "MatSEqn"
+};
+
+// Bucket for a tick count: exact below 4, then four buckets per power of two
+static int f_profileBucket(unsigned long long ticks) {
+	if(ticks < 4)
+		return int (ticks);
+
+	int msb = 0;
+	for(unsigned long long t = ticks; t > 1; t >>= 1)
+		msb++;
+
+	int bucket = (msb - 1) * 4 + int ((ticks >> (msb - 2)) & 3);
+	if(bucket >= PROF_BUCKETS)
+		bucket = PROF_BUCKETS - 1;
+	return bucket;
+}
+
+// Smallest tick count that falls in the bucket
+static unsigned long long f_profileBucketFloor(int bucket) {
+	if(bucket < 4)
+		return bucket;
+
+	int msb = bucket / 4 + 1;
+	return (unsigned long long) (4 + bucket % 4) << (msb - 2);
+}
+
+// Tick count below which the given fraction of minutes fall (upper edge of the bucket, so within 25%)
+static unsigned long long f_profilePercentile(long long histogram[], long long minutes, double fraction) {
+	long long target = (long long) (fraction * minutes + 0.5);
+	long long count = 0;
+
+	for(int i = 0; i < PROF_BUCKETS - 1; i++) {
+		count = count + histogram[i];
+		if(count >= target && count > 0)
+			return f_profileBucketFloor(i + 1);
+	}
+	return f_profileBucketFloor(PROF_BUCKETS - 1);
+}
+
+void profile_struct::init() {
+	for(int i = 0; i < PROF_SECTIONS; i++) {
+		minuteTicks[i] = 0;
+		totalTicks[i] = 0;
+		maxTicks[i] = 0;
+		for(int j = 0; j < PROF_BUCKETS; j++)
+			histogram[i][j] = 0;
+	}
+	for(int i = 0; i < PROF_COUNTERS; i++) {
+		totalCalls[i] = 0;
+		maxCalls[i] = 0;
+	}
+	minutes = 0;
+	startTicks = profileTicks();
+	startTime = chrono::steady_clock::now();
+}
+
+void profile_struct::stepBegin() {
+	for(int i = 0; i < PROF_COUNTERS; i++)
+		profileCalls[i] = 0;
+	for(int i = 0; i < PROF_SECTIONS; i++)
+		minuteTicks[i] = 0;
+	stepMark = profileTicks();
+}
+
+void profile_struct::stepEnd() {
+	minuteTicks[PROF_STEP] = profileTicks() - stepMark;
+
+	for(int i = 0; i < PROF_SECTIONS; i++) {
+		totalTicks[i] = totalTicks[i] + minuteTicks[i];
+		if(minuteTicks[i] > maxTicks[i])
+			maxTicks[i] = minuteTicks[i];
+		histogram[i][f_profileBucket(minuteTicks[i])]++;
+	}
+	for(int i = 0; i < PROF_COUNTERS; i++) {
+		totalCalls[i] = totalCalls[i] + profileCalls[i];
+		if(profileCalls[i] > maxCalls[i])
+			maxCalls[i] = profileCalls[i];
+	}
+	minutes++;
+}
+
+// Writes the .prof summary. Times are per simulated minute in microseconds; Other is step time outside the named sections.
+int profile_struct::write(string fileName, string title) {
+	double seconds = chrono::duration_cast<chrono::duration<double> >(chrono::steady_clock::now() - startTime).count();
+	double ticksPerSecond = 0;
+
+	if(seconds > 0)
+		ticksPerSecond = (profileTicks() - startTicks) / seconds;
+	if(ticksPerSecond <= 0 || minutes == 0)
+		return 1;
+
+	ofstream profFile(fileName);
+	if(!profFile) {
+		sub_report("Cannot open: " + fileName);
+		return 1;
+	}
+
+	double us = 1e6 / ticksPerSecond;		// Microseconds per tick
+
+	unsigned long long namedTicks = 0;
+	for(int i = 0; i < PROF_STEP; i++)
+		namedTicks = namedTicks + totalTicks[i];
+
+	profFile << "Profile\t" << title << endl;
+	profFile << "Minutes\t" << minutes << endl;
+	profFile << "Wall time [s]\t" << seconds << endl;
+	profFile << "Ticks per second\t" << ticksPerSecond << endl;
+	profFile << endl;
+
+	profFile << "Section\tTotal [s]\tShare [%]\tMean [us]\tP50 [us]\tP90 [us]\tP99 [us]\tP99.9 [us]\tMax [us]" << endl;
+	profFile << fixed << setprecision(3);
+	for(int i = 0; i < PROF_SECTIONS; i++) {
+		profFile << sectionNames[i] << "\t" << totalTicks[i] * us / 1e6 << "\t" << 100.0 * totalTicks[i] / totalTicks[PROF_STEP] << "\t";
+		profFile << totalTicks[i] * us / minutes << "\t";
+		profFile << f_profilePercentile(histogram[i], minutes, 0.5) * us << "\t";
+		profFile << f_profilePercentile(histogram[i], minutes, 0.9) * us << "\t";
+		profFile << f_profilePercentile(histogram[i], minutes, 0.99) * us << "\t";
+		profFile << f_profilePercentile(histogram[i], minutes, 0.999) * us << "\t";
+		profFile << maxTicks[i] * us << endl;
+
+		if(i == PROF_OUTPUT) {
+			unsigned long long otherTicks = totalTicks[PROF_STEP] > namedTicks ? totalTicks[PROF_STEP] - namedTicks : 0;
+			profFile << "Other\t" << otherTicks * us / 1e6 << "\t" << 100.0 * otherTicks / totalTicks[PROF_STEP] << "\t";
+			profFile << otherTicks * us / minutes << "\t\t\t\t\t" << endl;
+		}
+	}
+	profFile << endl;
+
+	profFile << "Routine\tCalls\tCalls per minute\tMax calls in a minute" << endl;
+	for(int i = 0; i < PROF_COUNTERS; i++)
+		profFile << counterNames[i] << "\t" << totalCalls[i] << "\t" << (double) totalCalls[i] / minutes << "\t" << maxCalls[i] << endl;
+
+	profFile.close();
+	return 0;
+}
+
+#endif
@@ -0,0 +1,103 @@
+#pragma once
+#ifndef profiler_h
+#define profiler_h
+
+// Per-section timing of the minute loop, written to a .prof file at the end of each simulation.
+// Build with REGCAP_PROFILE defined to switch it on. Without it every PROFILE_ macro expands to
+// nothing and simulation_struct carries no profiler state, so production builds pay nothing.
+
+#ifdef REGCAP_PROFILE
+
+#include <chrono>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PROFILE_THREAD __declspec(thread)
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILE_THREAD __thread
+#else
+#define PROFILE_THREAD __thread
+#endif
+
+using namespace std;
+
+// Timed sections of simulation_struct::step(), in loop order. PROF_STEP is the whole step.
+enum profileSection_enum {
+	PROF_WEATHER,
+	PROF_OCCUPANCY,
+	PROF_THERMOSTAT,
+	PROF_RIVEC,
+	PROF_FANS,
+	PROF_EQUIPMENT,
+	PROF_MOISTURE,
+	PROF_TRANSPORT,
+	PROF_IAQ,
+	PROF_OUTPUT,
+	PROF_STEP,
+	PROF_SECTIONS
+};
+
+// Counted physics routines
+enum profileCounter_enum {
+	PROF_HOUSELEAK,
+	PROF_ATTICLEAK,
+	PROF_HEAT,
+	PROF_MATSEQN,
+	PROF_COUNTERS
+};
+
+const int PROF_BUCKETS = 256;			// Four buckets per doubling of ticks per minute
+
+// Calls made on this thread since the current step began (the physics routines have no simulation to report to)
+extern PROFILE_THREAD long long profileCalls[PROF_COUNTERS];
+
+inline unsigned long long profileTicks() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+struct profile_struct {
+	void init();
+	void stepBegin();
+	void stepEnd();
+	int write(string fileName, string title);
+
+	unsigned long long mark;							// Ticks at the start of the current section
+	unsigned long long stepMark;						// Ticks at the start of the current step
+	unsigned long long minuteTicks[PROF_SECTIONS];		// Ticks spent in each section during the current step
+	unsigned long long totalTicks[PROF_SECTIONS];
+	unsigned long long maxTicks[PROF_SECTIONS];
+	long long histogram[PROF_SECTIONS][PROF_BUCKETS];	// Minutes binned by ticks spent in the section
+	long long totalCalls[PROF_COUNTERS];
+	long long maxCalls[PROF_COUNTERS];
+	long long minutes;
+	unsigned long long startTicks;						// Used with startTime to convert ticks to seconds
+	chrono::steady_clock::time_point startTime;
+};
+
+#define PROFILE_INIT(p)				(p).init()
+#define PROFILE_STEP_BEGIN(p)		(p).stepBegin()
+#define PROFILE_BEGIN(p)			(p).mark = profileTicks()
+#define PROFILE_END(p, section)		(p).minuteTicks[section] += profileTicks() - (p).mark
+#define PROFILE_STEP_END(p)			(p).stepEnd()
+#define PROFILE_COUNT(counter)		profileCalls[counter]++
+#define PROFILE_WRITE(p, file, title)	(p).write(file, title)
+
+#else
+
+#define PROFILE_INIT(p)				((void)0)
+#define PROFILE_STEP_BEGIN(p)		((void)0)
+#define PROFILE_BEGIN(p)			((void)0)
+#define PROFILE_END(p, section)		((void)0)
+#define PROFILE_STEP_END(p)			((void)0)
+#define PROFILE_COUNT(counter)		((void)0)
+#define PROFILE_WRITE(p, file, title)	((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,184 @@
+#include "progress.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using namespace std;
+
+static const char* solverKeys[CONV_SOLVERS] = { "pint", "pattic", "ceiling", "heat", "main" };
+
+static double f_secondsSince(chrono::steady_clock::time_point start) {
+	return chrono::duration_cast<chrono::duration<double> >(chrono::steady_clock::now() - start).count();
+}
+
+// h:mm:ss, or "?" before there is a rate to estimate from
+static string f_clock(double seconds) {
+	if(seconds < 0)
+		return "?";
+
+	long int s = (long int) (seconds + 0.5);
+	ostringstream text;
+	text << s / 3600 << ":" << setfill('0') << setw(2) << (s / 60) % 60 << ":" << setw(2) << s % 60;
+	return text.str();
+}
+
+// Escapes a path or name for a JSON string
+static string f_json(string text) {
+	string escaped;
+	for(size_t i = 0; i < text.size(); i++) {
+		if(text[i] == '\\' || text[i] == '"')
+			escaped += '\\';
+		escaped += text[i];
+	}
+	return escaped;
+}
+
+void progress_struct::init(string batchName, string fileName, int numSims, int totaldays, double interval, int statusLine) {
+	this->batchName = batchName;
+	this->fileName = fileName;
+	this->numSims = numSims;
+	this->minutesPerSim = (long int) totaldays * 1440;
+	this->interval = interval;
+	this->statusLine = statusLine;
+
+	firstSim = 0;
+	lastSim = 0;
+	numGroupSims = 0;
+	day = 0;
+	groupMinute = 0;
+	numRunning = 0;
+	doneMinutes = 0;
+	lastMinutes = 0;
+	minutesPerSecond = 0;
+	caseSeconds = -1;
+	batchSeconds = -1;
+	for(int i = 0; i < CONV_SOLVERS; i++) {
+		lastIterations[i] = 0;
+		iterationsPerMinute[i] = 0;
+	}
+
+	batchStart = chrono::steady_clock::now();
+	groupStart = batchStart;
+	lastRefresh = batchStart;
+
+	sub_write("starting");
+}
+
+void progress_struct::groupBegin(int firstSim, int lastSim, int numGroupSims, string weather_file) {
+	this->firstSim = firstSim;
+	this->lastSim = lastSim;
+	this->numGroupSims = numGroupSims;
+	this->weather_file = weather_file;
+	groupMinute = 0;
+	numRunning = numGroupSims;
+	caseSeconds = -1;
+	for(int i = 0; i < CONV_SOLVERS; i++)
+		lastIterations[i] = 0;			// Each group starts new simulations, so their counts start at zero
+
+	groupStart = chrono::steady_clock::now();
+}
+
+int progress_struct::due(long int groupMinute) {
+	return groupMinute % 60 == 0 && f_secondsSince(lastRefresh) >= interval;
+}
+
+void progress_struct::update(long int groupMinute, int day, int numRunning, long long iterations[CONV_SOLVERS]) {
+	this->groupMinute = groupMinute;
+	this->day = day;
+	this->numRunning = numRunning;
+
+	double seconds = f_secondsSince(lastRefresh);
+	long long minutes = doneMinutes + (long long) groupMinute * numGroupSims;
+	long long newMinutes = minutes - lastMinutes;
+
+	minutesPerSecond = seconds > 0 ? newMinutes / seconds : 0;
+	for(int i = 0; i < CONV_SOLVERS; i++) {
+		iterationsPerMinute[i] = newMinutes > 0 ? double (iterations[i] - lastIterations[i]) / newMinutes : 0;
+		lastIterations[i] = iterations[i];
+	}
+
+	// Time left from the average rate so far, which is steadier than the rate since the last refresh
+	double groupSeconds = f_secondsSince(groupStart);
+	double batchElapsed = f_secondsSince(batchStart);
+	caseSeconds = groupMinute > 0 ? (minutesPerSim - groupMinute) * groupSeconds / groupMinute : -1;
+	batchSeconds = minutes > 0 ? ((long long) numSims * minutesPerSim - minutes) * batchElapsed / minutes : -1;
+
+	lastMinutes = minutes;
+	lastRefresh = chrono::steady_clock::now();
+
+	if(statusLine) {
+		ostringstream line;
+		line << "\rDay " << setw(3) << day << "  Sim " << firstSim + 1;
+		if(lastSim != firstSim)
+			line << "-" << lastSim + 1;
+		line << "/" << numSims << "  " << fixed << setprecision(0) << minutesPerSecond << " min/s";
+		line << "  heat " << setprecision(2) << iterationsPerMinute[CONV_HEAT] << " it/min";
+		line << "  case " << f_clock(caseSeconds) << "  batch " << f_clock(batchSeconds) << "   ";
+		cout << line.str() << flush;
+	}
+
+	sub_write("running");
+}
+
+void progress_struct::groupEnd() {
+	doneMinutes = doneMinutes + (long long) numGroupSims * minutesPerSim;
+	lastMinutes = doneMinutes;
+	groupMinute = 0;
+	numRunning = 0;
+	caseSeconds = 0;
+
+	if(statusLine)
+		cout << endl;
+}
+
+void progress_struct::finish(string state) {
+	caseSeconds = 0;
+	batchSeconds = 0;
+	sub_write(state);
+}
+
+// Writes the JSON file beside the real one and renames it over, so a reader never sees half a file
+void progress_struct::sub_write(string state) {
+	if(fileName.empty())
+		return;
+
+	string tempFile_name = fileName + ".tmp";
+	ofstream jsonFile(tempFile_name);
+	if(!jsonFile)
+		return;
+
+	jsonFile << "{" << endl;
+	jsonFile << "\t\"state\": \"" << state << "\"," << endl;
+	jsonFile << "\t\"batch\": \"" << f_json(batchName) << "\"," << endl;
+	jsonFile << "\t\"simulations\": " << numSims << "," << endl;
+	jsonFile << "\t\"groupFirst\": " << firstSim + 1 << "," << endl;
+	jsonFile << "\t\"groupLast\": " << lastSim + 1 << "," << endl;
+	jsonFile << "\t\"groupSize\": " << numGroupSims << "," << endl;
+	jsonFile << "\t\"running\": " << numRunning << "," << endl;
+	jsonFile << "\t\"weather\": \"" << f_json(weather_file) << "\"," << endl;
+	jsonFile << "\t\"day\": " << day << "," << endl;
+	jsonFile << "\t\"minutesDone\": " << doneMinutes + (long long) groupMinute * numGroupSims << "," << endl;
+	jsonFile << "\t\"minutesTotal\": " << (long long) numSims * minutesPerSim << "," << endl;
+	jsonFile << "\t\"minutesPerSecond\": " << minutesPerSecond << "," << endl;
+	jsonFile << "\t\"elapsedSeconds\": " << f_secondsSince(batchStart) << "," << endl;
+	jsonFile << "\t\"caseSecondsLeft\": " << caseSeconds << "," << endl;
+	jsonFile << "\t\"batchSecondsLeft\": " << batchSeconds << "," << endl;
+	jsonFile << "\t\"iterationsPerMinute\": {";
+	for(int i = 0; i < CONV_SOLVERS; i++)
+		jsonFile << (i ? ", " : " ") << "\"" << solverKeys[i] << "\": " << iterationsPerMinute[i];
+	jsonFile << " }" << endl;
+	jsonFile << "}" << endl;
+	jsonFile.close();
+
+#ifdef _WIN32
+	// rename() will not replace an existing file on Windows; this replaces it in one step, so a reader never finds it missing
+	MoveFileExA(tempFile_name.c_str(), fileName.c_str(), MOVEFILE_REPLACE_EXISTING);
+#else
+	rename(tempFile_name.c_str(), fileName.c_str());
+#endif
+}
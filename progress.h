@@ -0,0 +1,53 @@
+#pragma once
+#ifndef progress_h
+#define progress_h
+
+#include <chrono>
+#include <string>
+#include "convergence.h"
+
+using namespace std;
+
+// Progress of a batch run: simulated minutes per second, time left for the running group and for the batch,
+// and solver iterations per simulated minute. Interactive runs see it as one status line rewritten in place;
+// it is also written to a small JSON file, replaced every interval, that can be read without touching stdout.
+// update() is only worth calling when due() says so; due() reads the clock at most once per simulated hour.
+struct progress_struct {
+	void init(string batchName, string fileName, int numSims, int totaldays, double interval, int statusLine);
+	void groupBegin(int firstSim, int lastSim, int numGroupSims, string weather_file);
+	int due(long int groupMinute);
+	void update(long int groupMinute, int day, int numRunning, long long iterations[CONV_SOLVERS]);
+	void groupEnd();
+	void finish(string state);
+
+	void sub_write(string state);
+
+	string batchName;
+	string fileName;				// JSON progress file ("" = none)
+	int numSims;
+	long int minutesPerSim;
+	double interval;				// Seconds between refreshes
+	int statusLine;					// 1 = rewrite a status line on stdout
+
+	int firstSim;					// Running group, as batch positions from 0 (a group need not be contiguous)
+	int lastSim;
+	int numGroupSims;
+	string weather_file;
+	int day;
+	long int groupMinute;
+	int numRunning;
+
+	long long doneMinutes;			// Simulation-minutes finished by earlier groups
+	long long lastMinutes;			// Simulation-minutes at the previous refresh
+	long long lastIterations[CONV_SOLVERS];
+	double minutesPerSecond;		// Since the previous refresh
+	double iterationsPerMinute[CONV_SOLVERS];
+	double caseSeconds;				// Estimated seconds left for the running group
+	double batchSeconds;			// Estimated seconds left for the batch
+
+	chrono::steady_clock::time_point batchStart;
+	chrono::steady_clock::time_point groupStart;
+	chrono::steady_clock::time_point lastRefresh;
+};
+
+#endif
@@ -0,0 +1,368 @@
+#include "regcap.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include "output.h"
+#include "prefix.h"
+#include "report.h"
+#include "simulation.h"
+#include "weather.h"
+
+using namespace std;
+
+static_assert(REGCAP_SOLVERS == CONV_SOLVERS, "regcap_totals counts every solver");
+
+struct regcap_simulation {
+	simulation_struct* sim;
+	long minutes;				// Minutes stepped
+	int finished;				// 1 once totaldays have been simulated, by the variants too
+	int simFinished;			// 1 once sim has simulated totaldays
+	int files;					// 1 = made with an output name; regcap_finish() writes its files
+	prefix_struct* prefix;		// Sweep variants (0 = none)
+	vector<simulation_struct*> variants;	// Those forked so far
+	vector<int> variantFinished;
+};
+
+// Shelter tables and batch files already read, by file name
+static map<string, shared_ptr<shelterTable_struct> > shelterTables;
+static map<string, vector<statisticSpec_struct> > statisticsFiles;
+static map<string, vector<outputSpec_struct> > outputsFiles;
+static map<string, vector<weatherTransform_struct> > transformsFiles;
+static map<string, vector<variantSpec_struct> > variantsFiles;
+static mutex filesLock;
+
+// Keeps the engine's messages for regcap_lastError() while a call runs, instead of printing them
+struct keepReports_struct {
+	keepReports_struct() { kept = f_keepReports(1); }
+	~keepReports_struct() { f_keepReports(kept); }
+	int kept;
+};
+
+static string f_text(const char* text) {
+	return text ? text : "";
+}
+
+// The specs of a batch file, read by the first simulation that names it. Returns the reader's error.
+template<class spec_struct> static int f_readOnce(map<string, vector<spec_struct> >& files, const char* fileName,
+	int (*reader)(string, vector<spec_struct>&), vector<spec_struct>& specs) {
+	if(!fileName || !*fileName)
+		return 0;
+	lock_guard<mutex> guard(filesLock);
+	typename map<string, vector<spec_struct> >::iterator file = files.find(fileName);
+	if(file == files.end()) {
+		vector<spec_struct> read;
+		int error = reader(fileName, read);
+		if(error)
+			return error;
+		file = files.insert(make_pair(string(fileName), read)).first;
+	}
+	specs = file->second;
+	return 0;
+}
+
+regcap_simulation* regcap_create(const regcap_config* config) {
+	keepReports_struct keep;
+	int files = config->output != 0;
+
+	batch_struct batch;
+	batch.inPath = f_text(config->inPath);
+	batch.outPath = f_text(config->outPath);
+	batch.weatherPath = f_text(config->weatherPath);
+	batch.shelterFile_name = f_text(config->shelterFile);
+	batch.fanSchedulefile_name1 = f_text(config->fanSchedule1);
+	batch.fanSchedulefile_name2 = f_text(config->fanSchedule2);
+	batch.fanSchedulefile_name3 = f_text(config->fanSchedule3);
+	batch.totaldays = config->totaldays;
+	batch.startDay = config->startDay < 1 ? 1 : config->startDay;
+	batch.spinupDays = config->spinupDays;
+	batch.convergenceFlag = files && config->convergenceWorst > 0;
+	batch.convergenceWorst = files ? config->convergenceWorst : 0;
+	batch.minuteOutputFlag = files && config->minuteOutput == 1;
+	batch.compressionLevel = files ? config->compressionLevel : 0;
+	batch.scheduleSeed = config->scheduleSeed;
+
+	vector<variantSpec_struct> variants;
+	if(f_readOnce(transformsFiles, config->transformsFile, f_readTransforms, batch.weatherTransforms))
+		return 0;
+	if(files && (f_readOnce(statisticsFiles, config->statisticsFile, f_readStatistics, batch.statistics)
+		|| f_readOnce(outputsFiles, config->outputsFile, f_readOutputs, batch.outputs)
+		|| f_readOnce(variantsFiles, config->variantsFile, f_readVariants, variants)))
+		return 0;
+
+	string input_file = config->building ? "building" : f_text(config->input);		// Only used in messages with a building
+	string weather_file = f_text(config->climate);
+	string output_file = files ? config->output : "regcap";
+	if(input_file.empty()) {
+		sub_report("No building inputs");
+		return 0;
+	}
+
+	simulation_struct* sim = new simulation_struct();
+	sim->buildingText = f_text(config->building);
+	sim->outputVariablesFlag = config->noOutputVariables != 1;
+	{
+		lock_guard<mutex> guard(filesLock);
+		map<string, shared_ptr<shelterTable_struct> >::iterator table = shelterTables.find(batch.shelterFile_name);
+		if(table != shelterTables.end())
+			sim->shelter = table->second;
+	}
+
+	if(sim->init(batch, input_file, weather_file, output_file, config->latitude, config->altitude)) {
+		delete sim;
+		return 0;
+	}
+
+	{
+		lock_guard<mutex> guard(filesLock);
+		shelterTables[batch.shelterFile_name] = sim->shelter;
+	}
+
+	vector<weatherSample_struct> firstDay;
+	if(config->firstDay)
+		firstDay.assign(config->firstDay, config->firstDay + config->firstDayMinutes);
+	sim->spinUp(firstDay);
+
+	// The variants whose base is this simulation
+	vector<variantSpec_struct> specs;
+	for(size_t v = 0; v < variants.size(); v++) {
+		if(variants[v].base == output_file)
+			specs.push_back(variants[v]);
+	}
+	prefix_struct* prefix = 0;
+	if(!specs.empty()) {
+		prefix = new prefix_struct();
+		if(prefix->init(sim, specs)) {
+			prefix->close();
+			delete prefix;
+			delete sim;
+			return 0;
+		}
+	}
+
+	regcap_simulation* handle = new regcap_simulation();
+	handle->sim = sim;
+	handle->minutes = 0;
+	handle->finished = 0;
+	handle->simFinished = 0;
+	handle->files = files;
+	handle->prefix = prefix;
+	return handle;
+}
+
+regcap_simulation* regcap_clone(const regcap_simulation* sim) {
+	regcap_simulation* handle = new regcap_simulation();
+	handle->sim = sim->sim->f_branch();
+	handle->minutes = sim->minutes;
+	handle->finished = sim->simFinished;
+	handle->simFinished = sim->simFinished;
+	handle->files = 0;
+	handle->prefix = 0;
+	return handle;
+}
+
+// One minute of a simulation and its variants. Variants are forked after the minute, already stepped through it
+// (see prefix_struct::check), and step from the next minute while the simulation still does.
+// sub_beginMinute() adds the houses to step this minute, with the flag to set when each one's step() returns 0, and
+// sub_endMinute() forks the variants once they have been stepped.
+static void sub_beginMinute(regcap_simulation* sim, const regcap_weather& weather, vector<simulation_struct*>& houses, vector<int*>& finished) {
+	if(sim->prefix && !sim->simFinished)
+		sim->prefix->add(weather);
+
+	if(!sim->simFinished) {
+		houses.push_back(sim->sim);
+		finished.push_back(&sim->simFinished);
+	}
+
+	for(size_t v = 0; v < sim->variants.size(); v++) {
+		if(!sim->variantFinished[v]) {
+			houses.push_back(sim->variants[v]);
+			finished.push_back(&sim->variantFinished[v]);
+		}
+	}
+}
+
+static void sub_endMinute(regcap_simulation* sim) {
+	int finished = sim->simFinished;
+	if(sim->prefix) {
+		vector<simulation_struct*> forked = sim->prefix->check();
+		for(size_t k = 0; k < forked.size(); k++) {
+			sim->variants.push_back(forked[k]);
+			sim->variantFinished.push_back(sim->simFinished);
+		}
+		for(size_t v = 0; v < sim->variants.size(); v++)
+			finished = finished && sim->variantFinished[v];
+	}
+	sim->finished = finished;
+}
+
+static void sub_stepMinute(regcap_simulation* sim, const regcap_weather& weather) {
+	vector<simulation_struct*> houses;
+	vector<int*> finished;
+
+	sub_beginMinute(sim, weather, houses, finished);
+	for(size_t h = 0; h < houses.size(); h++) {
+		if(!houses[h]->step(weather))
+			*finished[h] = 1;
+	}
+	sub_endMinute(sim);
+}
+
+int regcap_step(regcap_simulation* sim, const regcap_weather* weather, int minutes) {
+	return regcap_stepTrace(sim, weather, minutes, 0, 0, 0);
+}
+
+int regcap_stepTrace(regcap_simulation* sim, const regcap_weather* weather, int minutes, const int* variables, int numVariables, double* trace) {
+	keepReports_struct keep;
+	int stepped = 0;
+
+	// The trace needs the output variables filled, which a simulation created with noOutputVariables skips
+	int outputVariables = sim->sim->outputVariablesFlag;
+	if(numVariables > 0)
+		sim->sim->outputVariablesFlag = 1;
+
+	while(stepped < minutes && !sim->finished) {
+		sub_stepMinute(sim, weather[stepped]);
+
+		for(int i = 0; i < numVariables; i++)
+			trace[stepped * numVariables + i] = sim->sim->output[variables[i]];
+		stepped++;
+	}
+	sim->sim->outputVariablesFlag = outputVariables;
+	sim->minutes = sim->minutes + stepped;
+	return stepped;
+}
+
+int regcap_stepGroup(regcap_simulation** sims, int numSims, const regcap_weather* weather) {
+	keepReports_struct keep;
+	vector<simulation_struct*> houses;
+	vector<int*> finished;
+	vector<int> stepping(numSims);
+	int stepped = 0;
+
+	for(int i = 0; i < numSims; i++) {
+		stepping[i] = !sims[i]->finished;
+		if(stepping[i])
+			sub_beginMinute(sims[i], *weather, houses, finished);
+	}
+
+	if(!houses.empty()) {
+		vector<int> result(houses.size());
+		sub_stepLanes(&houses[0], (int) houses.size(), *weather, &result[0]);
+		for(size_t h = 0; h < houses.size(); h++) {
+			if(!result[h])
+				*finished[h] = 1;
+		}
+	}
+
+	for(int i = 0; i < numSims; i++) {
+		if(stepping[i]) {
+			sub_endMinute(sims[i]);
+			sims[i]->minutes++;
+			stepped++;
+		}
+	}
+	return stepped;
+}
+
+int regcap_finished(const regcap_simulation* sim) {
+	return sim->finished;
+}
+
+int regcap_variable(const char* name) {
+	return f_outputVariable(name);
+}
+
+int regcap_numVariables(void) {
+	return f_outputCount();
+}
+
+const char* regcap_variableName(int variable) {
+	return f_outputName(variable);
+}
+
+const double* regcap_outputs(const regcap_simulation* sim) {
+	keepReports_struct keep;
+	if(!sim->sim->outputVariablesFlag) {
+		sub_report("The output variables are not filled for a simulation created with noOutputVariables = 1");
+		return 0;
+	}
+	return &sim->sim->output[0];
+}
+
+// The simulation keeps sums over the minutes; the means are taken here without changing them
+void regcap_getTotals(const regcap_simulation* sim, regcap_totals* totals) {
+	simulation_struct* s = sim->sim;
+	double minutes = sim->minutes > 0 ? (double) sim->minutes : 1;
+
+	totals->minutes = sim->minutes;
+	totals->AH_kWh = s->AH_kWh;
+	totals->furnace_kWh = s->furnace_kWh;
+	totals->compressor_kWh = s->compressor_kWh;
+	totals->mechVent_kWh = s->mechVent_kWh;
+	totals->total_kWh = s->AH_kWh + s->furnace_kWh + s->compressor_kWh + s->mechVent_kWh;
+	totals->rivecMinutes = s->rivecMinutes;
+	totals->meanHouseTemp = s->meanHouseTemp / minutes;
+	totals->meanRelExp = s->meanRelExp / minutes;
+	totals->meanRelDose = s->meanRelDose / minutes;
+	totals->RHexc60 = s->RHtot60 / minutes;
+	totals->RHexc70 = s->RHtot70 / minutes;
+
+	for(int k = 0; k < REGCAP_SOLVERS; k++) {
+		totals->iterations[k] = s->convergence.totalIterations[k];
+		for(size_t v = 0; v < sim->variants.size(); v++)
+			totals->iterations[k] = totals->iterations[k] + sim->variants[v]->convergence.totalIterations[k];
+	}
+}
+
+void regcap_setRivec(regcap_simulation* sim, int rivecOn) {
+	sim->sim->rivecOverride = rivecOn;
+}
+
+void regcap_setAH(regcap_simulation* sim, int AHon) {
+	sim->sim->AHoverride = AHon;
+}
+
+// The variants that never forked are copies of the simulation at its end (see prefix_struct::finish); the variants'
+// files are closed by the prefix once the simulation's own are, as they are fed from them until the fork
+int regcap_finish(regcap_simulation* sim) {
+	if(!sim->files)
+		return 0;
+	keepReports_struct keep;
+
+	if(sim->prefix) {
+		vector<simulation_struct*> forked = sim->prefix->finish();
+		for(size_t k = 0; k < forked.size(); k++) {
+			sim->variants.push_back(forked[k]);
+			sim->variantFinished.push_back(1);
+		}
+	}
+
+	int error = sim->sim->finish();
+	if(sim->prefix) {
+		sim->prefix->close();
+		delete sim->prefix;
+		sim->prefix = 0;
+	}
+	for(size_t v = 0; v < sim->variants.size(); v++)
+		error = sim->variants[v]->finish() | error;
+
+	sim->files = 0;
+	return error;
+}
+
+void regcap_finalize(regcap_simulation* sim) {
+	if(!sim)
+		return;
+	if(sim->prefix) {
+		sim->prefix->close();
+		delete sim->prefix;
+	}
+	for(size_t v = 0; v < sim->variants.size(); v++)
+		delete sim->variants[v];
+	delete sim->sim;
+	delete sim;
+}
+
+const char* regcap_lastError(void) {
+	return f_lastReport();
+}
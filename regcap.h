@@ -0,0 +1,178 @@
+#pragma once
+#ifndef regcap_h
+#define regcap_h
+
+// C interface to the simulation engine, built as a shared library (regcap.vcxproj, REGCAP_EXPORTS defined) so that
+// optimisation and analysis code can run houses without going through files:
+//
+//	regcap_config config = {0};
+//	config.building = csvText;					// The text of a building .csv
+//	config.shelterFile = "C:\\RC++\\shelter\\bshelter.dat";
+//	config.latitude = 38.5;
+//	config.altitude = 10;
+//	config.totaldays = 365;
+//	regcap_simulation* house = regcap_create(&config);
+//	int tempHouse = regcap_variable("tempHouse");
+//	if(!house)
+//		... regcap_lastError() ...
+//	for(int m = 0; regcap_step(house, &weather[m], 1) == 1; m++) {
+//		const double* out = regcap_outputs(house);	// This minute's output variables, not copied
+//		... out[tempHouse] ...
+//	}
+//	regcap_finalize(house);
+//
+// Weather is pushed by the caller, a minute per sample. A sample is only read, so one sample can be stepped by
+// many simulations, as rc++ does for the simulations that share a weather file. Output variables are those of the
+// output registry, which starts with the .rco and .hum columns (see output.h); regcap_variable() gives the position
+// of one by name.
+// Nothing is written to disk unless the config has an output name. The simulation then writes the files of a batch
+// simulation: the per-minute files as it steps, and the summaries when regcap_finish() is called. The batch
+// program (main.cpp) runs every simulation this way.
+// The shelter file and the statistics, output, transforms and variants files are read once per process and shared
+// by every simulation; the fan schedule files are only read by buildings with dynamic schedules.
+// Nothing is printed. A call that fails keeps its message for regcap_lastError().
+// A simulation must only be used by one thread at a time; different simulations can run on different threads.
+
+#ifdef _WIN32
+#if defined(REGCAP_EXPORTS)
+#define REGCAP_API __declspec(dllexport)
+#elif defined(REGCAP_STATIC)
+#define REGCAP_API						// Built into the program (rc++.vcxproj)
+#else
+#define REGCAP_API __declspec(dllimport)
+#endif
+#else
+#define REGCAP_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct regcap_simulation regcap_simulation;
+
+// Solvers counted in regcap_totals (see convergenceSolver_enum in convergence.h)
+#define REGCAP_SOLVERS 5
+
+// One minute of weather, as in a .ws3 file. It is also the engine's own sample (weatherSample_struct in weather.h).
+typedef struct {
+	int day;				// Day of the year
+	int idirect;			// Direct normal solar radiation [W/m2]
+	int solth;				// Total horizontal solar radiation [W/m2]
+	double weatherTemp;		// Outdoor air temperature [C]
+	double HROUT;			// Outdoor humidity ratio [kg/kg]
+	double windSpeed;		// Wind speed at the met station [m/s]
+	double direction;		// Wind direction [degrees]
+	double pRef;			// Outdoor air pressure [kPa]
+	double sc;				// Cloud cover index (0 to 10)
+} regcap_weather;
+
+typedef struct {
+	const char* building;			// Building inputs in the .csv layout
+	const char* shelterFile;
+	const char* fanSchedule1;		// Dynamic fan schedule files without the .txt (0 if the building has none)
+	const char* fanSchedule2;
+	const char* fanSchedule3;
+	double latitude;				// From the first line of the weather file
+	double altitude;
+	int totaldays;
+
+	// The rest can be left zero
+	const char* inPath;				// Building read from inPath + input + ".csv" when building is 0
+	const char* input;
+	const char* weatherPath;		// Folder of the weather file climate, for the monthly means of a transform
+	const char* climate;			// Weather file name, climate@name for a transform from transformsFile (see weather.h)
+	const char* transformsFile;
+	int startDay;					// First day simulated, day of the year, 1 = January 1st (0 is taken as 1); the first sample stepped is of this day
+	int spinupDays;					// Most repeats of the first day before it (see simulation_struct::spinUp)
+	const regcap_weather* firstDay;	// The first day's weather for the repeats, firstDayMinutes samples
+	int firstDayMinutes;
+	unsigned long long scheduleSeed;	// Generated fan schedules instead of the files (see schedule.h)
+	int noOutputVariables;			// 1 = regcap_outputs() is not used, which saves filling it every minute (it returns 0)
+
+	// Files written, named outPath + output + extension (output 0 = none)
+	const char* outPath;
+	const char* output;
+	int minuteOutput;				// 1 = the per-minute files (.rco, .hum, .fil)
+	int convergenceWorst;			// Slowest minutes listed in a .cnv convergence report (0 = no report)
+	int compressionLevel;			// gzip level of the per-minute and output files (see writer.h)
+	const char* statisticsFile;		// .rcs statistics (see statistics.h)
+	const char* outputsFile;		// Extra output files (see output.h)
+	const char* variantsFile;		// Sweep variants of this simulation, by its output name (see prefix.h)
+} regcap_config;
+
+// Running totals since regcap_create()
+typedef struct {
+	long minutes;
+	double AH_kWh;
+	double furnace_kWh;
+	double compressor_kWh;
+	double mechVent_kWh;
+	double total_kWh;
+	long rivecMinutes;
+	double meanHouseTemp;			// [C]
+	double meanRelExp;
+	double meanRelDose;
+	double RHexc60;					// Fraction of the minutes with RH above 60%
+	double RHexc70;
+	long long iterations[REGCAP_SOLVERS];	// Solver iterations, its variants' included
+} regcap_totals;
+
+// Returns 0 if the building cannot be read or a file cannot be opened (see regcap_lastError())
+REGCAP_API regcap_simulation* regcap_create(const regcap_config* config);
+
+// Copy of a simulation at its current minute, for trying something out (see branch.h). Costs a copy of the state.
+// The copy writes no files and has no variants.
+REGCAP_API regcap_simulation* regcap_clone(const regcap_simulation* sim);
+
+// Steps up to minutes minutes, one weather sample each. Returns the minutes stepped: fewer than asked once the
+// simulation has reached totaldays, and 0 from then on.
+REGCAP_API int regcap_step(regcap_simulation* sim, const regcap_weather* weather, int minutes);
+
+// Steps each of the numSims simulations (all different) that has not reached totaldays by one minute of weather, as
+// regcap_step(sims[i], weather, 1) would, but with the airflow and heat balances of the houses, variants included,
+// solved together (see sub_stepLanes() in simulation.h). Returns how many simulations were stepped.
+REGCAP_API int regcap_stepGroup(regcap_simulation** sims, int numSims, const regcap_weather* weather);
+
+// 1 once the simulation, and any variants forked from it, have reached totaldays
+REGCAP_API int regcap_finished(const regcap_simulation* sim);
+
+// As regcap_step(), also copying the chosen output variables of each minute to trace (numVariables per minute). The
+// variables are filled for these minutes even with noOutputVariables.
+REGCAP_API int regcap_stepTrace(regcap_simulation* sim, const regcap_weather* weather, int minutes, const int* variables, int numVariables, double* trace);
+
+// Position of a registered output variable by name (the .rco or .hum column name for the built-in ones), -1 if
+// there is none
+REGCAP_API int regcap_variable(const char* name);
+REGCAP_API int regcap_numVariables(void);
+REGCAP_API const char* regcap_variableName(int variable);
+
+// The output variables of the minute last stepped, regcap_numVariables() of them. The array belongs to the
+// simulation and is overwritten by the next step. Returns 0 for a simulation created with noOutputVariables = 1 (see
+// regcap_lastError()).
+REGCAP_API const double* regcap_outputs(const regcap_simulation* sim);
+
+REGCAP_API void regcap_getTotals(const regcap_simulation* sim, regcap_totals* totals);
+
+// Forces the RIVEC fan on (1) or off (0), or gives it back to the controller (-1)
+REGCAP_API void regcap_setRivec(regcap_simulation* sim, int rivecOn);
+
+// Forces the air handler on (1, heating or cooling as the season has it) or off (0), or gives it back to the
+// thermostat (-1)
+REGCAP_API void regcap_setAH(regcap_simulation* sim, int AHon);
+
+// Closes the files of a simulation with an output name and writes its summaries (.rc2, .cnv, .rcs), and those of
+// its variants. Called once, after the last step; the totals are not kept. Returns 1 if a file cannot be written
+// (see regcap_lastError()), and 0 with nothing to do for a simulation without files.
+REGCAP_API int regcap_finish(regcap_simulation* sim);
+
+REGCAP_API void regcap_finalize(regcap_simulation* sim);
+
+// Message of the last call that failed on this thread, "" if none has
+REGCAP_API const char* regcap_lastError(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
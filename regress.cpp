@@ -0,0 +1,409 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include "driver.h"
+#include "functions.h"
+#include "simulation.h"
+#include "weather.h"
+
+using namespace std;
+
+// Regression harness. Runs every case in a corpus batch file (same layout as the rc++ batch file), times it and
+// compares its .rc2, .rco and .hum files against golden copies column by column. Numbers match when
+// |new - golden| <= abs + rel * |golden| using the tolerances for that column; text must match exactly.
+// A case fails at the first row and column that does not match.
+//
+// Usage: regress [-update] [-days n] [-in folder] [-weather folder] [-shelter file] [-schedules folder] [-schednum suffix]
+//                [-golden folder] [-out folder] [-tolerances file] [corpus batch file]
+//   -update		copy this run's outputs and wall times into the golden folder instead of comparing
+//   -days			simulate only the first n days (goldens must have been made with the same setting)
+//   -in			input files (corpus entries may add a subfolder); the corpus and tolerance files default to
+//					regress_bat.txt and regress_tol.txt in it
+//   -weather		weather files
+//   -shelter		shelter file
+//   -schedules		dynamic fan schedule files, sched1, sched2 and sched3 followed by -schednum (default r)
+//   -golden		golden outputs and wall times
+//   -out			this run's outputs and the regress.txt report
+//   -tolerances	per-column tolerances
+// The defaults are the C:\RC++ folders of the main program.
+//
+// Tolerance file: one line per column, "column abs rel" (lines that do not parse, such as # comments, are skipped).
+// A "*" line sets the default for unlisted columns; without one, unlisted columns must match exactly.
+
+struct tolerance_struct {
+	string column;
+	double absTol;
+	double relTol;
+};
+
+// Where a case first departs from its golden output
+struct difference_struct {
+	string file;
+	long int row;				// Data row (1 = first minute for .rco/.hum), 0 for the header
+	string column;
+	string golden;
+	string value;
+	long int count;				// Values outside tolerance in this file
+};
+
+static const char* outputExtensions[] = { ".rc2", ".rco", ".hum" };
+static const int numOutputExtensions = 3;
+
+static void f_splitTabs(string& line, vector<string>& fields) {
+	fields.clear();
+	if(!line.empty() && line[line.size() - 1] == '\r')
+		line.erase(line.size() - 1);
+
+	size_t start = 0;
+	while(true) {
+		size_t tab = line.find('\t', start);
+		if(tab == string::npos) {
+			fields.push_back(line.substr(start));
+			break;
+		}
+		fields.push_back(line.substr(start, tab - start));
+		start = tab + 1;
+	}
+}
+
+static void f_findTolerance(vector<tolerance_struct>& tolerances, string& column, double& absTol, double& relTol) {
+	absTol = 0;
+	relTol = 0;
+	for(size_t i = 0; i < tolerances.size(); i++) {
+		if(tolerances[i].column == "*") {
+			absTol = tolerances[i].absTol;
+			relTol = tolerances[i].relTol;
+		}
+	}
+	for(size_t i = 0; i < tolerances.size(); i++) {
+		if(tolerances[i].column == column) {
+			absTol = tolerances[i].absTol;
+			relTol = tolerances[i].relTol;
+			return;
+		}
+	}
+}
+
+static int f_valuesMatch(string& golden, string& value, double absTol, double relTol) {
+	if(golden == value)
+		return 1;
+
+	char* goldenEnd;
+	char* valueEnd;
+	double g = strtod(golden.c_str(), &goldenEnd);
+	double v = strtod(value.c_str(), &valueEnd);
+	if(*goldenEnd != '\0' || *valueEnd != '\0' || golden.empty() || value.empty())
+		return 0;		// Text that differs
+
+	return abs(v - g) <= absTol + relTol * abs(g);
+}
+
+// Returns 0 if the files match within tolerance, 1 if they differ (diff holds the first difference), 2 if either is missing
+static int f_compareFile(string goldenFile_name, string outFile_name, vector<tolerance_struct>& tolerances, difference_struct& diff) {
+	ifstream goldenFile(goldenFile_name);
+	ifstream outFile(outFile_name);
+	if(!goldenFile || !outFile)
+		return 2;
+
+	string goldenLine, outLine;
+	vector<string> header, goldenFields, outFields;
+	vector<double> absTol, relTol;
+	long int row = 0;
+	int differs = 0;
+
+	diff.count = 0;
+
+	while(true) {
+		bool moreGolden = getline(goldenFile, goldenLine) ? true : false;
+		bool moreOut = getline(outFile, outLine) ? true : false;
+
+		if(!moreGolden && !moreOut)
+			break;
+
+		if(moreGolden != moreOut) {
+			if(!differs) {
+				diff.row = row;
+				diff.column = "(rows)";
+				diff.golden = moreGolden ? "more rows" : "end of file";
+				diff.value = moreOut ? "more rows" : "end of file";
+			}
+			diff.count++;
+			return 1;
+		}
+
+		f_splitTabs(goldenLine, goldenFields);
+		f_splitTabs(outLine, outFields);
+
+		if(row == 0) {
+			header = goldenFields;
+			for(size_t i = 0; i < header.size(); i++) {
+				double a, r;
+				f_findTolerance(tolerances, header[i], a, r);
+				absTol.push_back(a);
+				relTol.push_back(r);
+			}
+		}
+
+		if(goldenFields.size() != outFields.size()) {
+			if(!differs) {
+				differs = 1;
+				diff.row = row;
+				diff.column = "(columns)";
+				diff.golden = goldenLine;
+				diff.value = outLine;
+			}
+			diff.count++;
+		} else {
+			for(size_t i = 0; i < goldenFields.size(); i++) {
+				double a = i < absTol.size() ? absTol[i] : 0;
+				double r = i < relTol.size() ? relTol[i] : 0;
+
+				if(!f_valuesMatch(goldenFields[i], outFields[i], a, r)) {
+					if(!differs) {
+						differs = 1;
+						diff.row = row;
+						diff.column = i < header.size() ? header[i] : "";
+						diff.golden = goldenFields[i];
+						diff.value = outFields[i];
+					}
+					diff.count++;
+				}
+			}
+		}
+		row++;
+	}
+
+	return differs;
+}
+
+static int f_copyFile(string from, string to) {
+	ifstream fromFile(from, ios::binary);
+	ofstream toFile(to, ios::binary | ios::trunc);
+	if(!fromFile || !toFile)
+		return 1;
+
+	toFile << fromFile.rdbuf();
+	return 0;
+}
+
+// Runs one case on its own weather file. Returns 1 if a file cannot be opened.
+static int f_runCase(batch_struct& batch, string& simFile, string& climateZone, string& outName, double& seconds) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	weatherFile_struct weatherFile;
+	double latitude, altitude;
+
+	if(sub_openWeather(weatherFile, f_weatherFile_name(batch.weatherPath, climateZone), latitude, altitude)) {
+		cout << "Cannot open: " << f_weatherFile_name(batch.weatherPath, climateZone) << endl;
+		return 1;
+	}
+
+	simulation_struct* house = new simulation_struct();
+
+	if(house->init(batch, simFile, climateZone, outName, latitude, altitude)) {
+		delete house;
+		return 1;
+	}
+
+	weatherSample_struct weather;
+	do {
+		f_readWeather(weatherFile, weather);
+	} while(house->step(weather) && !weatherFile.fail());
+
+	weatherFile.close();
+
+	int error = house->finish();
+	delete house;
+
+	seconds = chrono::duration_cast<chrono::duration<double> >(chrono::steady_clock::now() - start).count();
+	return error;
+}
+
+int main(int argc, char* argv[])
+{
+	// [File Paths] Paths for the corpus inputs, golden outputs and this run's outputs
+	// These are the defaults (weather, shelter and schedules from sub_defaultSettings in driver.cpp); see the command line options above
+	driverSettings_struct defaults;
+	sub_defaultSettings(defaults);
+
+	string inPath = "C:\\RC++\\in\\";								// Location of input files (corpus entries may add a subfolder)
+	string weatherPath = defaults.weatherPath;						// Location of weather files
+	string shelterFile_name = defaults.shelterFile_name;			// Location of shelter file
+	string schedulePath = defaults.schedulePath;					// Location of dynamic fan schedule files
+	string goldenPath = "C:\\RC++\\regress\\golden\\";				// Location of golden outputs
+	string outPath = "C:\\RC++\\regress\\out\\";					// Location to write this run's outputs
+	string corpusFile_name;											// Corpus batch file (regress_bat.txt in the input folder)
+	string toleranceFile_name;										// Per-column tolerances (regress_tol.txt in the input folder)
+
+	// Own dynamic fan schedule files so a regression run does not clash with a batch running at the same time
+	string SCHEDNUM = "r";
+
+	int totaldays = defaults.totaldays;
+	int updateFlag = 0;
+
+	for(int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		int hasValue = i + 1 < argc;
+		if(arg == "-update")
+			updateFlag = 1;
+		else if(arg == "-days" && hasValue)
+			totaldays = atoi(argv[++i]);
+		else if(arg == "-in" && hasValue)
+			inPath = f_folder(argv[++i]);
+		else if(arg == "-weather" && hasValue)
+			weatherPath = f_folder(argv[++i]);
+		else if(arg == "-shelter" && hasValue)
+			shelterFile_name = argv[++i];
+		else if(arg == "-schedules" && hasValue)
+			schedulePath = f_folder(argv[++i]);
+		else if(arg == "-schednum" && hasValue)
+			SCHEDNUM = argv[++i];
+		else if(arg == "-golden" && hasValue)
+			goldenPath = f_folder(argv[++i]);
+		else if(arg == "-out" && hasValue)
+			outPath = f_folder(argv[++i]);
+		else if(arg == "-tolerances" && hasValue)
+			toleranceFile_name = argv[++i];
+		else if(arg[0] == '-' || !corpusFile_name.empty()) {
+			cout << "Usage: regress [-update] [-days n] [-in folder] [-weather folder] [-shelter file] [-schedules folder] [-schednum suffix] "
+				<< "[-golden folder] [-out folder] [-tolerances file] [corpus batch file]" << endl;
+			return 2;
+		}
+		else
+			corpusFile_name = arg;
+	}
+	if(corpusFile_name.empty())
+		corpusFile_name = inPath + "regress_bat.txt";
+	if(toleranceFile_name.empty())
+		toleranceFile_name = inPath + "regress_tol.txt";
+
+	// [START] Reading Corpus and Tolerances ===============================================================================
+	char reading[255];
+	int numCases;
+	vector<string> simFile, climateZone, outName;
+
+	ifstream corpusFile(corpusFile_name);
+	if(!corpusFile) {
+		cout << "Cannot open: " << corpusFile_name << endl;
+		return 2;
+	}
+
+	corpusFile.getline(reading, 255);
+	numCases = atoi(reading);
+
+	for(int i = 0; i < numCases; i++) {
+		string line[3];
+		for(int k = 0; k < 3; k++) {
+			getline(corpusFile, line[k]);
+			if(!line[k].empty() && line[k][line[k].size() - 1] == '\r')		// The corpus is kept with DOS line ends
+				line[k].erase(line[k].size() - 1);
+		}
+		simFile.push_back(line[0]);
+		climateZone.push_back(line[1]);
+		outName.push_back(line[2]);
+	}
+	corpusFile.close();
+
+	vector<tolerance_struct> tolerances;
+	ifstream toleranceFile(toleranceFile_name);
+	if(toleranceFile) {
+		string line;
+		while(getline(toleranceFile, line)) {
+			istringstream fields(line);
+			tolerance_struct tolerance;
+			if(fields >> tolerance.column >> tolerance.absTol >> tolerance.relTol)
+				tolerances.push_back(tolerance);
+		}
+		toleranceFile.close();
+	}
+	// [END] Reading Corpus and Tolerances =================================================================================
+
+	batch_struct batch;
+	batch.inPath = inPath;
+	batch.outPath = outPath;
+	batch.weatherPath = weatherPath;
+	batch.shelterFile_name = shelterFile_name;
+	batch.fanSchedulefile_name1 = schedulePath + "sched1" + SCHEDNUM;
+	batch.fanSchedulefile_name2 = schedulePath + "sched2" + SCHEDNUM;
+	batch.fanSchedulefile_name3 = schedulePath + "sched3" + SCHEDNUM;
+	batch.totaldays = totaldays;
+	batch.startDay = 1;
+	batch.spinupDays = 0;
+	batch.convergenceFlag = 0;
+	batch.convergenceWorst = 0;
+	batch.minuteOutputFlag = 1;
+	batch.compressionLevel = 0;
+	batch.scheduleSeed = 0;
+
+	ofstream reportFile(outPath + "regress.txt");
+	if(!reportFile) {
+		cout << "Cannot open: " << outPath + "regress.txt" << endl;
+		return 2;
+	}
+
+	string header = "Case\tStatus\tSeconds\tGolden seconds\tFile\tRow\tColumn\tGolden\tValue\tValues outside tolerance";
+	cout << header << endl;
+	reportFile << header << endl;
+
+	int numFailed = 0;
+
+	for(int i = 0; i < numCases; i++) {
+		double seconds = 0;
+		double goldenSeconds = 0;
+		string status;
+		difference_struct diff;
+		int differs = 0;
+
+		ifstream goldenTimeFile(goldenPath + outName[i] + ".sec");
+		if(goldenTimeFile)
+			goldenTimeFile >> goldenSeconds;
+		goldenTimeFile.close();
+
+		if(f_runCase(batch, simFile[i], climateZone[i], outName[i], seconds)) {
+			status = "ERROR";
+		} else if(updateFlag) {
+			status = "UPDATED";
+			for(int k = 0; k < numOutputExtensions; k++) {
+				if(f_copyFile(outPath + outName[i] + outputExtensions[k], goldenPath + outName[i] + outputExtensions[k]))
+					status = "ERROR";
+			}
+			ofstream timeFile(goldenPath + outName[i] + ".sec");
+			timeFile << seconds << endl;
+		} else {
+			status = "PASS";
+			for(int k = 0; k < numOutputExtensions && !differs; k++) {
+				diff.file = outputExtensions[k];
+				differs = f_compareFile(goldenPath + outName[i] + outputExtensions[k], outPath + outName[i] + outputExtensions[k], tolerances, diff);
+			}
+			if(differs == 1)
+				status = "FAIL";
+			else if(differs == 2)
+				status = "NO GOLDEN";
+		}
+
+		if(status != "PASS" && status != "UPDATED")
+			numFailed++;
+
+		ostringstream line;
+		line << outName[i] << "\t" << status << "\t" << fixed << setprecision(2) << seconds << "\t";
+		if(goldenSeconds > 0)
+			line << goldenSeconds;
+		if(differs == 1)
+			line << "\t" << diff.file << "\t" << diff.row << "\t" << diff.column << "\t" << diff.golden << "\t" << diff.value << "\t" << diff.count;
+
+		cout << line.str() << endl;
+		reportFile << line.str() << endl;
+	}
+
+	reportFile.close();
+
+	cout << endl << numCases - numFailed << "/" << numCases << " cases passed" << endl;
+
+	return numFailed > 0 ? 1 : 0;
+}
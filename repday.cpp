@@ -0,0 +1,440 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include "driver.h"
+#include "output.h"
+#include "simulation.h"
+#include "weather.h"
+
+using namespace std;
+
+// Annual results from representative days, for screening many houses at a fraction of the cost of full years.
+// The days of the weather file are clustered by k-medoids (PAM: greedy build, then swaps while they lower the cost)
+// on their hourly outdoor temperature, humidity ratio, total solar radiation and wind speed, each scaled by its
+// standard deviation over the year. Only the medoid of each cluster is simulated, as a one-day window repeated
+// on its own until it settles (simulation_struct::spinUp), and each house's annual .rc2 is put together from them
+// weighted by the days in their clusters: energy, minutes, filter changes and ventilation loads are added up
+// (scaled to the year), the other columns are averaged. Weekday fan and occupancy schedules follow the medoid's
+// own day of the week. The relative dose columns remember weeks of ventilation, more than a repeated day can
+// settle, so they are the least reliable; the validation runs show by how much. The screening file has
+// "name value" lines (# starts a comment):
+//
+//	building		Tester1 Tester5		Houses to screen (.csv files in the input folder, as in a batch file)
+//	climate			01					Weather file, without .ws3 (or with .epw or .csv for hourly files), with an
+//										optional @transform (see weather.h)
+//	transforms		future.txt			Weather transforms the climate names
+//	days			12					Representative days
+//	spinup			7					Most repeats of each representative day before it counts
+//	validate		2					Also run the full year of the first n houses and report the error
+//	in, out, weather, shelter, schedules, schednum, threads: as for rc++
+//
+// Each house gets <screen>_<house>.rc2 in the output folder. The representative days (<screen>_<house>_d<day>)
+// and full years (<screen>_<house>_year) are kept there and reused by a later run with the same climate, spin-up
+// and building files. The clusters and the validation errors are printed and written to <screen>.rep.
+//
+// Usage: repday [-threads n] screen.txt
+
+struct screen_struct {
+	string name;
+	vector<string> buildings;
+	string climate;
+	int numDays;
+	int numValidate;
+	driverSettings_struct settings;
+};
+
+// One simulation: a representative day of a house, or its full year (day 0)
+struct screenRun_struct {
+	int building;
+	int day;
+};
+
+// Returns 1 if the file cannot be opened and 2 for a bad line or a screen without houses
+static int f_readScreen(string screenFile_name, screen_struct& screen) {
+	ifstream screenFile(screenFile_name);
+	if(!screenFile) {
+		cout << "Cannot open: " << screenFile_name << endl;
+		return 1;
+	}
+
+	string line;
+	while(getline(screenFile, line)) {
+		sub_trimLine(line);
+		istringstream fields(line);
+		string name, value;
+		if(!(fields >> name) || name[0] == '#')
+			continue;
+
+		int bad = 0;
+		if(name == "building") {
+			while(fields >> value)
+				screen.buildings.push_back(value);
+		} else if(!(fields >> value)) {
+			bad = 1;
+		} else if(name == "climate") {
+			screen.climate = value;
+		} else if(name == "days") {
+			screen.numDays = atoi(value.c_str());
+			bad = screen.numDays < 1;
+		} else if(name == "validate") {
+			screen.numValidate = atoi(value.c_str());
+		} else if(name == "start") {
+			bad = 1;								// Each simulation has its own days
+		} else if(!f_driverSetting(screen.settings, name, value, bad)) {
+			bad = 1;
+		}
+
+		if(bad) {
+			cout << "Bad line in " << screenFile_name << ": " << line << endl;
+			return 2;
+		}
+	}
+
+	if(screen.buildings.empty() || screen.climate.empty()) {
+		cout << "A screen needs at least one building and a climate: " << screenFile_name << endl;
+		return 2;
+	}
+	return 0;
+}
+
+static string f_runName(screen_struct& screen, screenRun_struct& run) {
+	ostringstream name;
+	name << screen.name << "_" << screen.buildings[run.building] << "_";
+	if(run.day == 0)
+		name << "year";
+	else
+		name << "d" << setw(3) << setfill('0') << run.day;
+	return name.str();
+}
+
+// What the kept runs were simulated for, in <screen>.rds, so that a later run does not reuse those of another climate,
+// spin-up or version of the building files. Returns 1 if the file cannot be written and 2 if it belongs to a
+// different screen.
+static int f_checkRuns(screen_struct& screen) {
+	string headerFile_name = screen.settings.outPath + screen.name + ".rds";
+	vector<string> buildingFiles;
+	for(size_t b = 0; b < screen.buildings.size(); b++)
+		buildingFiles.push_back(screen.settings.inPath + screen.buildings[b] + ".csv");
+	ostringstream header;
+	header << "climate\t" << screen.climate << "\ttransforms\t" << screen.settings.transformsFile_name << "\tspinup\t" << screen.settings.spinupDays << "\tschedules\t" << screen.settings.schedulePath << screen.settings.SCHEDNUM
+		<< "\tbuildings\t" << f_filesHash(buildingFiles);
+
+	ifstream oldFile(headerFile_name);
+	if(oldFile) {
+		string line;
+		getline(oldFile, line);
+		if(line != header.str()) {
+			cout << "Runs in " << screen.settings.outPath << " were simulated for a different screen; remove " << headerFile_name
+				<< " and the .rc2 files to start again" << endl;
+			return 2;
+		}
+		return 0;
+	}
+
+	ofstream headerFile(headerFile_name);
+	if(!headerFile) {
+		cout << "Cannot open: " << headerFile_name << endl;
+		return 1;
+	}
+	headerFile << header.str() << endl;
+	headerFile.close();
+	return headerFile.fail() ? 1 : 0;
+}
+
+// Hourly features of each whole day of the weather: temperature, humidity ratio, total solar and wind speed, each
+// scaled by its standard deviation over the year
+static void sub_dayFeatures(vector<weatherSample_struct>& weather, vector<vector<double> >& features) {
+	size_t numDays = weather.size() / 1440;
+	features.assign(numDays, vector<double>(96, 0));
+	for(size_t d = 0; d < numDays; d++) {
+		for(int m = 0; m < 1440; m++) {
+			weatherSample_struct& sample = weather[d * 1440 + m];
+			int hour = m / 60;
+			features[d][hour] += sample.weatherTemp / 60;
+			features[d][24 + hour] += sample.HROUT / 60;
+			features[d][48 + hour] += sample.solth / 60.0;
+			features[d][72 + hour] += sample.windSpeed / 60;
+		}
+	}
+
+	for(int v = 0; v < 4; v++) {
+		double sum = 0, sumSquares = 0, count = 0;
+		for(size_t d = 0; d < numDays; d++) {
+			for(int h = 0; h < 24; h++) {
+				double x = features[d][v * 24 + h];
+				sum = sum + x;
+				sumSquares = sumSquares + x * x;
+				count++;
+			}
+		}
+		double mean = sum / count;
+		double stdDev = sqrt(sumSquares / count - mean * mean);
+		if(stdDev <= 0)
+			stdDev = 1;
+		for(size_t d = 0; d < numDays; d++) {
+			for(int h = 0; h < 24; h++)
+				features[d][v * 24 + h] = (features[d][v * 24 + h] - mean) / stdDev;
+		}
+	}
+}
+
+// Sum of each day's distance to its nearest medoid, setting cluster to the position of that medoid
+static double f_clusterCost(vector<vector<double> >& distance, vector<int>& medoids, vector<int>& cluster) {
+	double cost = 0;
+	for(size_t d = 0; d < distance.size(); d++) {
+		for(size_t c = 0; c < medoids.size(); c++) {
+			if(c == 0 || distance[d][medoids[c]] < distance[d][medoids[cluster[d]]])
+				cluster[d] = (int) c;
+		}
+		cost = cost + distance[d][medoids[cluster[d]]];
+	}
+	return cost;
+}
+
+// k-medoids (PAM). Returns the cost; medoids are days from 0 and cluster gives each day's medoid position.
+static double f_kMedoids(vector<vector<double> >& features, int k, vector<int>& medoids, vector<int>& cluster) {
+	size_t n = features.size();
+	vector<vector<double> > distance(n, vector<double>(n, 0));
+	for(size_t i = 0; i < n; i++) {
+		for(size_t j = 0; j < i; j++) {
+			double sum = 0;
+			for(size_t f = 0; f < features[i].size(); f++)
+				sum = sum + (features[i][f] - features[j][f]) * (features[i][f] - features[j][f]);
+			distance[i][j] = sqrt(sum);
+			distance[j][i] = distance[i][j];
+		}
+	}
+
+	// Build: each medoid in turn is the day that lowers the cost most
+	medoids.clear();
+	cluster.assign(n, 0);
+	vector<double> nearest(n, 1e300);
+	for(int c = 0; c < k; c++) {
+		int best = -1;
+		double bestCost = 0;
+		for(size_t i = 0; i < n; i++) {
+			double cost = 0;
+			for(size_t d = 0; d < n; d++)
+				cost = cost + (distance[d][i] < nearest[d] ? distance[d][i] : nearest[d]);
+			if(best < 0 || cost < bestCost) {
+				best = (int) i;
+				bestCost = cost;
+			}
+		}
+		medoids.push_back(best);
+		for(size_t d = 0; d < n; d++) {
+			if(distance[d][best] < nearest[d])
+				nearest[d] = distance[d][best];
+		}
+	}
+
+	// Swap: replace a medoid by another day while that lowers the cost
+	double cost = f_clusterCost(distance, medoids, cluster);
+	int improved = 1;
+	while(improved) {
+		improved = 0;
+		for(int c = 0; c < k; c++) {
+			for(size_t i = 0; i < n; i++) {
+				int kept = medoids[c];
+				medoids[c] = (int) i;
+				double swapped = f_clusterCost(distance, medoids, cluster);
+				if(swapped < cost - 1e-9) {
+					cost = swapped;
+					improved = 1;
+				} else {
+					medoids[c] = kept;
+				}
+			}
+		}
+	}
+	return f_clusterCost(distance, medoids, cluster);
+}
+
+int main(int argc, char* argv[])
+{
+	screen_struct screen;
+	screen.numDays = 12;
+	screen.numValidate = 0;
+	sub_defaultSettings(screen.settings);
+	screen.settings.spinupDays = 7;
+
+	int numThreads;
+	string screenFile_name;
+	if(f_driverArguments(argc, argv, screenFile_name, numThreads)) {
+		cout << "Usage: repday [-threads n] screen.txt" << endl;
+		return 2;
+	}
+
+	int error = f_readScreen(screenFile_name, screen);
+	if(!error)
+		error = f_finishSettings(screen.settings, numThreads);
+	if(error)
+		return error;
+	if(screen.numValidate > (int) screen.buildings.size())
+		screen.numValidate = (int) screen.buildings.size();
+	screen.name = f_studyName(screenFile_name);
+
+	error = f_checkRuns(screen);
+	if(error)
+		return error;
+
+	// [START] Representative days ======================================================================================
+	string weatherFile_name = f_weatherFile_name(screen.settings.weatherPath, screen.climate);
+	vector<weatherSample_struct> weather;
+	double latitude, altitude;
+	if(f_loadWeather(weatherFile_name, 1, weather, latitude, altitude))
+		return 1;
+
+	// The days are clustered as the houses will see them; the simulations transform the weather themselves
+	vector<weatherSample_struct> seen = weather;
+	for(size_t i = 0; i < screen.settings.weatherTransforms.size(); i++) {
+		weatherTransform_struct transform = screen.settings.weatherTransforms[i];
+		if(transform.name != f_transformName(screen.climate))
+			continue;
+		if(f_monthlyMeans(weatherFile_name, transform.monthMean)) {
+			cout << "Cannot open: " << weatherFile_name << endl;
+			return 1;
+		}
+		for(size_t m = 0; m < weather.size(); m++)
+			sub_transformWeather(transform, seen[m]);
+	}
+
+	vector<vector<double> > features;
+	sub_dayFeatures(seen, features);
+	int numDays = (int) features.size();
+	if(screen.numDays > numDays) {
+		cout << "Weather file has only " << numDays << " days: " << weatherFile_name << endl;
+		return 2;
+	}
+
+	vector<int> medoids, cluster;
+	double cost = f_kMedoids(features, screen.numDays, medoids, cluster);
+	vector<double> weight(medoids.size(), 0);
+	for(int d = 0; d < numDays; d++)
+		weight[cluster[d]]++;
+
+	ostringstream report;
+	report << "day\tdays represented" << endl;
+	for(size_t c = 0; c < medoids.size(); c++)
+		report << medoids[c] + 1 << "\t" << weight[c] << endl;
+	report << "mean distance\t" << cost / numDays << endl << endl;
+	cout << report.str();
+	// [END] Representative days ========================================================================================
+
+	// [START] Simulations ==============================================================================================
+	vector<screenRun_struct> runs;
+	for(size_t b = 0; b < screen.buildings.size(); b++) {
+		for(size_t c = 0; c < medoids.size(); c++) {
+			screenRun_struct run = { (int) b, medoids[c] + 1 };
+			runs.push_back(run);
+		}
+		if((int) b < screen.numValidate) {
+			screenRun_struct run = { (int) b, 0 };
+			runs.push_back(run);
+		}
+	}
+
+	batch_struct batch;
+	screen.settings.totaldays = numDays;
+	sub_driverBatch(screen.settings, batch);
+	sharedShelter_struct shelter;
+
+	error = f_runParallel(screen.settings.numThreads, runs.size(), [&](size_t n) -> int {
+		string output_file = f_runName(screen, runs[n]);
+		vector<string> columns;
+		vector<double> values;
+		if(f_readSummary(screen.settings.outPath + output_file + ".rc2", columns, values))
+			return 0;
+
+		// A representative day is a window of its own; a full year starts from the fixed initial conditions
+		batch_struct runBatch = batch;
+		size_t first = 0;
+		size_t last = (size_t) numDays * 1440;
+		if(runs[n].day > 0) {
+			runBatch.startDay = runs[n].day;
+			runBatch.totaldays = runs[n].day;
+			first = (size_t) (runs[n].day - 1) * 1440;
+			last = first + 1440;
+		} else {
+			runBatch.spinupDays = 0;
+		}
+		vector<weatherSample_struct> days(weather.begin() + first, weather.begin() + last);
+		return f_simulateRun(runBatch, "", screen.buildings[runs[n].building], screen.climate, output_file, days, latitude, altitude, shelter);
+	}, [&](size_t done) {
+		if(done % 10 == 0)
+			cout << "Simulations: " << done << endl;
+	});
+	if(error)
+		return 1;
+	// [END] Simulations ================================================================================================
+
+	// [START] Annual results ===========================================================================================
+	report << "house\tcolumn\tyear\trepresentative days\terror%" << endl;
+	for(size_t b = 0; b < screen.buildings.size(); b++) {
+		vector<string> columns;
+		vector<double> annual(SUMMARY_COLUMNS, 0);
+		for(size_t c = 0; c < medoids.size(); c++) {
+			screenRun_struct run = { (int) b, medoids[c] + 1 };
+			string rc2File_name = screen.settings.outPath + f_runName(screen, run) + ".rc2";
+			vector<double> values;
+			if(!f_readSummary(rc2File_name, columns, values)) {
+				cout << "Cannot open: " << rc2File_name << endl;
+				return 1;
+			}
+			for(int i = 0; i < SUMMARY_COLUMNS; i++)
+				annual[i] = annual[i] + weight[c] * values[i];
+		}
+		for(int i = 0; i < SUMMARY_COLUMNS; i++) {
+			if(!summaryColumns[i].total)
+				annual[i] = annual[i] / numDays;
+		}
+
+		string rc2File_name = screen.settings.outPath + screen.name + "_" + screen.buildings[b] + ".rc2";
+		ofstream rc2File(rc2File_name);
+		if(!rc2File) {
+			cout << "Cannot open: " << rc2File_name << endl;
+			return 1;
+		}
+		for(int i = 0; i < SUMMARY_COLUMNS; i++)
+			rc2File << (i ? "\t" : "") << columns[i];
+		rc2File << endl;
+		for(int i = 0; i < SUMMARY_COLUMNS; i++)
+			rc2File << (i ? "\t" : "") << annual[i];
+		rc2File << endl;
+		rc2File.close();
+
+		if((int) b >= screen.numValidate)
+			continue;
+
+		screenRun_struct run = { (int) b, 0 };
+		string yearFile_name = screen.settings.outPath + f_runName(screen, run) + ".rc2";
+		vector<double> year;
+		if(!f_readSummary(yearFile_name, columns, year)) {
+			cout << "Cannot open: " << yearFile_name << endl;
+			return 1;
+		}
+		for(int i = 0; i < SUMMARY_COLUMNS; i++) {
+			report << screen.buildings[b] << "\t" << columns[i] << "\t" << year[i] << "\t" << annual[i] << "\t";
+			if(year[i] != 0)
+				report << 100 * (annual[i] - year[i]) / fabs(year[i]);
+			report << endl;
+		}
+	}
+
+	string reportFile_name = screen.settings.outPath + screen.name + ".rep";
+	ofstream reportFile(reportFile_name);
+	if(!reportFile) {
+		cout << "Cannot open: " << reportFile_name << endl;
+		return 1;
+	}
+	reportFile << report.str();
+	if(screen.numValidate > 0)
+		cout << report.str().substr(report.str().find("house\t"));
+	// [END] Annual results =============================================================================================
+	return 0;
+}
@@ -0,0 +1,35 @@
+#include "report.h"
+#include <iostream>
+#include <cstring>
+
+using namespace std;
+
+// Per thread, as different simulations can run on different threads. Plain arrays, which VS2012 can keep per thread.
+#ifdef _WIN32
+#define REPORT_THREAD __declspec(thread)
+#else
+#define REPORT_THREAD __thread
+#endif
+
+static REPORT_THREAD int keepReports = 0;
+static REPORT_THREAD char lastReport[REPORT_LENGTH];
+
+void sub_report(string message) {
+	if(!keepReports) {
+		cout << message << endl;
+		return;
+	}
+	size_t length = message.size() < (size_t) REPORT_LENGTH - 1 ? message.size() : (size_t) REPORT_LENGTH - 1;
+	memcpy(lastReport, message.c_str(), length);
+	lastReport[length] = 0;
+}
+
+int f_keepReports(int keep) {
+	int kept = keepReports;
+	keepReports = keep;
+	return kept;
+}
+
+const char* f_lastReport() {
+	return lastReport;
+}
@@ -0,0 +1,23 @@
+#pragma once
+#ifndef report_h
+#define report_h
+
+#include <string>
+
+using namespace std;
+
+// Messages from the simulation engine and the input files it reads: files that cannot be opened or written, lines
+// that cannot be used and solver failures. They go to the console, unless the thread keeps them instead, as the
+// regcap library does so that its callers can ask for them (see regcap_lastError() in regcap.h).
+
+const int REPORT_LENGTH = 512;		// Longest message kept, with its terminating zero
+
+void sub_report(string message);
+
+// Sets whether this thread keeps its messages (1) or prints them (0). Returns the setting it had.
+int f_keepReports(int keep);
+
+// The last message kept on this thread, "" if none. It stays valid until the thread's next message.
+const char* f_lastReport();
+
+#endif
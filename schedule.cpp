@@ -0,0 +1,142 @@
+#include "schedule.h"
+
+using namespace std;
+
+// Weekday morning bathroom fan of each bathroom (fan_schedule.m): start hour, minute and length
+static const int morningFan[3][3] = {
+	{ 6, 30, 60 },
+	{ 6, 30, 60 },
+	{ 7, 0, 30 }
+};
+
+static const int prototypeOccupants[3][3] = {
+	{ 2, 2, 0 },		// B: 2 bathrooms, 4 occupants
+	{ 2, 1, 1 },		// C: 3 bathrooms, 4 occupants
+	{ 2, 2, 1 }			// D: 3 bathrooms, 5 occupants
+};
+
+const int WC_START = 16;			// Weekday toilet visits start between WC_START and WC_START + WC_SPAN - 1 o'clock
+const int WC_SPAN = 7;
+const int WC_MINS = 10;
+const int SHOWER_START = 7;			// Weekend showers
+const int SHOWER_SPAN = 12;
+const int SHOWER_MINS = 30;
+const int WEEKEND_WC_START = 7;
+const int WEEKEND_WC_SPAN = 16;
+
+unsigned long long f_mix(unsigned long long x) {
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+unsigned long long f_scheduleSeed(unsigned long long batchSeed, string name) {
+	unsigned long long seed = f_mix(batchSeed);
+	for(size_t i = 0; i < name.size(); i++)
+		seed = f_mix(seed ^ (unsigned char) name[i]);
+	return seed;
+}
+
+// Returns 1 if there is no prototype for the bathroom schedule
+int fanSchedule_struct::init(int bathroomSchedule, unsigned long long seed) {
+	if(bathroomSchedule < 1 || bathroomSchedule > 3)
+		return 1;
+
+	this->seed = seed;
+	for(int b = 0; b < 3; b++)
+		bathOccupants[b] = prototypeOccupants[bathroomSchedule - 1][b];
+	day = 0;
+	minute = 1440;
+	return 0;
+}
+
+void fanSchedule_struct::next(int& dryerFan, int& kitchenFan, int& bathOneFan, int& bathTwoFan, int& bathThreeFan) {
+	if(minute == 1440) {
+		day++;
+		minute = 0;
+		sub_day();
+	}
+
+	unsigned char on = fans[minute];
+	dryerFan = on & 1;
+	kitchenFan = (on >> 1) & 1;
+	bathOneFan = (on >> 2) & 1;
+	bathTwoFan = (on >> 3) & 1;
+	bathThreeFan = (on >> 4) & 1;
+	minute++;
+}
+
+// Draw number count (then count + 1) of the day for a stream: a whole number from 0 to n - 1
+int fanSchedule_struct::f_draw(int stream, int& count, int n) {
+	unsigned long long key = ((unsigned long long) day << 32) | ((unsigned long long) stream << 24) | (unsigned long long) count;
+	count++;
+	return (int) (f_mix(seed ^ f_mix(key)) % (unsigned long long) n);
+}
+
+void fanSchedule_struct::sub_fan(int bit, int hour, int minute, int minutes) {
+	for(int m = hour * 60 + minute; m < hour * 60 + minute + minutes && m < 1440; m++)
+		fans[m] = fans[m] | (unsigned char) (1 << bit);
+}
+
+void fanSchedule_struct::sub_day() {
+	int dayOfWeek = (day - 1) % 7;			// 0 = Sunday
+	int weekend = dayOfWeek == 0 || dayOfWeek == 6;
+
+	for(int m = 0; m < 1440; m++)
+		fans[m] = 0;
+
+	// Dryer and kitchen
+	if(dayOfWeek == 0 || dayOfWeek == 3)
+		sub_fan(0, 11, 0, 180);
+	if(weekend)
+		sub_fan(1, 9, 30, 30);
+	sub_fan(1, 17, 30, 60);
+
+	// Bathrooms (fanWeek.m and fanWeekend.m)
+	for(int b = 0; b < 3; b++) {
+		int occupants = bathOccupants[b];
+		int count = 0;
+		if(occupants == 0)
+			continue;
+
+		if(!weekend) {
+			int wcH[2], wcM[2];
+			for(int i = 0; i < 2; i++)
+				wcH[i] = WC_START + f_draw(b, count, WC_SPAN);
+			for(int i = 0; i < 2; i++)
+				wcM[i] = f_draw(b, count, 2) * 30;
+			while(wcH[0] == wcH[1] && wcM[0] == wcM[1])
+				wcM[1] = f_draw(b, count, 2) * 30;
+
+			sub_fan(2 + b, morningFan[b][0], morningFan[b][1], morningFan[b][2]);
+			sub_fan(2 + b, wcH[0], wcM[0], WC_MINS);
+			if(occupants == 2)
+				sub_fan(2 + b, wcH[1], wcM[1], WC_MINS);
+			continue;
+		}
+
+		int showerH[2], showerM[2], wcH[2], wcM[2];
+		for(int i = 0; i < 2; i++)
+			showerH[i] = SHOWER_START + f_draw(b, count, SHOWER_SPAN);
+		for(int i = 0; i < 2; i++)
+			showerM[i] = f_draw(b, count, 2) * 30;
+		while(showerH[0] == showerH[1] && showerM[0] == showerM[1])
+			showerM[1] = f_draw(b, count, 2) * 30;
+
+		for(int i = 0; i < 2; i++)
+			wcH[i] = WEEKEND_WC_START + f_draw(b, count, WEEKEND_WC_SPAN);
+		while(wcH[0] == showerH[0] || wcH[0] == showerH[1])
+			wcH[0] = WEEKEND_WC_START + f_draw(b, count, WEEKEND_WC_SPAN);
+		while(wcH[1] == showerH[0] || wcH[1] == showerH[1] || wcH[1] == wcH[0])
+			wcH[1] = WEEKEND_WC_START + f_draw(b, count, WEEKEND_WC_SPAN);
+		for(int i = 0; i < 2; i++)
+			wcM[i] = f_draw(b, count, 2) * 30;
+
+		sub_fan(2 + b, showerH[0], showerM[0], SHOWER_MINS);
+		if(occupants == 2)
+			sub_fan(2 + b, showerH[1], showerM[1], SHOWER_MINS);
+		sub_fan(2 + b, wcH[0], wcM[0], WC_MINS);
+		if(occupants == 2)
+			sub_fan(2 + b, wcH[1], wcM[1], WC_MINS);
+	}
+}
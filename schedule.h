@@ -0,0 +1,45 @@
+#pragma once
+#ifndef schedule_h
+#define schedule_h
+
+#include <string>
+
+using namespace std;
+
+// Dynamic fan schedules generated in the engine, as an alternative to the sched1, sched2 and sched3 files. This
+// is a port of the Matlab scripts that made those files (schedules/Schedule Generation Matlab Files: fan_schedule.m,
+// fanWeek.m and fanWeekend.m):
+//	Dryer		Sundays and Wednesdays from 11:00 for 3 hours
+//	Kitchen		Weekends from 9:30 for 30 minutes, and every day from 17:30 for an hour
+//	Bathrooms	Weekdays a morning fan at a fixed time, then a 10 minute toilet visit starting on the hour or half
+//				hour between 16:00 and 22:30 for each occupant. Weekends a 30 minute shower between 7:00 and 18:30
+//				and a toilet visit between 7:00 and 22:30 for each occupant, in different hours from the showers.
+// The prototypes are those of the schedule files' readme. Their occupants are split between the bathrooms as two
+// and two for 1 (B), two, one and one for 2 (C), and two, two and one for 3 (D), the house fan_schedule.m makes.
+// Day 1 is a Sunday, as for weekendFlag.
+//
+// The random times come from a counter-based generator: each draw is a hash of the seed, the day, the bathroom and
+// the draw's number. A day's schedule therefore depends only on the seed and the day, so every case is
+// reproducible from its seed and a simulation can be copied at any minute.
+struct fanSchedule_struct {
+	int init(int bathroomSchedule, unsigned long long seed);
+	void next(int& dryerFan, int& kitchenFan, int& bathOneFan, int& bathTwoFan, int& bathThreeFan);
+
+	void sub_day();
+	void sub_fan(int bit, int hour, int minute, int minutes);
+	int f_draw(int stream, int& count, int n);
+
+	unsigned long long seed;
+	int bathOccupants[3];			// 0 = no such bathroom
+	int day;						// Day whose minutes are in fans (from 1)
+	int minute;						// Minute of the day handed out next
+	unsigned char fans[1440];		// Bit 0 = dryer, 1 = kitchen, 2 to 4 = bathrooms
+};
+
+// splitmix64 finaliser, the hash behind every draw (also of the study drivers' random inputs)
+unsigned long long f_mix(unsigned long long x);
+
+// Seed of one simulation from the batch's seed and its output name, so that every case gets its own realization
+unsigned long long f_scheduleSeed(unsigned long long batchSeed, string name);
+
+#endif
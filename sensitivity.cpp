@@ -0,0 +1,410 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include "driver.h"
+#include "output.h"
+#include "simulation.h"
+#include "weather.h"
+
+using namespace std;
+
+// Global sensitivity analysis of the annual results. A study file declares ranges for some lines of a building
+// .csv; the program samples them (Morris trajectories or Saltelli's Sobol design), simulates every sample in every
+// climate on all cores, and works out from the .rc2 files which inputs drive which results. The study file has
+// "name value" lines (# starts a comment):
+//
+//	method		morris				morris or sobol
+//	samples		20					Morris trajectories, or base samples for Sobol (runs = samples * (inputs + 2))
+//	levels		4					Morris grid levels
+//	seed		1
+//	building	Tester1.csv			In the input folder
+//	climates	01 07				Weather files, without .ws3 (or with .epw or .csv for hourly files), each with an
+//								optional @transform (see weather.h)
+//	transforms	future.txt			Weather transforms the climates name
+//	input		24 UAh 150 400		Line of the .csv (from 1), name, low, high
+//	output		total_kWh			.rc2 column (default total_kWh, meanRelExpReal and RHexcAnnual60)
+//	start		6/21				First day simulated (day of the year or month/day); days is the last
+//	spinup		14					Most repeats of the first day to settle the starting conditions (see simulation.h)
+//	in, out, weather, shelter, schedules, schednum, days, threads: as for rc++
+//
+// The samples are written once to <study>.smp in the output folder and read back on later runs, and each run's
+// .rc2 (<study>_<climate>_<run>) is kept there, so an interrupted study picks up where it stopped: runs whose .rc2
+// is complete are not simulated again. A changed building file is a different study (its hash is in the .smp). Each weather file is read once and shared by the simulations of its climate.
+// The indices are printed and written to <study>.sen:
+//	Morris: mean, mean of the absolute values and standard deviation of the elementary effects, per input range
+//	Sobol: first-order (Saltelli 2010) and total-order (Jansen) indices
+//
+// Usage: sensitivity [-threads n] study.txt
+
+struct studyInput_struct {
+	int line;
+	string name;
+	double low;
+	double high;
+};
+
+struct study_struct {
+	string name;
+	string method;
+	int samples;
+	int levels;
+	unsigned int seed;
+	string building;
+	vector<string> climates;
+	vector<studyInput_struct> inputs;
+	vector<string> outputs;
+	driverSettings_struct settings;
+};
+
+// Returns 1 if the file cannot be opened and 2 for a bad line or a study without inputs or climates
+static int f_readStudy(string studyFile_name, study_struct& study) {
+	ifstream studyFile(studyFile_name);
+	if(!studyFile) {
+		cout << "Cannot open: " << studyFile_name << endl;
+		return 1;
+	}
+
+	string line;
+	while(getline(studyFile, line)) {
+		sub_trimLine(line);
+		istringstream fields(line);
+		string name, value;
+		if(!(fields >> name) || name[0] == '#')
+			continue;
+
+		int bad = 0;
+		if(name == "input") {
+			studyInput_struct input;
+			bad = !(fields >> input.line >> input.name >> input.low >> input.high) || input.line < 1 || input.high <= input.low;
+			study.inputs.push_back(input);
+		} else if(name == "climates" || name == "output") {
+			while(fields >> value)
+				(name == "climates" ? study.climates : study.outputs).push_back(value);
+		} else if(!(fields >> value)) {
+			bad = 1;
+		} else if(name == "method") {
+			study.method = value;
+			bad = value != "morris" && value != "sobol";
+		} else if(name == "samples") {
+			study.samples = atoi(value.c_str());
+		} else if(name == "levels") {
+			study.levels = atoi(value.c_str());
+		} else if(name == "seed") {
+			study.seed = (unsigned int) atoi(value.c_str());
+		} else if(name == "building") {
+			study.building = value;
+		} else if(!f_driverSetting(study.settings, name, value, bad)) {
+			bad = 1;
+		}
+
+		if(bad) {
+			cout << "Bad line in " << studyFile_name << ": " << line << endl;
+			return 2;
+		}
+	}
+
+	if(study.inputs.empty() || study.climates.empty() || study.building.empty() || study.samples < 2 || study.levels < 2) {
+		cout << "A study needs a building, climates, inputs, and at least 2 samples and levels: " << studyFile_name << endl;
+		return 2;
+	}
+	if(study.outputs.empty()) {
+		study.outputs.push_back("total_kWh");
+		study.outputs.push_back("meanRelExpReal");
+		study.outputs.push_back("RHexcAnnual60");
+	}
+	return 0;
+}
+
+// The first lines of the .smp file, which say what the samples were drawn for, with the building file's contents
+static string f_sampleHeader(study_struct& study) {
+	ostringstream header;
+	vector<string> buildingFile(1, study.settings.inPath + study.building);
+	header << "method\t" << study.method << "\tsamples\t" << study.samples << "\tlevels\t" << study.levels << "\tseed\t" << study.seed
+		<< "\tbuilding\t" << f_filesHash(buildingFile) << endl;
+	header << "run";
+	for(size_t i = 0; i < study.inputs.size(); i++)
+		header << "\t" << study.inputs[i].line << ":" << study.inputs[i].name << ":" << study.inputs[i].low << ":" << study.inputs[i].high;
+	return header.str();
+}
+
+// Draws the samples in the unit range. Morris: trajectories of inputs + 1 points, each moving one input (in random
+// order) by levels / (2 (levels - 1)). Sobol: for each base sample the rows A, B and then A with input i from B.
+static void sub_drawSamples(study_struct& study, vector<vector<double> >& samples) {
+	size_t k = study.inputs.size();
+	mt19937 random(study.seed);
+	uniform_real_distribution<double> uniform(0, 1);
+
+	if(study.method == "morris") {
+		int p = study.levels;
+		double delta = p / (2.0 * (p - 1));
+		for(int r = 0; r < study.samples; r++) {
+			vector<double> x(k);
+			vector<int> order(k);
+			for(size_t i = 0; i < k; i++) {
+				x[i] = (double) (random() % p) / (p - 1);
+				order[i] = (int) i;
+			}
+			shuffle(order.begin(), order.end(), random);
+			samples.push_back(x);
+			for(size_t s = 0; s < k; s++) {
+				int i = order[s];
+				x[i] = x[i] + delta <= 1 + 1e-12 ? x[i] + delta : x[i] - delta;
+				samples.push_back(x);
+			}
+		}
+		return;
+	}
+
+	for(int j = 0; j < study.samples; j++) {
+		vector<double> a(k), b(k);
+		for(size_t i = 0; i < k; i++)
+			a[i] = uniform(random);
+		for(size_t i = 0; i < k; i++)
+			b[i] = uniform(random);
+		samples.push_back(a);
+		samples.push_back(b);
+		for(size_t i = 0; i < k; i++) {
+			vector<double> ab(a);
+			ab[i] = b[i];
+			samples.push_back(ab);
+		}
+	}
+}
+
+// Reads the samples drawn by an earlier run, or draws them and writes the .smp file. The values are those of the
+// inputs, not the unit range. Returns 1 if the file cannot be written and 2 if it belongs to a different study.
+static int f_samples(study_struct& study, vector<vector<double> >& values) {
+	string sampleFile_name = study.settings.outPath + study.name + ".smp";
+	string header = f_sampleHeader(study);
+	size_t k = study.inputs.size();
+
+	ifstream oldFile(sampleFile_name);
+	if(oldFile) {
+		string line, firstLines;
+		getline(oldFile, line);
+		firstLines = line + "\n";
+		getline(oldFile, line);
+		firstLines = firstLines + line;
+		if(firstLines != header) {
+			cout << "Samples in " << sampleFile_name << " were drawn for a different study; remove it to start again" << endl;
+			return 2;
+		}
+		while(getline(oldFile, line)) {
+			istringstream fields(line);
+			int run;
+			vector<double> row(k);
+			fields >> run;
+			for(size_t i = 0; i < k; i++)
+				fields >> row[i];
+			if(fields)
+				values.push_back(row);
+		}
+		cout << "Samples read from " << sampleFile_name << endl;
+		return 0;
+	}
+
+	vector<vector<double> > samples;
+	sub_drawSamples(study, samples);
+	ofstream sampleFile(sampleFile_name);
+	if(!sampleFile) {
+		cout << "Cannot open: " << sampleFile_name << endl;
+		return 1;
+	}
+	sampleFile << header << endl << setprecision(17);
+	for(size_t r = 0; r < samples.size(); r++) {
+		vector<double> row(k);
+		sampleFile << r;
+		for(size_t i = 0; i < k; i++) {
+			row[i] = study.inputs[i].low + (study.inputs[i].high - study.inputs[i].low) * samples[r][i];
+			sampleFile << "\t" << row[i];
+		}
+		sampleFile << endl;
+		values.push_back(row);
+	}
+	sampleFile.close();
+	return sampleFile.fail() ? 1 : 0;
+}
+
+static string f_runName(study_struct& study, string climate, size_t run) {
+	ostringstream name;
+	name << study.name << "_" << climate << "_" << setw(5) << setfill('0') << run;
+	return name.str();
+}
+
+// Simulates the climate's runs that have no complete .rc2 yet, numThreads at a time. Returns 1 if one cannot be set up.
+static int f_runClimate(study_struct& study, vector<string>& lines, vector<vector<double> >& values, string climate) {
+	string weatherFile_name = f_weatherFile_name(study.settings.weatherPath, climate);
+	vector<string> columns;
+	vector<double> results;
+	vector<size_t> runs;
+	for(size_t r = 0; r < values.size(); r++) {
+		if(!f_readSummary(study.settings.outPath + f_runName(study, climate, r) + ".rc2", columns, results))
+			runs.push_back(r);
+	}
+	cout << "Climate " << climate << ": " << values.size() - runs.size() << " of " << values.size() << " runs already done" << endl;
+	if(runs.empty())
+		return 0;
+
+	vector<weatherSample_struct> weather;
+	double latitude, altitude;
+	if(f_loadWeather(weatherFile_name, study.settings.startDay, weather, latitude, altitude))
+		return 1;
+
+	batch_struct batch;
+	sub_driverBatch(study.settings, batch);
+	vector<int> lineNumbers;
+	for(size_t i = 0; i < study.inputs.size(); i++)
+		lineNumbers.push_back(study.inputs[i].line);
+	sharedShelter_struct shelter;
+
+	return f_runParallel(study.settings.numThreads, runs.size(), [&](size_t n) -> int {
+		string buildingText = f_buildingText(lines, lineNumbers, values[runs[n]]);
+		return f_simulateRun(batch, buildingText, study.building, climate, f_runName(study, climate, runs[n]), weather, latitude, altitude, shelter);
+	}, [&](size_t done) {
+		if(done % 10 == 0 || done == runs.size())
+			cout << "Climate " << climate << ": " << done << "/" << runs.size() << " runs simulated" << endl;
+	});
+}
+
+// Works out the indices of each output in each climate from the .rc2 files. Returns 1 if a run's .rc2 is missing
+// or the report cannot be written.
+static int f_analyse(study_struct& study, vector<vector<double> >& values) {
+	string reportFile_name = study.settings.outPath + study.name + ".sen";
+	ofstream reportFile(reportFile_name);
+	if(!reportFile) {
+		cout << "Cannot open: " << reportFile_name << endl;
+		return 1;
+	}
+	size_t k = study.inputs.size();
+	int morris = study.method == "morris";
+	ostringstream report;
+	report << (morris ? "climate\toutput\tinput\tmu\tmuStar\tsigma" : "climate\toutput\tinput\tS1\tST") << endl;
+
+	for(size_t c = 0; c < study.climates.size(); c++) {
+		// results[o][r] = output o of run r
+		vector<vector<double> > results(study.outputs.size(), vector<double>(values.size()));
+		for(size_t r = 0; r < values.size(); r++) {
+			vector<string> columns;
+			vector<double> rc2;
+			string rc2File_name = study.settings.outPath + f_runName(study, study.climates[c], r) + ".rc2";
+			if(!f_readSummary(rc2File_name, columns, rc2)) {
+				cout << "Cannot open: " << rc2File_name << endl;
+				return 1;
+			}
+			for(size_t o = 0; o < study.outputs.size(); o++) {
+				size_t column = find(columns.begin(), columns.end(), study.outputs[o]) - columns.begin();
+				if(column == columns.size()) {
+					cout << "No column " << study.outputs[o] << " in " << rc2File_name << endl;
+					return 1;
+				}
+				results[o][r] = rc2[column];
+			}
+		}
+
+		for(size_t o = 0; o < study.outputs.size(); o++) {
+			vector<double>& y = results[o];
+			for(size_t i = 0; i < k; i++) {
+				report << study.climates[c] << "\t" << study.outputs[o] << "\t" << study.inputs[i].name;
+				if(morris) {
+					// Elementary effects: the step of each trajectory that moved input i
+					double sum = 0, sumAbs = 0, sumSquares = 0;
+					int count = 0;
+					double range = study.inputs[i].high - study.inputs[i].low;
+					for(size_t r = 0; r + 1 < values.size(); r++) {
+						if((r + 1) % (k + 1) == 0 || values[r + 1][i] == values[r][i])
+							continue;
+						double effect = (y[r + 1] - y[r]) / ((values[r + 1][i] - values[r][i]) / range);
+						sum = sum + effect;
+						sumAbs = sumAbs + fabs(effect);
+						sumSquares = sumSquares + effect * effect;
+						count++;
+					}
+					double mean = count > 0 ? sum / count : 0;
+					double variance = count > 1 ? (sumSquares - count * mean * mean) / (count - 1) : 0;
+					report << "\t" << mean << "\t" << (count > 0 ? sumAbs / count : 0) << "\t" << sqrt(max(variance, 0.0)) << endl;
+				} else {
+					// Rows of base sample j: A at j (k + 2), B after it, then A with input i from B
+					double mean = 0, meanSquares = 0, first = 0, total = 0;
+					for(int j = 0; j < study.samples; j++) {
+						double a = y[j * (k + 2)];
+						double b = y[j * (k + 2) + 1];
+						double ab = y[j * (k + 2) + 2 + i];
+						mean = mean + a + b;
+						meanSquares = meanSquares + a * a + b * b;
+						first = first + b * (ab - a);
+						total = total + (a - ab) * (a - ab);
+					}
+					mean = mean / (2 * study.samples);
+					double variance = meanSquares / (2 * study.samples) - mean * mean;
+					first = first / study.samples;
+					total = total / (2 * study.samples);
+					report << "\t" << (variance > 0 ? first / variance : 0) << "\t" << (variance > 0 ? total / variance : 0) << endl;
+				}
+			}
+		}
+	}
+
+	cout << endl << report.str();
+	reportFile << report.str();
+	reportFile.close();
+	return reportFile.fail() ? 1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+	study_struct study;
+	study.method = "morris";
+	study.samples = 10;
+	study.levels = 4;
+	study.seed = 1;
+	sub_defaultSettings(study.settings);
+
+	int numThreads;
+	string studyFile_name;
+	if(f_driverArguments(argc, argv, studyFile_name, numThreads)) {
+		cout << "Usage: sensitivity [-threads n] study.txt" << endl;
+		return 2;
+	}
+
+	int error = f_readStudy(studyFile_name, study);
+	if(!error)
+		error = f_finishSettings(study.settings, numThreads);
+	if(error)
+		return error;
+	study.name = f_studyName(studyFile_name);
+
+	// The building's lines; those not studied are passed on as they are
+	string buildingFile_name = study.settings.inPath + study.building;
+	vector<string> lines;
+	if(f_readLines(buildingFile_name, lines))
+		return 1;
+	for(size_t i = 0; i < study.inputs.size(); i++) {
+		if(study.inputs[i].line > (int) lines.size()) {
+			cout << "Input " << study.inputs[i].name << " is past the end of " << buildingFile_name << endl;
+			return 2;
+		}
+	}
+
+	vector<vector<double> > values;
+	error = f_samples(study, values);
+	if(error)
+		return error;
+	size_t expected = study.method == "morris" ? study.samples * (study.inputs.size() + 1) : study.samples * (study.inputs.size() + 2);
+	if(values.size() != expected) {
+		cout << "The samples file of " << study.name << " is incomplete; remove it to start again" << endl;
+		return 2;
+	}
+
+	for(size_t c = 0; c < study.climates.size(); c++) {
+		if(f_runClimate(study, lines, values, study.climates[c]))
+			return 1;
+	}
+	return f_analyse(study, values);
+}
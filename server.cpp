@@ -0,0 +1,417 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+#include "driver.h"
+#include "simulation.h"
+#include "weather.h"
+
+using namespace std;
+
+// Stepping server for testing controllers against the simulated house (hardware in the loop). One client
+// connects to a local socket; the house is then stepped a minute at a time, either paced at a fixed acceleration
+// or each time the client asks, and after every minute the server sends a line of sensor readings:
+//
+//	minute day hour tempHouse RHhouse HRhouse Pint AHflag rivecOn
+//
+// (K, %, kg/kg, Pa). The client sends commands, one per line, at any time; they apply from the next minute:
+//
+//	rivec 1|0|-1		RIVEC fan on, off, or back to the RIVEC controller
+//	ah 1|0|-1			Air handler on (heating or cooling as the season has it), off, or back to the thermostat
+//	step				Step the next minute (only with -x 0)
+//	quit
+//
+// Each minute is timed from its deadline (or from the step command) until its line has been sent, which includes
+// any lateness in waking up; the distribution is printed at the end. The weather is read before the client is
+// accepted and nothing is allocated once stepping starts, so the time goes on the simulation and the socket.
+//
+// Usage: server [-x factor] [-port n] [-unix path] [-days n] [-shelter file] [-schedules prefix] [-schednum letter] [-latency file] building.csv weather.ws3
+//   -x			simulated time per wall-clock time (default 60, a minute a second; 0 = step on the client's "step")
+//   -port		TCP port on 127.0.0.1 (default 5150)
+//   -unix		listen on a Unix domain socket instead (not on Windows)
+//   -schedules	dynamic fan schedule files up to the 1, 2 or 3 (default C:\RC++\schedules\sched), -schednum their suffix (s)
+//   -latency	also write the latency histogram to this file
+
+#ifdef _WIN32
+typedef SOCKET socket_type;
+#define closeSocket closesocket
+#else
+typedef int socket_type;
+#define closeSocket close
+#define INVALID_SOCKET (-1)
+#endif
+
+const int LATENCY_BINS = 96;		// Four to an octave from 1 us, so up to about 16 s
+const int SPIN_US = 500;			// A paced minute waits in select() until this long before its deadline, then spins
+
+// Step latencies in microseconds
+struct latencyHistogram_struct {
+	void init();
+	void add(double us);
+	double f_quantile(double p);
+	void write(ostream& out, double period);
+
+	long long bins[LATENCY_BINS];
+	long long count;
+	long long missed;			// Paced minutes whose line went out after the next minute's deadline
+	double sum;
+	double max;
+};
+
+void latencyHistogram_struct::init() {
+	for(int i = 0; i < LATENCY_BINS; i++)
+		bins[i] = 0;
+	count = 0;
+	missed = 0;
+	sum = 0;
+	max = 0;
+}
+
+void latencyHistogram_struct::add(double us) {
+	int bin = (int) (4 * log(1 + us) / log(2.0));
+	bins[bin < LATENCY_BINS ? bin : LATENCY_BINS - 1]++;
+	count++;
+	sum = sum + us;
+	if(us > max)
+		max = us;
+}
+
+// Top of the bin that holds the p quantile
+double latencyHistogram_struct::f_quantile(double p) {
+	long long seen = 0;
+	for(int i = 0; i < LATENCY_BINS; i++) {
+		seen = seen + bins[i];
+		if(seen >= p * count)
+			return pow(2.0, (i + 1) / 4.0) - 1 < max ? pow(2.0, (i + 1) / 4.0) - 1 : max;
+	}
+	return max;
+}
+
+void latencyHistogram_struct::write(ostream& out, double period) {
+	out << "Minutes\t" << count << endl;
+	if(count == 0)
+		return;
+	out << "Mean us\t" << sum / count << endl;
+	out << "p50 us\t" << f_quantile(0.5) << endl;
+	out << "p90 us\t" << f_quantile(0.9) << endl;
+	out << "p99 us\t" << f_quantile(0.99) << endl;
+	out << "p99.9 us\t" << f_quantile(0.999) << endl;
+	out << "Max us\t" << max << endl;
+	if(period > 0)
+		out << "Missed deadlines\t" << missed << "\t(period " << period << " us)" << endl;
+	out << "Bin from us\tMinutes" << endl;
+	for(int i = 0; i < LATENCY_BINS; i++) {
+		if(bins[i] > 0)
+			out << pow(2.0, i / 4.0) - 1 << "\t" << bins[i] << endl;
+	}
+}
+
+// Commands that have come in but not yet been applied, and what is left of a partly received line
+struct commands_struct {
+	char line[256];
+	int length;
+	int rivec;
+	int AH;
+	int steps;
+	int quit;
+};
+
+// Applies each complete line in the received text
+static void sub_parseCommands(commands_struct& commands, const char* text, int bytes) {
+	for(int i = 0; i < bytes; i++) {
+		if(text[i] != '\n' && text[i] != '\r') {
+			if(commands.length < (int) sizeof(commands.line) - 1)
+				commands.line[commands.length++] = text[i];
+			continue;
+		}
+		commands.line[commands.length] = 0;
+		commands.length = 0;
+
+		char* value = strchr(commands.line, ' ');
+		int setting = value ? atoi(value + 1) : 0;
+		setting = setting < 0 ? -1 : (setting > 0 ? 1 : 0);
+
+		if(strncmp(commands.line, "rivec ", 6) == 0)
+			commands.rivec = setting;
+		else if(strncmp(commands.line, "ah ", 3) == 0)
+			commands.AH = setting;
+		else if(strcmp(commands.line, "step") == 0)
+			commands.steps++;
+		else if(strcmp(commands.line, "quit") == 0)
+			commands.quit = 1;
+	}
+}
+
+// Waits until the deadline (or forever if wait is set, until a command comes in), applying commands as they
+// arrive. Returns 1 if the client has gone.
+static int f_receive(socket_type client, commands_struct& commands, chrono::steady_clock::time_point deadline, int wait) {
+	char text[256];
+	while(true) {
+		if(wait && (commands.steps > 0 || commands.quit))
+			return 0;
+
+		long long us = 0;
+		if(!wait) {
+			us = chrono::duration_cast<chrono::microseconds>(deadline - chrono::steady_clock::now()).count();
+			if(us < 0)
+				us = 0;
+		}
+
+		fd_set readable;
+		FD_ZERO(&readable);
+		FD_SET(client, &readable);
+		timeval timeout;
+		timeout.tv_sec = (long) (us / 1000000);
+		timeout.tv_usec = (long) (us % 1000000);
+
+		int ready = select((int) client + 1, &readable, 0, 0, wait ? 0 : &timeout);
+		if(ready < 0)
+			return 1;
+		if(ready == 0)
+			return 0;				// Deadline reached
+
+		int bytes = recv(client, text, sizeof(text), 0);
+		if(bytes <= 0)
+			return 1;
+		sub_parseCommands(commands, text, bytes);
+		if(!wait && us == 0)
+			return 0;
+	}
+}
+
+static int f_sendAll(socket_type client, const char* text, int bytes) {
+	while(bytes > 0) {
+		int sent = send(client, text, bytes, 0);
+		if(sent <= 0)
+			return 1;
+		text = text + sent;
+		bytes = bytes - sent;
+	}
+	return 0;
+}
+
+// Listens on the TCP port (or the Unix socket) and accepts one client. Returns INVALID_SOCKET on failure.
+static socket_type f_accept(int port, string unixPath) {
+	socket_type listener;
+#ifndef _WIN32
+	if(!unixPath.empty()) {
+		listener = socket(AF_UNIX, SOCK_STREAM, 0);
+		sockaddr_un address;
+		memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		strncpy(address.sun_path, unixPath.c_str(), sizeof(address.sun_path) - 1);
+		unlink(unixPath.c_str());
+		if(listener == INVALID_SOCKET || bind(listener, (sockaddr*) &address, sizeof(address)) != 0 || listen(listener, 1) != 0)
+			return INVALID_SOCKET;
+		cout << "Waiting for a client on " << unixPath << endl;
+	} else
+#endif
+	{
+		listener = socket(AF_INET, SOCK_STREAM, 0);
+		int reuse = 1;
+		setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*) &reuse, sizeof(reuse));
+		sockaddr_in address;
+		memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_port = htons((unsigned short) port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		if(listener == INVALID_SOCKET || bind(listener, (sockaddr*) &address, sizeof(address)) != 0 || listen(listener, 1) != 0)
+			return INVALID_SOCKET;
+		cout << "Waiting for a client on 127.0.0.1:" << port << endl;
+	}
+
+	socket_type client = accept(listener, 0, 0);
+	closeSocket(listener);
+	if(client != INVALID_SOCKET && unixPath.empty()) {
+		int noDelay = 1;			// Each line goes out as soon as it is written
+		setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char*) &noDelay, sizeof(noDelay));
+	}
+	return client;
+}
+
+int main(int argc, char* argv[])
+{
+	driverSettings_struct defaults;										// Shared with rc++ (sub_defaultSettings in driver.cpp)
+	sub_defaultSettings(defaults);
+
+	string shelterFile_name = defaults.shelterFile_name;				// Location of shelter file
+	string schedulePrefix = defaults.schedulePath + "sched";			// Dynamic fan schedule files, followed by 1, 2 or 3 and SCHEDNUM
+	string SCHEDNUM = "s";
+	string latencyFile_name;
+	string unixPath;
+	double factor = 60;
+	int port = 5150;
+	int totaldays = defaults.totaldays;
+	vector<string> files;
+
+	for(int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if(arg == "-x" && i + 1 < argc)
+			factor = atof(argv[++i]);
+		else if(arg == "-port" && i + 1 < argc)
+			port = atoi(argv[++i]);
+		else if(arg == "-unix" && i + 1 < argc)
+			unixPath = argv[++i];
+		else if(arg == "-days" && i + 1 < argc)
+			totaldays = atoi(argv[++i]);
+		else if(arg == "-shelter" && i + 1 < argc)
+			shelterFile_name = argv[++i];
+		else if(arg == "-schedules" && i + 1 < argc)
+			schedulePrefix = argv[++i];
+		else if(arg == "-schednum" && i + 1 < argc)
+			SCHEDNUM = argv[++i];
+		else if(arg == "-latency" && i + 1 < argc)
+			latencyFile_name = argv[++i];
+		else
+			files.push_back(arg);
+	}
+
+	if(files.size() != 2 || factor < 0) {
+		cout << "Usage: server [-x factor] [-port n] [-unix path] [-days n] [-shelter file] [-schedules prefix] [-schednum letter] [-latency file] building.csv weather.ws3" << endl;
+		return 2;
+	}
+
+	// [START] Inputs ===================================================================================================
+	ifstream buildingFile(files[0]);
+	if(!buildingFile) {
+		cout << "Cannot open: " << files[0] << endl;
+		return 1;
+	}
+	ostringstream building;
+	building << buildingFile.rdbuf();
+	buildingFile.close();
+
+	weatherFile_struct weatherFile;
+	double latitude, altitude;
+	if(sub_openWeather(weatherFile, files[1], latitude, altitude)) {
+		cout << "Cannot open: " << files[1] << endl;
+		return 1;
+	}
+
+	vector<weatherSample_struct> weather;
+	weatherSample_struct sample;
+	while(f_readWeather(weatherFile, sample))
+		weather.push_back(sample);
+	weatherFile.close();
+
+	batch_struct batch;
+	batch.shelterFile_name = shelterFile_name;
+	batch.fanSchedulefile_name1 = schedulePrefix + "1" + SCHEDNUM;
+	batch.fanSchedulefile_name2 = schedulePrefix + "2" + SCHEDNUM;
+	batch.fanSchedulefile_name3 = schedulePrefix + "3" + SCHEDNUM;
+	batch.totaldays = totaldays;
+	batch.startDay = 1;
+	batch.spinupDays = 0;
+	batch.convergenceFlag = 0;
+	batch.convergenceWorst = 0;
+	batch.minuteOutputFlag = 0;
+	batch.compressionLevel = 0;
+	batch.scheduleSeed = 0;
+
+	string input_file = files[0];
+	string weather_file = files[1];
+	string output_file = "server";
+
+	simulation_struct* house = new simulation_struct();
+	house->buildingText = building.str();
+	if(house->init(batch, input_file, weather_file, output_file, latitude, altitude)) {
+		delete house;
+		return 1;
+	}
+	// [END] Inputs =====================================================================================================
+
+#ifdef _WIN32
+	WSADATA wsaData;
+	WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+
+	socket_type client = f_accept(port, unixPath);
+	if(client == INVALID_SOCKET) {
+		cout << "Cannot listen or accept a client" << endl;
+		delete house;
+		return 1;
+	}
+
+	commands_struct commands;
+	commands.length = 0;
+	commands.rivec = -1;
+	commands.AH = -1;
+	commands.steps = 0;
+	commands.quit = 0;
+
+	latencyHistogram_struct latency;
+	latency.init();
+
+	char line[256];
+	long long periodUs = factor > 0 ? (long long) (60e6 / factor) : 0;
+	chrono::microseconds period(periodUs);
+	chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + period;
+	int gone = 0;
+
+	// [START] Stepping =================================================================================================
+	for(size_t m = 0; m < weather.size() && !gone && !commands.quit; m++) {
+		gone = f_receive(client, commands, deadline - chrono::microseconds(SPIN_US), factor == 0);
+		if(gone || commands.quit)
+			break;
+		while(factor > 0 && chrono::steady_clock::now() < deadline) {
+		}
+
+		chrono::steady_clock::time_point start = factor > 0 ? deadline : chrono::steady_clock::now();
+		if(factor == 0)
+			commands.steps--;
+
+		house->rivecOverride = commands.rivec;
+		house->AHoverride = commands.AH;
+		int more = house->step(weather[m]);
+
+		int bytes = sprintf(line, "%ld %d %d %.6g %.6g %.6g %.6g %d %d\n", house->MINUTE - 1, weather[m].day, house->HOUR,
+			house->tempHouse, house->RHhouse, house->HR[3], house->Pint, house->AHflag, house->rivecOn);
+		gone = f_sendAll(client, line, bytes);
+
+		chrono::steady_clock::time_point end = chrono::steady_clock::now();
+		latency.add((double) chrono::duration_cast<chrono::microseconds>(end - start).count());
+		if(factor > 0 && end > deadline + period)
+			latency.missed++;
+
+		deadline = deadline + period;
+		if(!more)
+			break;
+	}
+	// [END] Stepping ===================================================================================================
+
+	closeSocket(client);
+#ifdef _WIN32
+	WSACleanup();
+#endif
+	delete house;
+
+	cout << "Step latency, from each minute's deadline (or step command) to its line being sent" << endl;
+	latency.write(cout, (double) periodUs);
+	if(!latencyFile_name.empty()) {
+		ofstream latencyFile(latencyFile_name);
+		if(!latencyFile) {
+			cout << "Cannot open: " << latencyFile_name << endl;
+			return 1;
+		}
+		latency.write(latencyFile, (double) periodUs);
+	}
+	return 0;
+}
@@ -0,0 +1,456 @@
+#pragma once
+#ifndef simulation_h
+#define simulation_h
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "functions.h"
+#include "capture.h"
+#include "convergence.h"
+#include "profiler.h"
+#include "schedule.h"
+#include "statistics.h"
+#include "weather.h"
+#include "writer.h"
+
+using namespace std;
+
+// Batch-wide file locations and run length, set once in main and shared by every simulation in the batch
+struct batch_struct {
+	string inPath;
+	string outPath;
+	string weatherPath;
+	string shelterFile_name;
+	string fanSchedulefile_name1;
+	string fanSchedulefile_name2;
+	string fanSchedulefile_name3;
+	int totaldays;				// Last day of the year simulated
+	int startDay;				// First day simulated (1 = January 1st); the weather handed to step() starts on it
+	int spinupDays;				// Most repeats of the first day run by spinUp() before it (0 = none)
+	int convergenceFlag;		// 1 = write a .cnv convergence report for each simulation
+	int convergenceWorst;		// Number of slowest minutes listed in the .cnv report
+	int minuteOutputFlag;		// 1 = write the per-minute files (.rco, .hum, .fil)
+	int compressionLevel;		// 0 = plain text per-minute and output files, 1-9 = gzip (see writer.h)
+	unsigned long long scheduleSeed;	// 0 = read the dynamic fan schedule files, otherwise generate them (see schedule.h)
+	vector<statisticSpec_struct> statistics;	// Streaming statistics for the .rcs summary (empty = no .rcs)
+	vector<outputSpec_struct> outputs;			// Extra output files with chosen columns and resolution
+	vector<weatherTransform_struct> weatherTransforms;	// Asked for by a climate as climate@name (see weather.h)
+};
+
+// Wind shelter coefficient of each wall for every degree of wind direction, read from the shelter file. It is
+// never changed after init(), so copies of a simulation share one table.
+struct shelterTable_struct {
+	double Sw[4][361];
+};
+
+// Envelope and duct inputs fitted by calibration (calibrate.cpp). Set before init() to replace the building's
+// values; zero leaves the value from the building inputs.
+struct calibration_struct {
+	double C;				// Envelope Leakage Coefficient [m3/sPa^n]
+	double n;				// Envelope Pressure Exponent
+	double UAh;				// Heating U-Value [W/K]
+	double UAc;				// Cooling U-Value [W/K]
+	double supLF;			// Supply duct leakage fraction
+	double retLF;			// Return duct leakage fraction
+	double massFactor;		// Multiplies the internal mass of the house (walls and slab, see sub_heat); 1 after init()
+};
+
+// Fan schedule input. A copy reopens the file at the same place, so that a copied simulation reads on from there.
+struct scheduleStream_struct : public ifstream {
+	scheduleStream_struct();
+	scheduleStream_struct(const scheduleStream_struct& other);
+	void open(string fileName);
+
+	string fileName;
+};
+
+// Change from one repeat of the first day to the next below which spinUp() stops
+const double SPINUP_TEMP = 0.05;		// Node temperatures [K]
+const double SPINUP_HR = 0.00001;		// Humidity ratios [kg/kg]
+
+// One house being simulated. init() reads the building inputs and opens the output files, step() advances
+// the house by one minute using a weather sample supplied by the caller (so that several houses can share
+// one weather stream) and finish() closes the minute files and writes the annual summary (.rc2)
+// and, when convergenceFlag is set, the solver convergence report (.cnv), and the streaming statistics (.rcs).
+// init() and finish() return 1 if a file cannot be opened. step() returns 0 once totaldays have been simulated.
+// Allocate with new simulation_struct() so that every state variable starts at zero. The building that the airflow,
+// heat and moisture routines read is its building_struct, only set by init(), and what they change every minute its
+// houseState_struct (see functions.h); step() hands both to them with the minute's weather. step() is stepPrepare()
+// (everything up to the airflow and heat balance), stepTransport() (the balance, iterated until the ceiling flow and
+// the attic air temperature settle, see f_ceilingDone() and f_heatDone()) and stepComplete() (the rest, which returns
+// step()'s result); sub_stepLanes() calls them itself to run the balance of several houses together.
+// f_fork() returns a copy at the current minute that steps on its own but has no output files open.
+// f_branch() is a lighter copy for what-if runs (see branch.h): it also leaves the statistics and output files behind.
+// spinUp() is called after init() with the first day's weather to replace the fixed initial temperatures and
+// humidity ratios with those of a periodic steady state: the day is repeated on a branch until the node
+// temperatures and humidity ratios at its end change by less than SPINUP_TEMP and SPINUP_HR from one repeat to the
+// next, or spinupDays repeats have run. It returns the repeats run (0 when spinupDays is 0).
+// Embedding code (see regcap.h) can set buildingText and shelter before init() to give the building inputs and the
+// shelter table in memory instead of the .csv and shelter files, and calibration to change some of the inputs.
+struct simulation_struct : public building_struct, public houseState_struct {
+	int init(batch_struct& batch, string& input_file, string& weather_file, string& output_file, double weatherLatitude, double weatherAltitude);
+	int step(const weatherSample_struct& weather);
+	void stepPrepare(const weatherSample_struct& weather);
+	void stepTransport();
+	int f_ceilingDone(solver_struct& leakSolver);
+	int f_heatDone(solver_struct& heatSolver);
+	int stepComplete();
+	int finish();
+	simulation_struct* f_fork();
+	simulation_struct* f_branch();
+	int spinUp(vector<weatherSample_struct>& firstDay);
+	vector<outputStream_struct*> f_streams();
+
+	string input_file;
+	string buildingText;		// Building inputs in the .csv layout; read instead of the .csv file if set (cleared by init())
+	calibration_struct calibration;
+	string weather_file;
+	weatherTransform_struct weatherTransform;
+	int weatherTransformFlag;	// 1 = weather_file names a transform applied to every weather sample
+	weatherSample_struct sample;	// This minute's weather sample, transformed, as the airflow and heat routines read it
+	string output_file;
+	string outPath;
+	int totaldays;				// Days simulated, from startDay
+	int startDay;
+	int spinupDays;
+	int spunUpDays;				// Repeats run by spinUp(); 0 = the first minute sets the fixed initial humidity
+
+
+	int convergenceFlag;
+	convergence_struct convergence;	// Solver iteration counts and residuals
+
+	int minuteOutputFlag;
+	int compressionLevel;
+	statistics_struct statistics;	// Distributions of output variables, written to the .rcs file
+	vector<double> output;			// This minute's output variables by handle, filled when there are statistics or output files
+	int outputVariablesFlag;		// 1 = fill output every minute even without statistics or output files
+	vector<outputWriter_struct*> outputs;	// One per outputSpec_struct in the batch
+
+#ifdef REGCAP_PROFILE
+	profile_struct profile;
+#endif
+#ifdef REGCAP_CAPTURE
+	capture_struct capture;
+#endif
+
+	shared_ptr<shelterTable_struct> shelter;
+	double mechVentPower;
+	double heatThermostat[24];
+	double coolThermostat[24];
+	long int MINUTE;
+	int endrunon;
+	int prerunon;
+	double Mcoil;
+	double SHR;
+	double meanOutsideTemp;
+	double meanAtticTemp;
+	double meanHouseTemp;
+	double meanHouseACH;
+	double meanFlueACH;
+	double gasTherm;
+	double AH_kWh;
+	double compressor_kWh;
+	double mechVent_kWh;
+	double furnace_kWh;
+	double C1; //Coefficients for saturation vapor pressure over liquid water -100 to 0C. ASHRAE HoF.
+	double C2;
+	double C3;
+	double C4;
+	double C5;
+	double C6;
+	double C7;
+	double C8; //Coefficients for saturation vapor pressure over liquid water 0 to 200C. ASHRAE HoF.
+	double C9;
+	double C10;
+	double C11;
+	double C12;
+	double C13;
+	double SatVaporPressure; //Saturation vapor pressure, pa
+	double HRsaturation; //humidity ratio at saturation
+	double RHhouse; //house relative humidity
+	double RHind60; //index value (0 or 1) if RHhouse > 60
+	double RHtot60; //cumulative sum of index value (0 or 1) if RHhouse > 60
+	double RHexcAnnual60; //annual fraction of the year where RHhouse > 60
+	double RHind70; //index value (0 or 1) if RHhouse > 70
+	double RHtot70; //cumulative sum of index value (0 or 1) if RHhouse > 70
+	double RHexcAnnual70; //annual fraction of the year where RHhouse > 70
+	double pi;
+	double hret;				// Initial number for hret in Btu/lb
+	outputStream_struct moistureFile;
+	double lc;		// Percentage of leakage in the ceiling
+	double lf;		// Percentage of leakage in the floor
+	double lw;		// Percentage of leakage in the walls
+	double houseLength;		// Long side of house (m) NOT USED IN CODE
+	double houseWidth;		// Short side of house (m) NOT USED IN CODE
+	double UAh;				// Heating U-Value (Thermal Conductance)
+	double UAc;				// Cooling U-Value (Thermal Conductance)
+	double ceilRval_heat;
+	double ceilRval_cool;
+	double internalGains1;
+	double supLF0;						//Supply duct leakage fraction (e.g., 0.01 = 1% leakage).
+	double retLF0;						//Return duct leakage fraction (e.g., 0.01 = 1% leakage)
+	double qAH_cool0;				// Cooling Air Handler air flow (m^3/s)
+	double qAH_heat0;				// Heating Air Handler air flow (m^3/s)
+	double buried;
+	double capacityraw;
+	double capacityari;
+	double EERari;
+	double hcapacity;		// Heating capacity [kBtu/h]
+	double fanPower_heating0;		// Heating fan power [W]
+	double fanPower_cooling0;		// Cooling fan power [W]
+	double charge;
+	double AFUE;			// Annual Fuel Utilization Efficiency for the furnace
+	int bathroomSchedule;	// Bathroom schedule file to use (1, 2 or 3)
+	int numBedrooms;		// Number of bedrooms (for 62.2 target ventilation calculation)
+	double weatherFactor;	// Weather Factor (w) (for infiltration calculation from ASHRAE 136)
+	double rivecFlagInd;	// Indicator variable that instructs a fan code 13 or 17 to be run by RIVEC controls. 1= yes, 0=no. Brennan.
+	double HumContType;	// Type of humidity control to be used in the RIVEC calculations. 1,2,...n Brennan.
+	double wCutoff;	// Humidity Ratio cut-off calculated as some percentile value for the climate zone. Brennan.
+	double wDiffMaxNeg;	// Maximum average indoor-outdoor humidity differene, when wIn < wOut. Climate zone average.
+	double wDiffMaxPos;	// Maximum average indoor-outdoor humidity differene, when wIn > wOut. Climate zone average.
+	double W25_1;
+	double W25_2;
+	double W25_3;
+	double W25_4;
+	double W25_5;
+	double W25_6;
+	double W25_7;
+	double W25_8;
+	double W25_9;
+	double W25_10;
+	double W25_11;
+	double W25_12;
+	double W75_1;
+	double W75_2;
+	double W75_3;
+	double W75_4;
+	double W75_5;
+	double W75_6;
+	double W75_7;
+	double W75_8;
+	double W75_9;
+	double W75_10;
+	double W75_11;
+	double W75_12;
+	int filterLoadingFlag;		// Filter loading flag = 0 (OFF) or 1 (ON)
+	int MERV;					// MERV rating of filter (may currently be set to 5, 8, 11 or 16)
+	int loadingRate;			// loading rate of filter, f (0,1,2) = (low,med,high)
+	int BPMflag;				// BPM (1) or PSC (0) air handler motor
+	int filterChanges;			// Number of filters used throughout the year
+	double qAH_low;				// Lowest speed of AH (set in sub_filterLoading)
+	double qAH_heat;
+	double qAH_cool;
+	double fanPower_heating;
+	double fanPower_cooling;
+	double retLF;
+	double supLF;
+	double massFilter_cumulative;	// Cumulative mass that has flown through the filter
+	double massAH_cumulative;		// Cumulative mass that has flown through the AH
+	double A_qAH_heat;			// Initial AH airflow change (in heating mode) from installing filter [%]
+	double A_qAH_cool;			// Initial AH airflow change (in cooling mode) from installing filter [%]
+	double A_wAH_heat;			// Initial AH power change (in heating mode) from installing filter [%]
+	double A_wAH_cool;			// Initial AH power change (in cooling mode) from installing filter [%]
+	double A_DL;				// Intial return duct leakage change from installing filter [%]
+	double k_qAH;				// Gradual change in AH airflow from filter loading [% per 10^6kg of air mass through filter]
+	double k_wAH;				// Gradual change in AH power from filter loading [% per 10^6kg of air mass through filter]
+	double k_DL;				// Gradual change in return duct leakage from filter loading [% per 10^6kg of air mass through filter]
+	outputStream_struct filterFile;
+	double qAH_cfm;
+	double qAHcorr;
+	int dynamicScheduleFlag;	// 1 = use dynamic fan schedules, 0 = do not use dynamic fan schedules
+	int peakFlag;				// Peak flag (0 or 1) prevents two periods during same day
+	int rivecFlag;				// Dose controlled ventilation (RIVEC) flag 0 = off, 1 = use rivec (mainly for HRV/ERV control)
+	double qRivec;			// Airflow rate of RIVEC fan for max allowed dose and exposure [L/s]
+	int numFluesActual;	// numFluesActual used to remember the number of flues for when RIVEC blocks them off as part of a hybrid ventilation strategy
+	int economizerUsed;			// 1 = use economizer and change C (house leakage) for pressure relief while economizer is running (changes automatically)
+	double Coriginal;			// House leakage before pressure relief opens for economizer
+	double ELAeconomizer;		// Size of leakage increase for economizer pressure relief
+	double Ceconomizer;			// Total leakage of house inncluding extra economizer pressure relief (only while economizer is running)
+	double angle;
+	double layerThickness;		// Atmospheric boundary layer thickness [m]
+	int terrain;	// 1 = large city centres, 2 = urban and suburban, 3 = open terrain, 4 = open sea
+	double metExponent;		// Power law exponent of the wind speed profile at the met station
+	double metThickness;		// Atmospheric boundary layer thickness at met station [m]
+	double metHeight;			// Height of met station wind measurements [m]
+	double windSpeedCorrection;
+	double AL5;
+	outputStream_struct outputFile;
+	double latitude, altitude;
+	int set;
+	int AHflagPrev;
+	int econoFlag;		// Economizer Flag (0/1 = OFF/ON)
+	double tempReturn;
+	double tempSupply;
+	int minute_day;				// Minute number in the current day (1 to 1440)
+	int minute_hour;			// Minute number in the current hour (1 to 60)
+	int baseStart;
+	int baseEnd;
+	int peakStart;
+	int peakEnd;
+	int recoveryStart;
+	int recoveryEnd;
+	double ELA;			// Effective Leakage Area
+	double NL;				// Normalized Leakage Calculation. Iain! Brennan! this does not match 62.2-2013 0.4 exponent assumption.
+	double wInfil;										// Infiltration credit from updated ASHRAE 136 weather factors [ACH]
+	double defaultInfil;	// Default infiltration credit [ACH] (ASHRAE 62.2, 4.1.3 p.4). This NO LONGER exists in 62.2-2013
+	double rivecX;
+	double rivecY;
+	int AeqCalcs; //Brennan. ALWAYS use option 1 (or 4 for existing home with flow deficit), to do 62.2-2013 Aeq calculation. Options 2 and 3 are for 62.2-2010.
+	double expLimit;	// Exposure limit for RIVEC algorithm. This is the Max Sherman way of calculating the maximum limit.
+	long int rivecMinutes;					// Counts how many minutes of the year that RIVEC is on
+	double relDose;							// Initial value for relative dose used in the RIVEC algorithm
+	double relExp;							// Initial value for relative exposure used in the RIVEC algorithm
+	double turnover;					// Initial value for turnover time (hrs) used in the RIVEC algorithm. Turnover is calculated the same for occupied and unoccupied minutes.
+	double rivecdt;				// Rivec timestep is in hours, dtau is simulation timestep in seconds. Used in calculation of relative dose and exposure.
+	double relDoseReal;						// Initial value for relative dose using ACH of house, i.e. the real rel dose not based on ventSum
+	double relExpReal;						// Initial value for relative exposure using ACH of house i.e. the real rel exposure not based on ventSum
+	double turnoverReal;				// Initial value for real turnover using ACH of house
+	long int occupiedMinCount;				// Counts the number of minutes in a year that the house is occupied
+	double occupiedDose;		// Relative dose only while occupants are present in the house. IF always occupied, this is equal to relDose
+	double occupiedExp;			// Relative exposure only while occupants are present in the house. IF always occupied, this is equal to relExp
+	double occupiedDoseReal;	// "Real" relative dose only while occupants are present in the house, based an ACH predicted by mass balance. IF always occupied, this is equal to relDoseReal
+	double occupiedExpReal;		// "Real" relative exposure only while occupants are present in the house, based an ACH predicted by mass balance. IF always occupied, this is equal to relExpReal
+	double meanRelExp;						// Mean relative exposure over the year, used as a cumulative sum and then ultimately annual average value
+	double meanRelDose;						// Mean relative dose over the year, used as a cumulative sum and then ultimately annual average value
+	double meanRelExpReal;					//Mean "real" relative exposure over the year, used as a cumulative sum and then ultimately annual average value
+	double meanRelDoseReal;					//Mean "real" relative dose over the year, used as a cumulative sum and then ultimately annual average value
+	double totalOccupiedExpReal;			//Cumulative sum
+	double meanOccupiedExpReal;				//Annual average
+	double totalOccupiedDoseReal;			// Cumulative sum for "real" calculations. total dose and exp over the occupied time period
+	double meanOccupiedDoseReal;			// Mean for "real" calculations. total dose and exp over the occupied time period
+	double totalOccupiedExp;				//Cumulative sum for OccupiedExp
+	double meanOccupiedExp;					// Mean occupied relative exposure over the year
+	double totalOccupiedDose;				//Cumulative sum for OccupiedDose
+	double meanOccupiedDose;				// Mean occupied relative dose over the year
+	double turnoverRealOld;
+	double relDoseRealOld;
+	double relExpTarget;		//This is a relative expsoure value target used for humidity control simulations. It varies between 0 and 2.5, depending on magnitude of indoor-outdoor humidity ratio difference.
+	string fanSchedule;
+	scheduleStream_struct fanschedulefile;
+	fanSchedule_struct generatedSchedule;
+	int generatedScheduleFlag;	// 1 = dynamic fan schedules from generatedSchedule rather than fanschedulefile
+	int AHminutes;
+	int target;
+	int day;
+	int idirect;
+	int solth;
+	int dryerFan;		// Dynamic schedule flag for dryer fan (0 or 1)
+	int kitchenFan;		// Dynamic schedule flag for kitchen fan (0 or 1)
+	int bathOneFan;		// Dynamic schedule flag for first bathroom fan (0 or 1)
+	int bathTwoFan;		// Dynamic schedule flag for second bathroom fan (0 or 1)
+	int bathThreeFan;	// Dynamic schedule flag for third bathroom fan (0 or 1)
+	int HOUR;				// Hour of the day
+	int weekendFlag;
+	int occupied[24];	// Used for setting which hours of the day the house is occupied (1) or vacant (0)
+	int compTime;
+	int compTimeCount;
+	int rivecOn;		// 0 (off) or 1 (on) for RIVEC devices
+	int rivecOverride;	// -1 = RIVEC decides, 0 or 1 = rivecOn forced by the caller (what-if branches)
+	int AHoverride;		// -1 = thermostat decides, 0 = air handler off, 1 = on in the season's mode (external controllers)
+	int mainIterations;
+	int economizerRan;	// 0 or else 1 if economizer has run that day
+	int hcFlag;
+	int FirstCut; //Monthly Indexes assigned based on climate zone
+	int SecondCut; //Monthly Indexes assigned based on climate zone
+	double weatherTemp;			// Outdoor air temperature read in from weather file [C]. Brennan.
+	double HROUT;				// Outdoor humidity ratio read in from weather file [kg/kg]
+	double direction;			// Wind direction read in from weather file
+	double hcap;				// Heating capacity of furnace (or gas burned by furnace)
+	double fanHeat;
+	double ventSumIN;			// Sum of all ventilation flows into house
+	double ventSumOUT;			// Sum of all ventilation flows out from house
+	double turnoverOld;			// Turnover from the pervious time step
+	double relDoseOld;			// Relative Dose from the previous time step
+	double nonRivecVentSumIN;	// Ventilation flows into house not including the RIVEC device flow
+	double nonRivecVentSumOUT;	// Ventilation flows out from house not including the RIVEC device flow
+	double nonRivecVentSum;		// Equals the larger of nonRivecVentSumIN or nonRivecVentSumOUT
+	double qAH;					// Air flowrate of the Air Handler (m^3/s)
+	double econodt;			// Temperature difference between inside and outside at which the economizer operates
+	double supVelAH;			// Air velocity in the supply ducts
+	double retVelAH;			// Air velocity in the return ducts
+	double qSupReg;				// Airflow rate in the supply registers
+	double qRetReg;				// Airflow rate in the return registers
+	double qRetLeak;			// Leakage airflow rate in the return ducts
+	double qSupLeak;			// Leakage airflow rate in the supply ducts
+	double mSupLeak1;
+	double mRetLeak1;
+	double mSupReg1;
+	double mRetReg1;
+	double mAH1;
+	double AHfanPower;
+	double AHfanHeat;
+	double capacity;
+	double powercon;
+	double compressorPower;
+	double Toutf;
+	double tretf;
+	double dhret;
+	double chargecapd;
+	double chargeeerd;
+	double EER;
+	double chargecapw;
+	double chargeeerw;
+	double Mcoilprevious;
+	double mCeilingOld;
+	double limit;
+	double mCeilingIN; //Ceiling mass flows, not including register flows. Brennan added for ventilation load calculations.
+	double tempCeiling;
+	double tempAtticFloor;
+	double tempInnerSheathS;
+	double tempOuterSheathS;
+	double tempInnerSheathN;
+	double tempOuterSheathN;
+	double tempInnerGable;
+	double tempOuterGable;
+	double tempWood;
+	double tempRetSurface;
+	double tempSupSurface;
+	double tempHouseMass;
+	double w;
+	double mHouse;
+	double qHouse;
+	double houseACH;
+	double flueACH;
+	double ventSum;
+	double Dhda; //Dry-air enthalpy difference, non-ceiling flows [kJ/kg]. Brennan added these elements for calculating ventilation loads.
+	double Dhma; //Moist-air enthalpy difference, non-ceiling flows [kJ/kg]. Brennan added these elements for calculating ventilation loads.
+	double ceilingDhda; //Dry-air enthalpy difference, ceiling flows [kJ/kg]. Brennan added these elements for calculating ventilation loads.
+	double ceilingDhma; //Moist-air enthalpy difference, ceiling flows [kJ/kg]. Brennan added these elements for calculating ventilation loads.
+	double DAventLoad; //Dry-air enthalpy load [kJ/min]. Brennan added these elements for calculating ventilation loads.
+	double MAventLoad; //Moist-air enthaply load [kJ/min]. Brennan added these elements for calculating ventilation loads.
+	double TotalDAventLoad; //Brennan added these elements for calculating ventilation loads [kJ].
+	double TotalMAventLoad; //Brennan added these elements for calculating ventilation loads [kJ].
+	vector<double> averageTemp;	// Array to track the 7 day running average
+	double dailyCumulativeTemp;
+	double dailyAverageTemp;
+	double runningAverageTemp;
+	double AIM2; //Brennan added
+	double AEQaim2FlowDiff; //Brennan added
+	double FlowDiff; //Brennan added
+	double qFanFlowRatio; //Brennan added
+	double FanQ; //Brennan's attempt to fix the airflow outside of the if() structures in the fan.oper section. fan[0].q was always the whole house exhaust fan, to be operated continuously or controlled by temperature controls.
+	double FanP; //Brennan's attempt to fix the fan power outside of the if() structures in the fan.oper section.
+	double doseTarget; //Targeted dose value based on the climate zone file.
+	double HiDose; //Variable high dose value for real-time humidity control, based on worst-case large, low-occupancy home.
+	int HiMonths[3];
+	int LowMonths[3];
+	double HiMonthDose;
+	double LowMonthDose;
+	double W25; //25th percentile control, for outdoor humidity sensor control #14
+	double W75; //75th percentile control, for outdoor humidity sensor control #14
+};
+
+// Registers a double member of simulation_struct as an output variable (see output.h) and returns its handle.
+// step() copies the member of each simulation into its output every minute, after the built-in variables.
+int f_registerOutput(string name, double simulation_struct::* member);
+
+// Steps the numHouses houses (all different) by the same minute of weather, each as its step() would, with result[i]
+// set to what step() returns. The houses are taken MAX_LANES at a time: each is prepared and completed on its own, and
+// the airflow and heat balance of all of them runs through the lane routines of functions.h, the ceiling flow and main
+// iterations masking off each house as it settles. Profiling and capture builds step the houses one by one, as their
+// counts and records are kept for one house at a time.
+void sub_stepLanes(simulation_struct* house[], int numHouses, const weatherSample_struct& weather, int result[]);
+
+#endif
@@ -0,0 +1,383 @@
+#include "statistics.h"
+#include "report.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace std;
+
+static const char* kindNames[] = { "mean", "histogram", "quantile", "above", "below", "peak" };
+static const int numKinds = 6;
+
+// Last day of each month in a 365 day year
+static const int monthEnd[12] = { 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365 };
+
+static int f_month(int day) {
+	int dayOfYear = (day - 1) % 365 + 1;
+	for(int m = 0; m < 12; m++) {
+		if(dayOfYear <= monthEnd[m])
+			return m;
+	}
+	return 11;
+}
+
+int f_readStatistics(string statisticsFile_name, vector<statisticSpec_struct>& specs) {
+	ifstream statisticsFile(statisticsFile_name);
+	if(!statisticsFile) {
+		sub_report("Cannot open: " + statisticsFile_name);
+		return 1;
+	}
+
+	string line;
+	while(getline(statisticsFile, line)) {
+		if(!line.empty() && line[line.size() - 1] == '\r')
+			line.erase(line.size() - 1);
+
+		istringstream fields(line);
+		string kindName, variableName;
+		if(!(fields >> kindName) || kindName[0] == '#')
+			continue;
+
+		statisticSpec_struct spec;
+		spec.kind = -1;
+		for(int k = 0; k < numKinds; k++) {
+			if(kindName == kindNames[k])
+				spec.kind = k;
+		}
+
+		fields >> variableName;
+		spec.variable = f_outputVariable(variableName);
+
+		double parameter;
+		while(fields >> parameter)
+			spec.parameters.push_back(parameter);
+
+		int bad = spec.kind < 0 || spec.variable < 0 || !fields.eof();
+		switch (spec.kind) {
+		case STAT_HISTOGRAM:
+			bad = bad || spec.parameters.size() != 3 || spec.parameters[1] <= spec.parameters[0] || spec.parameters[2] < 1;
+			break;
+		case STAT_QUANTILE:
+			for(size_t i = 0; i < spec.parameters.size(); i++)
+				bad = bad || spec.parameters[i] <= 0 || spec.parameters[i] >= 1;
+			// Fall through: quantile, above and below need at least one parameter
+		case STAT_ABOVE:
+		case STAT_BELOW:
+			bad = bad || spec.parameters.empty();
+			break;
+		default:
+			bad = bad || !spec.parameters.empty();
+		}
+
+		if(bad) {
+			sub_report("Bad line in " + statisticsFile_name + ": " + line);
+			return 2;
+		}
+		specs.push_back(spec);
+	}
+	return 0;
+}
+
+void quantileSketch_struct::init() {
+	count = 0;
+	nonFinite = 0;
+	min = 0;
+	max = 0;
+	lo = 0;
+	width = 0;
+	samples.clear();
+	samples.reserve(QUANTILE_BINS);
+	bins.clear();
+}
+
+void quantileSketch_struct::add(double x) {
+	if(!(x >= -DBL_MAX && x <= DBL_MAX)) {
+		nonFinite++;
+		return;
+	}
+
+	if(count == 0 || x < min)
+		min = x;
+	if(count == 0 || x > max)
+		max = x;
+	count++;
+
+	if(width == 0) {
+		samples.push_back(x);
+		if(int (samples.size()) < QUANTILE_BINS)
+			return;
+
+		// Switch to bins, centred on the range seen so far with room to spare on each side
+		double range = max - min;
+		if(range <= 0)
+			range = abs(max) > 0 ? abs(max) * 1e-6 : 1e-9;
+		width = 2 * range / QUANTILE_BINS;
+		lo = min - range / 2;
+		bins.assign(QUANTILE_BINS, 0);
+
+		for(size_t i = 0; i < samples.size(); i++)
+			sub_bin(samples[i]);
+		samples.clear();
+		return;
+	}
+
+	sub_bin(x);
+}
+
+void quantileSketch_struct::sub_bin(double x) {
+	// Double the bin width until x is in range; the old range becomes the upper half if x is below it, else the lower
+	while(x < lo || x >= lo + width * QUANTILE_BINS) {
+		vector<long long> merged(QUANTILE_BINS, 0);
+		int offset = x < lo ? QUANTILE_BINS / 2 : 0;
+		for(int i = 0; i < QUANTILE_BINS; i++)
+			merged[offset + i / 2] = merged[offset + i / 2] + bins[i];
+		if(x < lo)
+			lo = lo - width * QUANTILE_BINS;
+		width = 2 * width;
+		bins.swap(merged);
+	}
+
+	int bin = int ((x - lo) / width);
+	if(bin > QUANTILE_BINS - 1)
+		bin = QUANTILE_BINS - 1;
+	bins[bin]++;
+}
+
+double quantileSketch_struct::value(double p) {
+	if(count == 0)
+		return 0;
+
+	if(width == 0) {
+		vector<double> sorted(samples);
+		sort(sorted.begin(), sorted.end());
+		return sorted[size_t (p * (sorted.size() - 1) + 0.5)];
+	}
+
+	// Interpolate linearly within the bin holding the p quantile
+	double rank = p * count;
+	long long below = 0;
+	for(int i = 0; i < QUANTILE_BINS; i++) {
+		if(bins[i] > 0 && below + bins[i] >= rank) {
+			double x = lo + width * (i + (rank - below) / bins[i]);
+			return x < min ? min : (x > max ? max : x);
+		}
+		below = below + bins[i];
+	}
+	return max;
+}
+
+void statistics_struct::init(vector<statisticSpec_struct>& specs) {
+	stats.clear();
+	stats.resize(specs.size());
+
+	for(size_t k = 0; k < specs.size(); k++) {
+		statistic_struct& s = stats[k];
+		s.spec = specs[k];
+		s.count = 0;
+		s.sum = 0;
+		for(int m = 0; m < 12; m++) {
+			s.monthSum[m] = 0;
+			s.monthCount[m] = 0;
+		}
+		for(int h = 0; h < 24; h++) {
+			s.hourSum[h] = 0;
+			s.hourCount[h] = 0;
+		}
+
+		if(s.spec.kind == STAT_HISTOGRAM)
+			s.bins.assign(int (s.spec.parameters[2]) + 2, 0);
+
+		if(s.spec.kind == STAT_QUANTILE)
+			s.sketch.init();
+
+		if(s.spec.kind == STAT_ABOVE || s.spec.kind == STAT_BELOW) {
+			s.thresholdMinutes.assign(s.spec.parameters.size(), 0);
+			s.spell.assign(s.spec.parameters.size(), 0);
+			s.longestSpell.assign(s.spec.parameters.size(), 0);
+		}
+
+		s.max = 0;
+		s.min = 0;
+		s.maxMinute = 0;
+		s.minMinute = 0;
+		s.currentHour = -1;
+		s.hourTotal = 0;
+		s.hourMinutes = 0;
+		s.maxHourMean = -DBL_MAX;
+		s.currentDay = -1;
+		s.dayMax = 0;
+		s.dailyMaxSum = 0;
+		s.days = 0;
+	}
+}
+
+void statistics_struct::add(double* output, long int minute, int day, int hour) {
+	for(size_t k = 0; k < stats.size(); k++) {
+		statistic_struct& s = stats[k];
+		double x = output[s.spec.variable];
+
+		s.count++;
+		s.sum = s.sum + x;
+
+		switch (s.spec.kind) {
+		case STAT_MEAN: {
+			int m = f_month(day);
+			s.monthSum[m] = s.monthSum[m] + x;
+			s.monthCount[m]++;
+			s.hourSum[hour] = s.hourSum[hour] + x;
+			s.hourCount[hour]++;
+			break;
+		}
+
+		case STAT_HISTOGRAM: {
+			double lo = s.spec.parameters[0];
+			double hi = s.spec.parameters[1];
+			int numBins = int (s.bins.size()) - 2;
+			int bin;
+			if(x < lo)
+				bin = 0;
+			else if(x >= hi)
+				bin = numBins + 1;
+			else
+				bin = 1 + int ((x - lo) / (hi - lo) * numBins);
+			if(bin > numBins)
+				bin = numBins;		// Rounding at the top edge
+			s.bins[bin]++;
+			break;
+		}
+
+		case STAT_QUANTILE:
+			s.sketch.add(x);
+			break;
+
+		case STAT_ABOVE:
+		case STAT_BELOW:
+			for(size_t i = 0; i < s.spec.parameters.size(); i++) {
+				int past = s.spec.kind == STAT_ABOVE ? x > s.spec.parameters[i] : x < s.spec.parameters[i];
+				if(past) {
+					s.thresholdMinutes[i]++;
+					s.spell[i]++;
+					if(s.spell[i] > s.longestSpell[i])
+						s.longestSpell[i] = s.spell[i];
+				} else {
+					s.spell[i] = 0;
+				}
+			}
+			break;
+
+		case STAT_PEAK:
+			if(s.count == 1 || x > s.max) {
+				s.max = x;
+				s.maxMinute = minute;
+			}
+			if(s.count == 1 || x < s.min) {
+				s.min = x;
+				s.minMinute = minute;
+			}
+
+			if(hour != s.currentHour) {
+				if(s.hourMinutes > 0 && s.hourTotal / s.hourMinutes > s.maxHourMean)
+					s.maxHourMean = s.hourTotal / s.hourMinutes;
+				s.currentHour = hour;
+				s.hourTotal = 0;
+				s.hourMinutes = 0;
+			}
+			s.hourTotal = s.hourTotal + x;
+			s.hourMinutes++;
+
+			if(day != s.currentDay) {
+				if(s.currentDay >= 0) {
+					s.dailyMaxSum = s.dailyMaxSum + s.dayMax;
+					s.days++;
+				}
+				s.currentDay = day;
+				s.dayMax = x;
+			}
+			if(x > s.dayMax)
+				s.dayMax = x;
+			break;
+		}
+	}
+}
+
+// Writes the .rcs summary: one row per value, as variable, statistic and value
+int statistics_struct::write(string fileName) {
+	ofstream rcsFile(fileName);
+	if(!rcsFile) {
+		sub_report("Cannot open: " + fileName);
+		return 1;
+	}
+
+	rcsFile << "Variable\tStatistic\tValue" << endl;
+
+	for(size_t k = 0; k < stats.size(); k++) {
+		statistic_struct& s = stats[k];
+		string variable = f_outputName(s.spec.variable);
+
+		switch (s.spec.kind) {
+		case STAT_MEAN:
+			rcsFile << variable << "\tmean\t" << (s.count ? s.sum / s.count : 0) << endl;
+			for(int m = 0; m < 12; m++)
+				rcsFile << variable << "\tmean month " << m + 1 << "\t" << (s.monthCount[m] ? s.monthSum[m] / s.monthCount[m] : 0) << endl;
+			for(int h = 0; h < 24; h++)
+				rcsFile << variable << "\tmean hour " << h << "\t" << (s.hourCount[h] ? s.hourSum[h] / s.hourCount[h] : 0) << endl;
+			break;
+
+		case STAT_HISTOGRAM: {
+			double lo = s.spec.parameters[0];
+			double hi = s.spec.parameters[1];
+			int numBins = int (s.bins.size()) - 2;
+			rcsFile << variable << "\tminutes below " << lo << "\t" << s.bins[0] << endl;
+			for(int i = 0; i < numBins; i++)
+				rcsFile << variable << "\tminutes " << lo + (hi - lo) * i / numBins << " to " << lo + (hi - lo) * (i + 1) / numBins << "\t" << s.bins[i + 1] << endl;
+			rcsFile << variable << "\tminutes from " << hi << "\t" << s.bins[numBins + 1] << endl;
+			break;
+		}
+
+		case STAT_QUANTILE:
+			for(size_t i = 0; i < s.spec.parameters.size(); i++)
+				rcsFile << variable << "\tquantile " << s.spec.parameters[i] << "\t" << s.sketch.value(s.spec.parameters[i]) << endl;
+			if(s.sketch.nonFinite > 0)
+				rcsFile << variable << "\tnon-finite minutes\t" << s.sketch.nonFinite << endl;
+			break;
+
+		case STAT_ABOVE:
+		case STAT_BELOW: {
+			const char* side = s.spec.kind == STAT_ABOVE ? "above" : "below";
+			for(size_t i = 0; i < s.spec.parameters.size(); i++) {
+				rcsFile << variable << "\tminutes " << side << " " << s.spec.parameters[i] << "\t" << s.thresholdMinutes[i] << endl;
+				rcsFile << variable << "\thours " << side << " " << s.spec.parameters[i] << "\t" << s.thresholdMinutes[i] / 60.0 << endl;
+				rcsFile << variable << "\tlongest minutes " << side << " " << s.spec.parameters[i] << "\t" << s.longestSpell[i] << endl;
+			}
+			break;
+		}
+
+		case STAT_PEAK: {
+			// The last hour and day are still open
+			double maxHourMean = s.maxHourMean;
+			if(s.hourMinutes > 0 && s.hourTotal / s.hourMinutes > maxHourMean)
+				maxHourMean = s.hourTotal / s.hourMinutes;
+			double dailyMaxSum = s.dailyMaxSum + (s.currentDay >= 0 ? s.dayMax : 0);
+			int days = s.days + (s.currentDay >= 0 ? 1 : 0);
+
+			rcsFile << variable << "\tmax\t" << s.max << endl;
+			rcsFile << variable << "\tminute of max\t" << s.maxMinute << endl;
+			rcsFile << variable << "\tmin\t" << s.min << endl;
+			rcsFile << variable << "\tminute of min\t" << s.minMinute << endl;
+			rcsFile << variable << "\tmax hourly mean\t" << (maxHourMean > -DBL_MAX ? maxHourMean : 0) << endl;
+			rcsFile << variable << "\tmean daily max\t" << (days ? dailyMaxSum / days : 0) << endl;
+			break;
+		}
+		}
+	}
+
+	rcsFile.close();
+	if(rcsFile.fail()) {
+		sub_report("Cannot write: " + fileName);
+		return 1;
+	}
+	return 0;
+}
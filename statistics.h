@@ -0,0 +1,107 @@
+#pragma once
+#ifndef statistics_h
+#define statistics_h
+
+#include <string>
+#include <vector>
+#include "output.h"
+
+using namespace std;
+
+// Streaming statistics over the output variables, gathered minute by minute and written to a summary file
+// (.rcs) at the end of each simulation, so the studies that only need distributions can do without the
+// per-minute files. The statistics come from a file with one line per statistic:
+//
+//	# statistic	variable	parameters
+//	mean		tempHouse						annual, monthly and hour-of-day means
+//	histogram	RH%house	0 100 20			minutes in 20 equal bins from 0 to 100, plus below and above
+//	quantile	RH%house	0.5 0.9 0.99		estimates of each quantile from a quantile sketch
+//	above		RH%house	60 70				minutes and hours above each threshold, and the longest spell
+//	below		tempHouse	291.15				the same below each threshold
+//	peak		AHpower							max and min with their minute, highest hourly mean, mean daily max
+//
+// Variables are the .rco and .hum column names (see output.h).
+
+enum statisticKind_enum {
+	STAT_MEAN,
+	STAT_HISTOGRAM,
+	STAT_QUANTILE,
+	STAT_ABOVE,
+	STAT_BELOW,
+	STAT_PEAK
+};
+
+// One line of the statistics file
+struct statisticSpec_struct {
+	int kind;
+	int variable;
+	vector<double> parameters;
+};
+
+// Returns 1 if the file cannot be opened and 2 for a line that cannot be used
+int f_readStatistics(string statisticsFile_name, vector<statisticSpec_struct>& specs);
+
+const int QUANTILE_BINS = 4096;
+
+// Quantile sketch: the first QUANTILE_BINS samples are kept as they are, then they and every later sample go
+// into QUANTILE_BINS equal bins spanning twice their range. A sample outside the range doubles the bin width
+// (merging pairs of bins) until it fits. Quantiles interpolate within a bin, so the error is under one bin
+// width whatever the order of the samples; a year of minutes usually ends up with bins of 1/2000 of the range.
+// Infinite and NaN samples are only counted, since no bin width can hold them.
+struct quantileSketch_struct {
+	void init();
+	void add(double x);
+	double value(double p);
+	void sub_bin(double x);
+
+	long long count;
+	long long nonFinite;		// Infinite and NaN samples left out of count and the bins
+	double min;
+	double max;
+	double lo;					// Bottom of the binned range
+	double width;				// Bin width (0 while samples are still kept as they are)
+	vector<double> samples;
+	vector<long long> bins;
+};
+
+// Running state of one statistic
+struct statistic_struct {
+	statisticSpec_struct spec;
+
+	long long count;
+	double sum;
+	double monthSum[12];
+	long long monthCount[12];
+	double hourSum[24];
+	long long hourCount[24];
+
+	vector<long long> bins;					// Histogram: below the range, the bins, above the range
+	quantileSketch_struct sketch;
+
+	vector<long long> thresholdMinutes;		// Above/below: minutes past each threshold
+	vector<long int> spell;					// Current run of minutes past each threshold
+	vector<long int> longestSpell;
+
+	double max;
+	double min;
+	long int maxMinute;
+	long int minMinute;
+	int currentHour;
+	double hourTotal;						// Sum over the current clock hour, for the hourly mean
+	int hourMinutes;
+	double maxHourMean;
+	int currentDay;
+	double dayMax;
+	double dailyMaxSum;
+	int days;
+};
+
+struct statistics_struct {
+	void init(vector<statisticSpec_struct>& specs);
+	void add(double* output, long int minute, int day, int hour);
+	int write(string fileName);
+
+	vector<statistic_struct> stats;
+};
+
+#endif
@@ -0,0 +1,440 @@
+#include <iostream>
+#include <sstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include "weather.h"
+#include "report.h"
+
+using namespace std;
+
+// Lower-case extension of a file name, with its dot ("" if none)
+static string f_extension(string file_name) {
+	size_t dot = file_name.find_last_of('.');
+	size_t slash = file_name.find_last_of("\\/");
+	if(dot == string::npos || (slash != string::npos && dot < slash))
+		return "";
+	string extension = file_name.substr(dot);
+	for(size_t i = 0; i < extension.size(); i++)
+		extension[i] = (char) tolower(extension[i]);
+	return extension;
+}
+
+string f_weatherFile_name(string weatherPath, string weather_file) {
+	weather_file = weather_file.substr(0, weather_file.find('@'));
+	string extension = f_extension(weather_file);
+	if(extension == ".ws3" || extension == ".epw" || extension == ".csv")
+		return weatherPath + weather_file;
+
+	const char* extensions[3] = { ".ws3", ".epw", ".csv" };
+	for(int i = 0; i < 3; i++) {
+		ifstream file(weatherPath + weather_file + extensions[i]);
+		if(file)
+			return weatherPath + weather_file + extensions[i];
+	}
+	return weatherPath + weather_file + ".ws3";
+}
+
+double f_saturationPressure(double temperature) {
+	if(temperature - 273.15 <= 0)
+		return exp(-5.6745359E+03 / temperature + 6.3925247E+00 - 9.6778430E-03 * temperature + 6.2215701E-07 * pow(temperature, 2)
+			+ 2.0747825E-09 * pow(temperature, 3) - 9.4840240E-13 * pow(temperature, 4) + 4.1635019E+00 * log(temperature));
+	return exp(-5.8002206E+03 / temperature + 1.3914993E+00 - 4.8640239E-02 * temperature + 4.1764768E-05 * pow(temperature, 2)
+		- 1.4452093E-08 * pow(temperature, 3) + 6.5459673E+00 * log(temperature));
+}
+
+// Fields of a comma separated line; commas inside quotes do not split
+static vector<string> f_splitCsv(string line) {
+	vector<string> fields(1);
+	int quoted = 0;
+	for(size_t i = 0; i < line.size(); i++) {
+		if(line[i] == '"')
+			quoted = !quoted;
+		else if(line[i] == ',' && !quoted)
+			fields.push_back("");
+		else if(line[i] != '\r')
+			fields.back() += line[i];
+	}
+	return fields;
+}
+
+// Field as a number, or a value that fails every check below when it is missing
+static double f_field(vector<string>& fields, int column) {
+	if(column < 0 || column >= (int) fields.size() || fields[column].empty())
+		return -99999;
+	return atof(fields[column].c_str());
+}
+
+// Makes an hour from the values in the file's units, repeating the previous hour's value for anything missing
+static weatherHour_struct f_hour(double temperature, double dewPoint, double pressure, double direct, double total, double direction,
+	double windSpeed, double cloud, weatherHour_struct& previous) {
+
+	weatherHour_struct hour = previous;
+	if(temperature > -90 && temperature < 70)
+		hour.weatherTemp = temperature;
+	if(pressure > 30 && pressure < 120)
+		hour.pRef = pressure;
+	if(dewPoint > -90 && dewPoint < 70) {
+		double vapourPressure = f_saturationPressure(dewPoint + 273.15);
+		hour.HROUT = 0.621945 * vapourPressure / (1000 * hour.pRef - vapourPressure);
+	}
+	if(direct >= 0 && direct < 2000)
+		hour.direct = direct;
+	if(total >= 0 && total < 2000)
+		hour.total = total;
+	if(direction >= 0 && direction <= 360)
+		hour.direction = direction;
+	if(windSpeed >= 0 && windSpeed < 90)
+		hour.windSpeed = windSpeed;
+	if(cloud >= 0 && cloud <= 10)
+		hour.sc = cloud;
+	return hour;
+}
+
+// TMY3 .csv: a line of station, name, state, time zone, latitude, longitude and elevation [m], then a line of column
+// names, then the hours from 1:00 on January 1st (pressure in [mbar], cloud cover in tenths)
+static int f_readTmy3(ifstream& file, vector<weatherHour_struct>& hours, double& latitude, double& altitude) {
+	string line;
+	if(!getline(file, line))
+		return 1;
+	vector<string> station = f_splitCsv(line);
+	if(station.size() < 7)
+		return 1;
+	latitude = atof(station[4].c_str());
+	altitude = atof(station[6].c_str());
+
+	const int COLUMNS = 8;
+	const char* names[COLUMNS] = { "Dry-bulb", "Dew-point", "Pressure", "DNI", "GHI", "Wdir", "Wspd", "TotCld" };
+	int columns[COLUMNS];
+	if(!getline(file, line))
+		return 1;
+	vector<string> header = f_splitCsv(line);
+	for(int c = 0; c < COLUMNS; c++) {
+		columns[c] = -1;
+		for(size_t i = 0; i < header.size(); i++) {
+			if(header[i].substr(0, header[i].find(" (")) == names[c])
+				columns[c] = (int) i;
+		}
+		if(columns[c] < 0)
+			return 1;
+	}
+
+	weatherHour_struct previous = { 0, 0, 20, 0.008, 0, 0, 101.325, 0 };
+	while(getline(file, line)) {
+		vector<string> fields = f_splitCsv(line);
+		if(fields.size() < header.size())
+			continue;
+		previous = f_hour(f_field(fields, columns[0]), f_field(fields, columns[1]), f_field(fields, columns[2]) / 10, f_field(fields, columns[3]),
+			f_field(fields, columns[4]), f_field(fields, columns[5]), f_field(fields, columns[6]), f_field(fields, columns[7]), previous);
+		hours.push_back(previous);
+	}
+	return hours.empty();
+}
+
+// EnergyPlus .epw: LOCATION (latitude and elevation [m] in the 7th and 10th fields) and seven more header lines,
+// then the hours from 1:00 on January 1st (pressure in [Pa], sky cover in tenths)
+static int f_readEpw(ifstream& file, vector<weatherHour_struct>& hours, double& latitude, double& altitude) {
+	string line;
+	if(!getline(file, line))
+		return 1;
+	vector<string> location = f_splitCsv(line);
+	if(location.size() < 10 || location[0] != "LOCATION")
+		return 1;
+	latitude = atof(location[6].c_str());
+	altitude = atof(location[9].c_str());
+	for(int i = 0; i < 7; i++)
+		getline(file, line);
+
+	weatherHour_struct previous = { 0, 0, 20, 0.008, 0, 0, 101.325, 0 };
+	while(getline(file, line)) {
+		vector<string> fields = f_splitCsv(line);
+		if(fields.size() < 23)
+			continue;
+		previous = f_hour(f_field(fields, 6), f_field(fields, 7), f_field(fields, 9) / 1000, f_field(fields, 14), f_field(fields, 13),
+			f_field(fields, 20), f_field(fields, 21), f_field(fields, 22), previous);
+		hours.push_back(previous);
+	}
+	return hours.empty();
+}
+
+// Opens a weather file and reads the latitude and altitude from its header (the first line of a .ws3 file)
+int sub_openWeather(weatherFile_struct& weatherFile, string weatherFile_name, double& latitude, double& altitude) {
+	weatherFile.hours.clear();
+	weatherFile.minute = 0;
+	weatherFile.failed = 0;
+	weatherFile.file.open(weatherFile_name);
+	if(!weatherFile.file)
+		return 1;
+
+	string extension = f_extension(weatherFile_name);
+	if(extension == ".csv" || extension == ".epw") {
+		int error = extension == ".csv" ? f_readTmy3(weatherFile.file, weatherFile.hours, latitude, altitude)
+			: f_readEpw(weatherFile.file, weatherFile.hours, latitude, altitude);
+		weatherFile.file.close();
+		return error;
+	}
+
+	weatherFile.file >> latitude >> altitude;
+	return 0;
+}
+
+// Value at time t [minutes] of hourly values, the first of them at time first
+static double f_interpolate(vector<weatherHour_struct>& hours, double weatherHour_struct::* value, double t, double first) {
+	double position = (t - first) / 60;
+	if(position <= 0)
+		return hours[0].*value;
+	size_t i = (size_t) position;
+	if(i + 1 >= hours.size())
+		return hours.back().*value;
+	double fraction = position - i;
+	return hours[i].*value + fraction * (hours[i + 1].*value - hours[i].*value);
+}
+
+// Reads the next minute of weather. Returns false once the end of the file has been reached.
+bool f_readWeather(weatherFile_struct& weatherFile, weatherSample_struct& weather) {
+	if(weatherFile.hours.empty()) {
+		weatherFile.file >> weather.day >> weather.idirect >> weather.solth >> weather.weatherTemp >> weather.HROUT >> weather.windSpeed >> weather.direction >> weather.pRef >> weather.sc;
+		return !weatherFile.file.fail();
+	}
+
+	vector<weatherHour_struct>& hours = weatherFile.hours;
+	if(weatherFile.failed || weatherFile.minute >= (long int) hours.size() * 60) {
+		weatherFile.failed = 1;
+		return false;
+	}
+	weatherFile.minute++;
+	double t = (double) weatherFile.minute;
+
+	weather.day = (int) ((weatherFile.minute - 1) / 1440) + 1;
+	weather.idirect = (int) floor(f_interpolate(hours, &weatherHour_struct::direct, t, 30) + 0.5);
+	weather.solth = (int) floor(f_interpolate(hours, &weatherHour_struct::total, t, 30) + 0.5);
+	weather.weatherTemp = f_interpolate(hours, &weatherHour_struct::weatherTemp, t, 60);
+	weather.HROUT = f_interpolate(hours, &weatherHour_struct::HROUT, t, 60);
+	weather.windSpeed = f_interpolate(hours, &weatherHour_struct::windSpeed, t, 60);
+	weather.pRef = f_interpolate(hours, &weatherHour_struct::pRef, t, 60);
+	weather.sc = f_interpolate(hours, &weatherHour_struct::sc, t, 60);
+
+	// Wind direction the short way round, between the hours either side
+	double position = (t - 60) / 60;
+	size_t i = position <= 0 ? 0 : (size_t) position;
+	if(position <= 0 || i + 1 >= hours.size()) {
+		weather.direction = position <= 0 ? hours[0].direction : hours.back().direction;
+	} else {
+		double change = hours[i + 1].direction - hours[i].direction;
+		if(change > 180)
+			change = change - 360;
+		if(change < -180)
+			change = change + 360;
+		weather.direction = hours[i].direction + (position - i) * change;
+		if(weather.direction < 0)
+			weather.direction = weather.direction + 360;
+		if(weather.direction >= 360)
+			weather.direction = weather.direction - 360;
+	}
+	return true;
+}
+
+// Reads up to the next minutes of weather into samples without moving on in the file, for looking ahead.
+// Returns the number of minutes read (fewer near the end of the file).
+int f_peekWeather(weatherFile_struct& weatherFile, int minutes, vector<weatherSample_struct>& samples) {
+	samples.clear();
+	streampos position = weatherFile.file.tellg();
+	long int minute = weatherFile.minute;
+	int failed = weatherFile.failed;
+	weatherSample_struct weather;
+	while((int) samples.size() < minutes && f_readWeather(weatherFile, weather))
+		samples.push_back(weather);
+
+	if(weatherFile.hours.empty()) {
+		weatherFile.file.clear();
+		weatherFile.file.seekg(position);
+	}
+	weatherFile.minute = minute;
+	weatherFile.failed = failed;
+	return (int) samples.size();
+}
+
+int f_seekWeather(weatherFile_struct& weatherFile, int day) {
+	long int minutes = (long int) (day - 1) * 1440;
+	if(!weatherFile.hours.empty()) {
+		weatherFile.minute = minutes;
+		return minutes >= (long int) weatherFile.hours.size() * 60;
+	}
+
+	weatherFile.file.ignore(numeric_limits<streamsize>::max(), '\n');		// The rest of the header line
+	for(long int m = 0; m < minutes && weatherFile.file; m++)
+		weatherFile.file.ignore(numeric_limits<streamsize>::max(), '\n');
+	return weatherFile.file.peek() == EOF;
+}
+
+int f_dayOfYear(string date) {
+	const int monthStart[12] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+	const int monthDays[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	int month, day;
+	char slash, extra;
+	istringstream fields(date);
+	if(fields >> month >> slash >> day && slash == '/' && !(fields >> extra)) {
+		if(month < 1 || month > 12 || day < 1 || day > monthDays[month - 1])
+			return 0;
+		return monthStart[month - 1] + day;
+	}
+
+	istringstream number(date);
+	if(number >> day && !(number >> extra) && day > 0)
+		return day;
+	return 0;
+}
+
+void weatherFile_struct::close() {
+	if(file.is_open())
+		file.close();
+	hours.clear();
+}
+
+// True once a read has gone past the end of the file, as for an ifstream
+bool weatherFile_struct::fail() {
+	return hours.empty() ? file.fail() : failed != 0;
+}
+
+string f_transformName(string weather_file) {
+	size_t at = weather_file.find('@');
+	return at == string::npos ? "" : weather_file.substr(at + 1);
+}
+
+// Reads a number that makes up all of value. Returns 1 for anything else.
+static int f_number(string value, double& x) {
+	char* end;
+	x = strtod(value.c_str(), &end);
+	return value.empty() || *end != 0;
+}
+
+// Reads one value or twelve separated by commas into months. Returns 1 for any other count.
+static int f_months(string value, double months[12]) {
+	vector<string> fields = f_splitCsv(value);
+	if(fields.size() != 1 && fields.size() != 12)
+		return 1;
+	for(int m = 0; m < 12; m++) {
+		if(f_number(fields.size() == 1 ? fields[0] : fields[m], months[m]))
+			return 1;
+	}
+	return 0;
+}
+
+int f_readTransforms(string transformsFile_name, vector<weatherTransform_struct>& transforms) {
+	ifstream transformsFile(transformsFile_name);
+	if(!transformsFile) {
+		sub_report("Cannot open: " + transformsFile_name);
+		return 1;
+	}
+
+	string line;
+	while(getline(transformsFile, line)) {
+		if(!line.empty() && line[line.size() - 1] == '\r')
+			line.erase(line.size() - 1);
+
+		istringstream fields(line);
+		string setting;
+		weatherTransform_struct transform;
+		if(!(fields >> transform.name) || transform.name[0] == '#')
+			continue;
+
+		for(int m = 0; m < 12; m++) {
+			transform.shift[m] = 0;
+			transform.stretch[m] = 1;
+			transform.monthMean[m] = 0;
+		}
+		transform.humidity = 1;
+		transform.wind = 1;
+		transform.solar = 1;
+
+		int bad = 0;
+		for(size_t t = 0; t < transforms.size(); t++) {
+			if(transforms[t].name == transform.name)
+				bad = 1;
+		}
+		while(fields >> setting) {
+			size_t equals = setting.find('=');
+			string name = setting.substr(0, equals);
+			string value = equals == string::npos ? "" : setting.substr(equals + 1);
+			if(name == "shift")
+				bad = bad || f_months(value, transform.shift);
+			else if(name == "stretch")
+				bad = bad || f_months(value, transform.stretch);
+			else if(name == "humidity")
+				bad = bad || f_number(value, transform.humidity);
+			else if(name == "wind")
+				bad = bad || f_number(value, transform.wind);
+			else if(name == "solar")
+				bad = bad || f_number(value, transform.solar);
+			else
+				bad = 1;
+		}
+
+		if(bad || transform.humidity < 0 || transform.wind < 0 || transform.solar < 0) {
+			sub_report("Bad line in " + transformsFile_name + ": " + line);
+			return 2;
+		}
+		transforms.push_back(transform);
+	}
+	return 0;
+}
+
+// Month (0 to 11) of a day of the year, taking the year as 365 days; later days are in December
+static int f_month(int day) {
+	const int monthEnd[12] = { 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365 };
+	int month = 0;
+	while(month < 11 && day > monthEnd[month])
+		month++;
+	return month;
+}
+
+int f_monthlyMeans(string weatherFile_name, double monthMean[12]) {
+	static mutex lock;
+	static map<string, vector<double> > means;
+
+	lock_guard<mutex> guard(lock);
+	if(means.find(weatherFile_name) == means.end()) {
+		weatherFile_struct weatherFile;
+		double latitude, altitude;
+		if(sub_openWeather(weatherFile, weatherFile_name, latitude, altitude)) {
+			sub_report("Cannot open: " + weatherFile_name);
+			return 1;
+		}
+
+		vector<double> sum(12, 0), count(12, 0);
+		weatherSample_struct weather;
+		while(f_readWeather(weatherFile, weather)) {
+			int month = f_month(weather.day);
+			sum[month] = sum[month] + weather.weatherTemp;
+			count[month] = count[month] + 1;
+		}
+		weatherFile.close();
+
+		vector<double>& mean = means[weatherFile_name];
+		for(int m = 0; m < 12; m++)
+			mean.push_back(count[m] > 0 ? sum[m] / count[m] : 0);
+	}
+
+	for(int m = 0; m < 12; m++)
+		monthMean[m] = means[weatherFile_name][m];
+	return 0;
+}
+
+void sub_transformWeather(weatherTransform_struct& transform, weatherSample_struct& weather) {
+	int month = f_month(weather.day);
+	weather.weatherTemp = weather.weatherTemp + transform.shift[month]
+		+ (transform.stretch[month] - 1) * (weather.weatherTemp - transform.monthMean[month]);
+
+	double saturationPressure = f_saturationPressure(weather.weatherTemp + 273.15);
+	double saturationHR = 0.621945 * saturationPressure / (1000 * weather.pRef - saturationPressure);
+	weather.HROUT = weather.HROUT * transform.humidity;
+	if(weather.HROUT > saturationHR)
+		weather.HROUT = saturationHR;
+
+	weather.windSpeed = weather.windSpeed * transform.wind;
+	weather.idirect = (int) floor(weather.idirect * transform.solar + 0.5);
+	weather.solth = (int) floor(weather.solth * transform.solar + 0.5);
+}
@@ -0,0 +1,99 @@
+#pragma once
+#ifndef weather_h
+#define weather_h
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "regcap.h"
+
+using namespace std;
+
+// One minute of weather as stored in a .ws3 file (units as in the file, converted in the simulation loop). It is
+// the regcap library's sample, so that a sample read once is stepped by every simulation without a copy.
+typedef regcap_weather weatherSample_struct;
+
+// One hour of an hourly TMY3 or EPW file, in the units of a .ws3 file
+struct weatherHour_struct {
+	double direct;			// Direct normal solar radiation [W/m2], over the hour
+	double total;			// Total horizontal solar radiation [W/m2], over the hour
+	double weatherTemp;		// At the end of the hour, as are the others
+	double HROUT;
+	double windSpeed;
+	double direction;
+	double pRef;
+	double sc;
+};
+
+// A weather file being read a minute at a time. A .ws3 file has a line for every minute and is read as the
+// simulation goes. Hourly TMY3 (.csv) and EnergyPlus (.epw) files are read whole when they are opened and
+// interpolated to minutes: the hour's values at the end of the hour, the solar radiation (an hour's average) at
+// its middle, and the wind direction the short way round. The humidity ratio comes from the dew point and
+// pressure; missing values (EPW 99.9, 999 and so on) repeat the hour before.
+struct weatherFile_struct {
+	void close();
+	bool fail();
+
+	ifstream file;
+	vector<weatherHour_struct> hours;	// Empty for a .ws3 file
+	long int minute;					// Minutes of the hourly file read so far
+	int failed;
+};
+
+int sub_openWeather(weatherFile_struct& weatherFile, string weatherFile_name, double& latitude, double& altitude);
+bool f_readWeather(weatherFile_struct& weatherFile, weatherSample_struct& weather);
+int f_peekWeather(weatherFile_struct& weatherFile, int minutes, vector<weatherSample_struct>& samples);
+
+// Moves a file just opened on to the first minute of a day of the year. Returns 1 if the file ends before it.
+int f_seekWeather(weatherFile_struct& weatherFile, int day);
+
+// Day of the year of a date given as a day number or month/day (ignoring leap years). Returns 0 if it is neither.
+int f_dayOfYear(string date);
+
+// Weather file of a climate: the name as given when it ends in .ws3, .epw or .csv, otherwise the .ws3 file, or
+// failing that the .epw or TMY3 .csv file of that name. A transform named after an @ is left off.
+string f_weatherFile_name(string weatherPath, string weather_file);
+
+// Changes made to the weather of one simulation as it is read, for future climate and sensitivity scenarios
+// without morphed copies of the weather files. A climate in a batch (or sweep) asks for one as climate@name, and
+// the transforms come from a file with one line per transform:
+//
+//	# name		setting=value ...
+//	warm2050	shift=2.1 stretch=1.1 humidity=1.05
+//	windy		wind=1.2 solar=0.9
+//	summer		shift=0,0,0,0,1,2,3,3,2,0,0,0
+//
+//	shift		Added to the outdoor temperature [C]
+//	stretch		Factor on the temperature's departure from the base file's mean for the month
+//	humidity	Factor on the outdoor humidity ratio, which is then kept at or below saturation
+//	wind		Factor on the wind speed
+//	solar		Factor on the direct and total solar radiation
+//
+// Shift and stretch take one value, or twelve separated by commas for January to December. Simulations of one
+// weather file with different transforms still share the file; the transform is applied in each simulation's step.
+struct weatherTransform_struct {
+	string name;
+	double shift[12];
+	double stretch[12];
+	double humidity;
+	double wind;
+	double solar;
+	double monthMean[12];	// Mean temperature of each month of the base weather file [C], for stretch
+};
+
+// Returns 1 if the file cannot be opened and 2 for a line that cannot be used
+int f_readTransforms(string transformsFile_name, vector<weatherTransform_struct>& transforms);
+
+// Transform named in a climate (after the @), "" for none
+string f_transformName(string weather_file);
+
+// Mean temperature of each month of a weather file. Each file is read once and kept for later calls, from any
+// thread. Returns 1 if the file cannot be opened.
+int f_monthlyMeans(string weatherFile_name, double monthMean[12]);
+
+void sub_transformWeather(weatherTransform_struct& transform, weatherSample_struct& weather);
+
+// Saturation vapour pressure [Pa] over ice below 0 C and over water above (ASHRAE HoF), temperature in [K]
+double f_saturationPressure(double temperature);
+
+#endif
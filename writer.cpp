@@ -0,0 +1,319 @@
+#include "writer.h"
+#include <iostream>
+#include <cstdio>
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#ifdef REGCAP_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace std;
+
+struct writerFile_struct {
+	FILE* handle;
+	int level;
+	int error;
+	int closed;
+#ifdef REGCAP_ZLIB
+	z_stream stream;
+	vector<char> compressed;
+#endif
+};
+
+struct writerJob_struct {
+	writerFile_struct* file;
+	vector<char> data;
+	int close;
+};
+
+// The writer thread and its queue. The thread starts with the first block and is joined when the program ends.
+struct writer_struct {
+	writer_struct();
+	~writer_struct();
+	void add(writerFile_struct* file, vector<char>& data, int close);
+	void wait(writerFile_struct* file);
+	void sub_run();
+
+	mutex lock;
+	condition_variable queued;		// Signalled when a job is added (or the program ends)
+	condition_variable written;		// Signalled when a job is done
+	deque<writerJob_struct> jobs;
+	long long queuedBytes;
+	int stop;
+	thread worker;
+};
+
+static writer_struct writer;
+
+// Writes a block to the file, compressing it first for gzip files. finish ends the gzip stream.
+static void sub_writeBlock(writerFile_struct* file, vector<char>& data, int finish) {
+#ifdef REGCAP_ZLIB
+	if(file->level > 0) {
+		file->stream.next_in = data.empty() ? Z_NULL : (Bytef*) &data[0];
+		file->stream.avail_in = (uInt) data.size();
+		do {
+			file->stream.next_out = (Bytef*) &file->compressed[0];
+			file->stream.avail_out = (uInt) file->compressed.size();
+			if(deflate(&file->stream, finish ? Z_FINISH : Z_NO_FLUSH) == Z_STREAM_ERROR)
+				file->error = 1;
+			size_t bytes = file->compressed.size() - file->stream.avail_out;
+			if(bytes > 0 && fwrite(&file->compressed[0], 1, bytes, file->handle) != bytes)
+				file->error = 1;
+		} while(file->stream.avail_out == 0);
+		if(finish)
+			deflateEnd(&file->stream);
+		return;
+	}
+#endif
+	if(!data.empty() && fwrite(&data[0], 1, data.size(), file->handle) != data.size())
+		file->error = 1;
+}
+
+writer_struct::writer_struct() {
+	queuedBytes = 0;
+	stop = 0;
+}
+
+writer_struct::~writer_struct() {
+	if(worker.joinable()) {
+		{
+			lock_guard<mutex> guard(lock);
+			stop = 1;
+		}
+		queued.notify_one();
+		worker.join();
+	}
+}
+
+void writer_struct::add(writerFile_struct* file, vector<char>& data, int close) {
+	unique_lock<mutex> guard(lock);
+	if(!worker.joinable())
+		worker = thread(&writer_struct::sub_run, this);
+
+	// A slow disk holds the simulations back here rather than letting the queue take all the memory
+	while(queuedBytes > WRITER_QUEUE)
+		written.wait(guard);
+
+	jobs.push_back(writerJob_struct());
+	jobs.back().file = file;
+	jobs.back().data.swap(data);			// The caller gets an empty vector back; no copy of the text is made
+	jobs.back().close = close;
+	queuedBytes = queuedBytes + jobs.back().data.size();
+	guard.unlock();
+	queued.notify_one();
+}
+
+void writer_struct::wait(writerFile_struct* file) {
+	unique_lock<mutex> guard(lock);
+	while(!file->closed)
+		written.wait(guard);
+}
+
+void writer_struct::sub_run() {
+	unique_lock<mutex> guard(lock);
+	while(true) {
+		while(jobs.empty() && !stop)
+			queued.wait(guard);
+		if(jobs.empty())
+			return;
+
+		writerJob_struct job;
+		job.file = jobs.front().file;
+		job.data.swap(jobs.front().data);
+		job.close = jobs.front().close;
+		jobs.pop_front();
+		guard.unlock();
+
+		sub_writeBlock(job.file, job.data, job.close);
+		if(job.close && fclose(job.file->handle) != 0)
+			job.file->error = 1;
+
+		guard.lock();
+		queuedBytes = queuedBytes - job.data.size();
+		if(job.close)
+			job.file->closed = 1;
+		written.notify_all();
+	}
+}
+
+writerBuffer_struct::writerBuffer_struct() {
+	file = 0;
+	copy = 0;
+	copyMark = 0;
+	setp(0, 0);
+}
+
+writerBuffer_struct::writerBuffer_struct(const writerBuffer_struct& other) : streambuf() {
+	file = 0;
+	copy = 0;
+	copyMark = 0;
+	setp(0, 0);
+}
+
+writerBuffer_struct::~writerBuffer_struct() {
+	close();
+}
+
+// Returns 1 if the file cannot be opened (or compression was asked for without REGCAP_ZLIB)
+int writerBuffer_struct::open(string fileName, int level) {
+	close();
+	if(level > 0 && !COMPRESSION_AVAILABLE)
+		return 1;
+
+	// Plain files are opened in text mode so they come out exactly as the ofstream wrote them
+	FILE* handle = fopen(fileName.c_str(), level > 0 ? "wb" : "w");
+	if(!handle)
+		return 1;
+
+	file = new writerFile_struct();
+	file->handle = handle;
+	file->level = level;
+	file->error = 0;
+	file->closed = 0;
+#ifdef REGCAP_ZLIB
+	if(level > 0) {
+		file->stream.zalloc = Z_NULL;
+		file->stream.zfree = Z_NULL;
+		file->stream.opaque = Z_NULL;
+		if(deflateInit2(&file->stream, level > 9 ? 9 : level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)	// 15 + 16 = gzip wrapper
+			file->error = 1;
+		file->compressed.resize(WRITER_BLOCK);
+	}
+#endif
+
+	block.resize(WRITER_BLOCK);
+	setp(&block[0], &block[0] + block.size());
+	return 0;
+}
+
+// Hands the rest of the text to the writer thread and waits for the file to be closed. Returns 1 if a write failed.
+int writerBuffer_struct::close() {
+	if(!file)
+		return 0;
+
+	if(copy)
+		sub_copy();
+	block.resize(pptr() - pbase());
+	writer.add(file, block, 1);
+	writer.wait(file);
+
+	int error = file->error;
+	delete file;
+	file = 0;
+	block.clear();
+	copy = 0;
+	copyMark = 0;
+	setp(0, 0);
+	return error;
+}
+
+// Exchanges the open files (and the text waiting in their blocks) of two buffers
+void writerBuffer_struct::swap(writerBuffer_struct& other) {
+	long int used = (long int) (pptr() - pbase());
+	long int otherUsed = (long int) (other.pptr() - other.pbase());
+	long int copied = (long int) (copyMark - pbase());
+	long int otherCopied = (long int) (other.copyMark - other.pbase());
+
+	std::swap(file, other.file);
+	std::swap(copy, other.copy);
+	block.swap(other.block);
+
+	setp(0, 0);
+	copyMark = 0;
+	if(file) {
+		setp(&block[0], &block[0] + block.size());
+		pbump(otherUsed);
+		copyMark = pbase() + otherCopied;
+	}
+	other.setp(0, 0);
+	other.copyMark = 0;
+	if(other.file) {
+		other.setp(&other.block[0], &other.block[0] + other.block.size());
+		other.pbump(used);
+		other.copyMark = other.pbase() + copied;
+	}
+}
+
+int writerBuffer_struct::overflow(int c) {
+	if(!file)
+		return traits_type::eof();
+
+	sub_send();
+	if(c != traits_type::eof()) {
+		*pptr() = (char) c;
+		pbump(1);
+	}
+	return traits_type::not_eof(c);
+}
+
+// endl and flush land here; the text stays in the block until it is full
+int writerBuffer_struct::sync() {
+	return 0;
+}
+
+void writerBuffer_struct::sub_send() {
+	if(copy)
+		sub_copy();
+	block.resize(pptr() - pbase());
+	writer.add(file, block, 0);
+	block.resize(WRITER_BLOCK);
+	setp(&block[0], &block[0] + block.size());
+	copyMark = pbase();
+}
+
+void writerBuffer_struct::keepCopy(vector<char>* copy) {
+	this->copy = copy;
+	copyMark = pbase();
+}
+
+void writerBuffer_struct::sub_copy() {
+	copy->insert(copy->end(), copyMark, pptr());
+	copyMark = pptr();
+}
+
+outputStream_struct::outputStream_struct() : ostream(&buffer) {
+}
+
+outputStream_struct::outputStream_struct(const outputStream_struct& other) : ostream(&buffer) {
+}
+
+void outputStream_struct::open(string fileName, int level) {
+	this->fileName = level > 0 ? fileName + ".gz" : fileName;
+	clear();
+	if(buffer.open(this->fileName, level))
+		setstate(ios::failbit);
+}
+
+int outputStream_struct::close() {
+	if(buffer.close()) {
+		setstate(ios::failbit);
+		return 1;
+	}
+	return 0;
+}
+
+int outputStream_struct::is_open() {
+	return buffer.file != 0;
+}
+
+void outputStream_struct::swap(outputStream_struct& other) {
+	buffer.swap(other.buffer);
+	fileName.swap(other.fileName);
+	iostate state = rdstate();
+	clear(other.rdstate());
+	other.clear(state);
+}
+
+// Everything written from now on is also added to copy, including text still waiting in the block (so
+// straight after open() the copy gets the whole file). updateCopy() brings copy up to what has been written.
+void outputStream_struct::keepCopy(vector<char>* copy) {
+	buffer.keepCopy(copy);
+}
+
+void outputStream_struct::updateCopy() {
+	if(buffer.copy && buffer.file)
+		buffer.sub_copy();
+}
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef writer_h
+#define writer_h
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Output streams for the per-minute files. Text goes into large blocks in memory and one background thread,
+// shared by every simulation, does the file writes (and gzip compression), so the simulation threads never
+// wait on the disk. endl does not flush: the file is complete once close() returns.
+//
+// Compression levels 1-9 write a gzip stream and add .gz to the file name; zcat, R's read.table and
+// pandas.read_csv read these directly. Build with REGCAP_ZLIB defined and zlib linked to enable them
+// (zlib.props does both for rc++ and regcap once zlib is in place); without it only level 0 (plain text) is available.
+
+#ifdef REGCAP_ZLIB
+const int COMPRESSION_AVAILABLE = 1;
+#else
+const int COMPRESSION_AVAILABLE = 0;
+#endif
+
+const int WRITER_BLOCK = 1 << 18;			// Bytes collected before a block is handed to the writer thread
+const long long WRITER_QUEUE = 1 << 26;		// Bytes waiting to be written before the simulation threads wait
+
+struct writerFile_struct;
+
+struct writerBuffer_struct : public streambuf {
+	writerBuffer_struct();
+	writerBuffer_struct(const writerBuffer_struct& other);
+	~writerBuffer_struct();
+	int open(string fileName, int level);
+	int close();
+	void swap(writerBuffer_struct& other);
+	void keepCopy(vector<char>* copy);
+	int overflow(int c);
+	int sync();
+
+	void sub_send();
+	void sub_copy();
+
+	writerFile_struct* file;
+	vector<char> block;
+	vector<char>* copy;			// Also keeps everything written here, or 0 (see prefix.h)
+	char* copyMark;				// Start of the text in block not yet added to copy
+};
+
+// Drop-in for the ofstream of a per-minute file. A copy starts closed, so that a simulation can be copied
+// (simulation_struct::f_fork) without two copies writing one file.
+struct outputStream_struct : public ostream {
+	outputStream_struct();
+	outputStream_struct(const outputStream_struct& other);
+	void open(string fileName, int level);
+	int close();				// Returns 1 if any of the file could not be written or compressed
+	int is_open();
+	void swap(outputStream_struct& other);
+	void keepCopy(vector<char>* copy);
+	void updateCopy();
+
+	writerBuffer_struct buffer;
+	string fileName;			// Name actually opened (with .gz when compressed)
+};
+
+#endif